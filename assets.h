@@ -0,0 +1,337 @@
+#ifndef ASSETS_H_
+#define ASSETS_H_
+
+// Asset loading off the main thread. Worker threads read and decode files into
+// CPU memory, the main thread moves the pixels to the GPU a few rows at a time
+// from assets_upload(), so no frame waits on a whole file or texture. Until an
+// asset is ready the caller draws with a fallback.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <raylib.h>
+
+#include "./comp.h"
+
+#define ASSETS_CAP 32
+#define ASSETS_WORKERS_CAP 4
+
+typedef enum {
+    ASSET_FONT = 0,
+    ASSET_TEXTURE,
+} Asset_Kind;
+
+typedef enum {
+    ASSET_QUEUED = 0, // Waiting for a worker
+    ASSET_DECODING,   // A worker is on it
+    ASSET_DECODED,    // Pixels are in CPU memory, owned by the main thread from here on
+    ASSET_UPLOADING,  // Some of the rows are on the GPU
+    ASSET_READY,
+    ASSET_FAILED,
+} Asset_State;
+
+typedef struct {
+    Asset_Kind kind;
+    Cstr path;
+    int font_size;
+    int filter;
+    Asset_State state;
+    // What gets uploaded, the font atlas for fonts
+    Image image;
+    int rows_uploaded;
+    Texture2D texture;
+    Font font;
+} Asset;
+
+typedef size_t Asset_Id;
+
+typedef struct {
+    Asset items[ASSETS_CAP];
+    size_t count;
+    // First asset that no worker took yet
+    size_t next_queued;
+    pthread_t workers[ASSETS_WORKERS_CAP];
+    size_t workers_count;
+    // Guards `count`, `next_queued`, `stopping` and the state of every asset
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    bool stopping;
+} Assets;
+
+bool assets_start(Assets *assets, size_t workers_count);
+// `path` must outlive the loader, `filter` is a raylib TextureFilter
+Asset_Id assets_load_font(Assets *assets, Cstr path, int font_size, int filter);
+Asset_Id assets_load_texture(Assets *assets, Cstr path, int filter);
+// Main thread only. Uploads decoded assets in order, about `budget_bytes` of
+// pixels per call, always at least one row so every asset gets there
+void assets_upload(Assets *assets, size_t budget_bytes);
+// Main thread only. Blocks until every queued asset is ready or failed
+void assets_finish(Assets *assets);
+Asset_State assets_state(Assets *assets, Asset_Id id);
+// The asset if it is ready, `fallback` otherwise
+Font assets_font(Assets *assets, Asset_Id id, Font fallback);
+Texture2D assets_texture(Assets *assets, Asset_Id id, Texture2D fallback);
+// Waits for the workers and unloads every asset, before CloseWindow()
+void assets_stop(Assets *assets);
+
+#endif // ASSETS_H_
+
+#ifdef ASSETS_IMPLEMENTATION
+#undef ASSETS_IMPLEMENTATION
+
+#include <rlgl.h>
+
+// Same glyphs and padding LoadFont() uses
+#define ASSETS_FONT_GLYPHS_COUNT 95
+#define ASSETS_FONT_GLYPH_PADDING 4
+
+static bool assets_decode_font(Asset *asset) {
+    int data_size = 0;
+    unsigned char *data = LoadFileData(asset->path, &data_size);
+    if (data == NULL) return false;
+
+    Font font = {0};
+    font.baseSize = asset->font_size;
+    font.glyphCount = ASSETS_FONT_GLYPHS_COUNT;
+    font.glyphs = LoadFontData(data, data_size, font.baseSize, NULL, font.glyphCount, FONT_DEFAULT);
+    UnloadFileData(data);
+    if (font.glyphs == NULL) return false;
+
+    font.glyphPadding = ASSETS_FONT_GLYPH_PADDING;
+    Image atlas = GenImageFontAtlas(font.glyphs, &font.recs, font.glyphCount, font.baseSize, font.glyphPadding, 0);
+
+    // Glyph images come from the atlas so they have alpha, like LoadFont() does it
+    for (int i = 0; i < font.glyphCount; ++i) {
+        UnloadImage(font.glyphs[i].image);
+        font.glyphs[i].image = ImageFromImage(atlas, font.recs[i]);
+    }
+
+    asset->font = font;
+    asset->image = atlas;
+    return true;
+}
+
+static bool assets_decode(Asset *asset) {
+    switch (asset->kind) {
+    case ASSET_FONT:
+        return assets_decode_font(asset);
+    case ASSET_TEXTURE:
+        asset->image = LoadImage(asset->path);
+        return asset->image.data != NULL;
+    }
+    return false;
+}
+
+static void *assets_worker(void *arg) {
+    Assets *assets = arg;
+
+    pthread_mutex_lock(&assets->mutex);
+    for (;;) {
+        while (!assets->stopping && assets->next_queued >= assets->count) {
+            pthread_cond_wait(&assets->cond, &assets->mutex);
+        }
+        if (assets->stopping) break;
+
+        Asset *asset = &assets->items[assets->next_queued++];
+        asset->state = ASSET_DECODING;
+        pthread_mutex_unlock(&assets->mutex);
+
+        trace_begin("asset decode");
+        bool decoded = assets_decode(asset);
+        trace_end("asset decode");
+        if (!decoded) {
+            fprintf(stderr, "Error: could not load asset '%s'\n", asset->path);
+        }
+
+        pthread_mutex_lock(&assets->mutex);
+        asset->state = decoded ? ASSET_DECODED : ASSET_FAILED;
+        pthread_cond_broadcast(&assets->cond);
+    }
+    pthread_mutex_unlock(&assets->mutex);
+    return NULL;
+}
+
+bool assets_start(Assets *assets, size_t workers_count) {
+    assert(workers_count > 0 && workers_count <= ASSETS_WORKERS_CAP);
+    *assets = (Assets) {0};
+    pthread_mutex_init(&assets->mutex, NULL);
+    pthread_cond_init(&assets->cond, NULL);
+
+    for (size_t i = 0; i < workers_count; ++i) {
+        if (pthread_create(&assets->workers[i], NULL, assets_worker, assets) != 0) {
+            fprintf(stderr, "Error: could not start asset loader thread\n");
+            assets_stop(assets);
+            return false;
+        }
+        assets->workers_count += 1;
+    }
+    return true;
+}
+
+static Asset_Id assets_queue(Assets *assets, Asset asset) {
+    pthread_mutex_lock(&assets->mutex);
+    assert(assets->count < ASSETS_CAP && "Error: too many assets");
+    Asset_Id id = assets->count;
+    assets->items[id] = asset;
+    assets->count += 1;
+    pthread_cond_signal(&assets->cond);
+    pthread_mutex_unlock(&assets->mutex);
+    return id;
+}
+
+Asset_Id assets_load_font(Assets *assets, Cstr path, int font_size, int filter) {
+    return assets_queue(assets, (Asset) {
+        .kind = ASSET_FONT,
+        .path = path,
+        .font_size = font_size,
+        .filter = filter,
+    });
+}
+
+Asset_Id assets_load_texture(Assets *assets, Cstr path, int filter) {
+    return assets_queue(assets, (Asset) {
+        .kind = ASSET_TEXTURE,
+        .path = path,
+        .filter = filter,
+    });
+}
+
+// Uploads rows of `asset` within `*budget`, returns the state it ends up in
+static Asset_State assets_upload_rows(Asset *asset, size_t *budget) {
+    Image *image = &asset->image;
+    if (asset->texture.id == 0) {
+        // Storage only, the rows follow in slices
+        asset->texture.id = rlLoadTexture(NULL, image->width, image->height, image->format, 1);
+        if (asset->texture.id == 0) {
+            fprintf(stderr, "Error: could not create texture for asset '%s'\n", asset->path);
+            return ASSET_FAILED;
+        }
+        asset->texture.width = image->width;
+        asset->texture.height = image->height;
+        asset->texture.mipmaps = 1;
+        asset->texture.format = image->format;
+    }
+
+    size_t row_size = (size_t) GetPixelDataSize(image->width, 1, image->format);
+    int rows = (int) (*budget / row_size);
+    if (rows < 1) rows = 1;
+    if (rows > image->height - asset->rows_uploaded) rows = image->height - asset->rows_uploaded;
+
+    Rectangle rec = { 0, (float) asset->rows_uploaded, (float) image->width, (float) rows };
+    UpdateTextureRec(asset->texture, rec, (unsigned char *) image->data + asset->rows_uploaded * row_size);
+    asset->rows_uploaded += rows;
+
+    size_t used = (size_t) rows * row_size;
+    *budget = used < *budget ? *budget - used : 0;
+
+    if (asset->rows_uploaded < image->height) return ASSET_UPLOADING;
+
+    SetTextureFilter(asset->texture, asset->filter);
+    UnloadImage(*image);
+    *image = (Image) {0};
+    if (asset->kind == ASSET_FONT) {
+        asset->font.texture = asset->texture;
+    }
+    return ASSET_READY;
+}
+
+void assets_upload(Assets *assets, size_t budget_bytes) {
+    pthread_mutex_lock(&assets->mutex);
+    size_t count = assets->count;
+    pthread_mutex_unlock(&assets->mutex);
+
+    size_t budget = budget_bytes;
+    for (size_t i = 0; i < count && budget > 0; ++i) {
+        Asset *asset = &assets->items[i];
+
+        pthread_mutex_lock(&assets->mutex);
+        Asset_State state = asset->state;
+        pthread_mutex_unlock(&assets->mutex);
+        if (state != ASSET_DECODED && state != ASSET_UPLOADING) continue;
+
+        trace_begin("asset upload");
+        state = assets_upload_rows(asset, &budget);
+        trace_end("asset upload");
+
+        pthread_mutex_lock(&assets->mutex);
+        asset->state = state;
+        pthread_mutex_unlock(&assets->mutex);
+    }
+}
+
+void assets_finish(Assets *assets) {
+    for (;;) {
+        pthread_mutex_lock(&assets->mutex);
+        bool pending = false;
+        bool decoding = false;
+        for (size_t i = 0; i < assets->count; ++i) {
+            Asset_State state = assets->items[i].state;
+            if (state != ASSET_READY && state != ASSET_FAILED) pending = true;
+            if (state == ASSET_QUEUED || state == ASSET_DECODING) decoding = true;
+        }
+        // Nothing to upload until a worker is done with something
+        if (decoding && pending) {
+            bool uploadable = false;
+            for (size_t i = 0; i < assets->count; ++i) {
+                Asset_State state = assets->items[i].state;
+                if (state == ASSET_DECODED || state == ASSET_UPLOADING) uploadable = true;
+            }
+            if (!uploadable) pthread_cond_wait(&assets->cond, &assets->mutex);
+        }
+        pthread_mutex_unlock(&assets->mutex);
+
+        if (!pending) return;
+        assets_upload(assets, SIZE_MAX);
+    }
+}
+
+Asset_State assets_state(Assets *assets, Asset_Id id) {
+    pthread_mutex_lock(&assets->mutex);
+    assert(id < assets->count);
+    Asset_State state = assets->items[id].state;
+    pthread_mutex_unlock(&assets->mutex);
+    return state;
+}
+
+Font assets_font(Assets *assets, Asset_Id id, Font fallback) {
+    if (assets_state(assets, id) != ASSET_READY) return fallback;
+    assert(assets->items[id].kind == ASSET_FONT);
+    return assets->items[id].font;
+}
+
+Texture2D assets_texture(Assets *assets, Asset_Id id, Texture2D fallback) {
+    if (assets_state(assets, id) != ASSET_READY) return fallback;
+    return assets->items[id].texture;
+}
+
+void assets_stop(Assets *assets) {
+    pthread_mutex_lock(&assets->mutex);
+    assets->stopping = true;
+    pthread_cond_broadcast(&assets->cond);
+    pthread_mutex_unlock(&assets->mutex);
+
+    for (size_t i = 0; i < assets->workers_count; ++i) {
+        pthread_join(assets->workers[i], NULL);
+    }
+
+    // No workers left, nothing else touches the assets
+    for (size_t i = 0; i < assets->count; ++i) {
+        Asset *asset = &assets->items[i];
+        if (asset->state == ASSET_QUEUED) continue;
+
+        // Whatever got this far, a failed upload still has its pixels and glyphs
+        UnloadImage(asset->image);
+        if (asset->kind == ASSET_FONT) {
+            UnloadFontData(asset->font.glyphs, asset->font.glyphCount);
+            // raylib allocated these, with memory callbacks RL_FREE here would not match
+            MemFree(asset->font.recs);
+        }
+        if (asset->texture.id != 0) UnloadTexture(asset->texture);
+    }
+
+    pthread_cond_destroy(&assets->cond);
+    pthread_mutex_destroy(&assets->mutex);
+    *assets = (Assets) {0};
+}
+
+#endif // ASSETS_IMPLEMENTATION
@@ -0,0 +1,966 @@
+// Microbenchmarks for the hot paths of the game, `./comp bench` builds and runs them.
+//
+// Every benchmark is calibrated so a sample takes a few milliseconds, warmed
+// up, then sampled repeatedly. The median time per operation is reported with
+// a 95% confidence interval, and with --perf the median cycles and
+// instructions per operation from perf_event. Results can be written as JSON
+// and compared against a previous run with --baseline, a benchmark whose
+// interval lies entirely above the baseline's counts as a regression.
+
+// For syscall() and perf_event_open
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <raylib.h>
+#include <rlgl.h>
+
+#ifdef __linux__
+    #include <linux/perf_event.h>
+    #include <sys/syscall.h>
+    #include <sys/ioctl.h>
+#endif
+
+#define COMP_IMPLEMENTATION
+#include "./comp.h"
+
+#define SOMUI_IMPLEMENTATION
+#include "./somui.h"
+
+#define VOCAB_IMPLEMENTATION
+#include "./vocab.h"
+
+#define VOCAB_LENGTHS_IMPLEMENTATION
+#include "./vocab_lengths.h"
+
+#include "words.c"
+
+#define BENCH_SAMPLE_NS 5000000
+#define BENCH_WARMUP_SAMPLES 5
+#define BENCH_DEFAULT_SAMPLES 31
+#define BENCH_MAX_SAMPLES 1024
+#define BENCH_RESULTS_CAP 64
+
+typedef struct {
+    Cstr name;
+    void (*run)(size_t iters);
+    bool gfx;
+} Bench;
+
+typedef struct {
+    char name[64];
+    size_t samples;
+    double median_ns;
+    double ci_low_ns;
+    double ci_high_ns;
+    double cycles;
+    double instructions;
+} Bench_Result;
+
+// Results of the benchmarks end up here so the compiler can't throw the work away
+static volatile size_t bench_sink = 0;
+
+static Hash_Set_Cstr bench_dict = {0};
+// The same words by key, what vocab5_submit() checks guesses against
+static Vocab_Word_Set bench_words = {0};
+static Vocab_Dict bench_vocab_dict = {0};
+static Vocab_Columns bench_columns = {0};
+static Vocab_Prefix bench_prefix = {0};
+static Vocab_Anagrams bench_anagrams = {0};
+// Seven letter racks, a word and two more letters like puzzle.c makes
+static Vocab_Letters bench_racks[64] = {0};
+// A made up dictionary 100 times the size of the real one
+#define BENCH_BIG_WORDS_COUNT (100*5757)
+static Vocab_Columns bench_columns_big = {0};
+// What the helper panel asks after one or two rows of a game
+static Vocab_Pattern bench_patterns[64] = {0};
+static Cstr bench_guesses[1024] = {0};
+// Same guesses, fixed width
+static char bench_guesses_fixed[1024][VOCAB_WORD_LENGTH] = {0};
+static size_t bench_guesses_count = 0;
+static char bench_invalid[512][VOCAB_WORD_LENGTH + 1] = {0};
+static UI_Stack bench_ui = {0};
+static Font bench_font = {0};
+
+//------------------------------------------------------------------------------
+// Benchmarks
+//------------------------------------------------------------------------------
+
+static void bench_hash_set_contains(size_t iters) {
+    size_t found = 0;
+    for (size_t i = 0; i < iters; ++i) {
+        found += hash_set_cstr_contains(&bench_dict, bench_guesses[i % bench_guesses_count]);
+    }
+    bench_sink += found;
+}
+
+static void bench_dict_contains(size_t iters) {
+    size_t found = 0;
+    for (size_t i = 0; i < iters; ++i) {
+        found += vocab_dict_contains(&bench_vocab_dict, bench_guesses_fixed[i % bench_guesses_count]);
+    }
+    bench_sink += found;
+}
+
+// One operation is one guess, checked a thousand at a time
+static void bench_dict_contains_batch(size_t iters) {
+    static uint64_t valid[ARRAY_LEN(bench_guesses_fixed)/64];
+    size_t found = 0;
+    for (size_t i = 0; i < iters; i += bench_guesses_count) {
+        size_t count = iters - i < bench_guesses_count ? iters - i : bench_guesses_count;
+        vocab_dict_contains_batch(&bench_vocab_dict, (const char (*)[VOCAB_WORD_LENGTH]) bench_guesses_fixed, count, valid);
+        found += valid[0] & 1;
+    }
+    bench_sink += found;
+}
+
+// Three suggestions for a typo, like the game does for a rejected guess
+static void bench_columns_nearest(size_t iters) {
+    size_t nearest[3];
+    size_t found = 0;
+    for (size_t i = 0; i < iters; ++i) {
+        found += vocab_columns_nearest(&bench_columns, bench_invalid[i % ARRAY_LEN(bench_invalid)], 2, nearest, 3);
+    }
+    bench_sink += found;
+}
+
+static void bench_columns_nearest_big(size_t iters) {
+    size_t nearest[3];
+    size_t found = 0;
+    for (size_t i = 0; i < iters; ++i) {
+        found += vocab_columns_nearest(&bench_columns_big, bench_invalid[i % ARRAY_LEN(bench_invalid)], 2, nearest, 3);
+    }
+    bench_sink += found;
+}
+
+static void bench_columns_match(size_t iters) {
+    size_t matches[8];
+    size_t total = 0;
+    for (size_t i = 0; i < iters; ++i) {
+        total += vocab_columns_match(&bench_columns, &bench_patterns[i % ARRAY_LEN(bench_patterns)], matches, ARRAY_LEN(matches));
+    }
+    bench_sink += total;
+}
+
+static void bench_columns_match_big(size_t iters) {
+    size_t matches[8];
+    size_t total = 0;
+    for (size_t i = 0; i < iters; ++i) {
+        total += vocab_columns_match(&bench_columns_big, &bench_patterns[i % ARRAY_LEN(bench_patterns)], matches, ARRAY_LEN(matches));
+    }
+    bench_sink += total;
+}
+
+static void bench_anagrams_find(size_t iters) {
+    size_t total = 0;
+    for (size_t i = 0; i < iters; ++i) {
+        Vocab_Prefix_Range range = vocab_anagrams_find(&bench_anagrams, bench_guesses[i % bench_guesses_count]);
+        total += range.end - range.begin;
+    }
+    bench_sink += total;
+}
+
+static void bench_anagrams_within(size_t iters) {
+    size_t matches[8];
+    size_t total = 0;
+    for (size_t i = 0; i < iters; ++i) {
+        total += vocab_anagrams_within(&bench_anagrams, bench_racks[i % ARRAY_LEN(bench_racks)], matches, ARRAY_LEN(matches));
+    }
+    bench_sink += total;
+}
+
+// Prefixes of 1 to 5 letters of words and typos, like typing a row does
+static void bench_prefix_find(size_t iters) {
+    size_t total = 0;
+    for (size_t i = 0; i < iters; ++i) {
+        Vocab_Prefix_Range range = vocab_prefix_find(&bench_prefix, bench_guesses_fixed[i % bench_guesses_count], 1 + i % VOCAB_WORD_LENGTH);
+        total += range.end - range.begin;
+    }
+    bench_sink += total;
+}
+
+// Vocab_Dict checks the guesses of the server and of --boards in place of the
+// hash set, so it has to say what the hash set says, on the bench guesses and
+// on real words with some letters uppercased, which the hash set never accepts
+static bool bench_check_dict(void) {
+    static char probes[4096][VOCAB_WORD_LENGTH];
+    static uint64_t valid[ARRAY_LEN(probes)/64];
+    size_t count = 0;
+    for (size_t i = 0; i < bench_guesses_count; ++i) {
+        memcpy(probes[count++], bench_guesses_fixed[i], VOCAB_WORD_LENGTH);
+    }
+    while (count < ARRAY_LEN(probes)) {
+        char *probe = probes[count];
+        memcpy(probe, words[(count * 13) % words_count], VOCAB_WORD_LENGTH);
+        // One letter, or every letter from there on for a third of them
+        size_t first = count % VOCAB_WORD_LENGTH;
+        for (size_t j = first; j < VOCAB_WORD_LENGTH && (j == first || count % 3 == 0); ++j) {
+            probe[j] = (char) (probe[j] - 'a' + 'A');
+        }
+        count += 1;
+    }
+
+    vocab_dict_contains_batch(&bench_vocab_dict, (const char (*)[VOCAB_WORD_LENGTH]) probes, count, valid);
+    for (size_t i = 0; i < count; ++i) {
+        char word[VOCAB_WORD_LENGTH + 1] = {0};
+        memcpy(word, probes[i], VOCAB_WORD_LENGTH);
+        bool expected = hash_set_cstr_contains(&bench_dict, word);
+        bool batched = (valid[i / 64] >> (i % 64)) & 1;
+        if (batched != expected || vocab_dict_contains(&bench_vocab_dict, probes[i]) != expected) {
+            fprintf(stderr, "Error: Vocab_Dict and the hash set disagree on '%s'\n", word);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void bench_score(size_t iters) {
+    Vocab_Color colors[VOCAB_WORD_LENGTH];
+    size_t greens = 0;
+    for (size_t i = 0; i < iters; ++i) {
+        vocab5_score(words[i % words_count], words[(i * 7919) % words_count], colors);
+        greens += colors[0] == VOCAB_GREEN;
+    }
+    bench_sink += greens;
+}
+
+// The same words with the code for them picked by the length, like a game does
+static void bench_score_length(size_t iters) {
+    Vocab_Color colors[VOCAB_WORD_LENGTH];
+    size_t greens = 0;
+    for (size_t i = 0; i < iters; ++i) {
+        vocab_score_length(VOCAB_WORD_LENGTH, words[i % words_count], words[(i * 7919) % words_count], colors);
+        greens += colors[0] == VOCAB_GREEN;
+    }
+    bench_sink += greens;
+}
+
+// One operation is a guess against every board of a full multi-board game
+static void bench_score_many(size_t iters) {
+    char answers[VOCAB_WORD_LENGTH][VOCAB_BOARDS_CAP];
+    for (size_t b = 0; b < VOCAB_BOARDS_CAP; ++b) {
+        for (size_t j = 0; j < VOCAB_WORD_LENGTH; ++j) answers[j][b] = words[b * 89][j];
+    }
+    Vocab_Color colors[VOCAB_BOARDS_CAP][VOCAB_WORD_LENGTH];
+    size_t greens = 0;
+    for (size_t i = 0; i < iters; ++i) {
+        vocab_score_many((const char (*)[VOCAB_BOARDS_CAP]) answers, VOCAB_BOARDS_CAP, words[(i * 7919) % words_count], colors);
+        greens += colors[i % VOCAB_BOARDS_CAP][0] == VOCAB_GREEN;
+    }
+    bench_sink += greens;
+}
+
+// Same work as bench_score_many() a board at a time
+static void bench_score_boards_one_by_one(size_t iters) {
+    Vocab_Color colors[VOCAB_BOARDS_CAP][VOCAB_WORD_LENGTH];
+    size_t greens = 0;
+    for (size_t i = 0; i < iters; ++i) {
+        Cstr guess = words[(i * 7919) % words_count];
+        for (size_t b = 0; b < VOCAB_BOARDS_CAP; ++b) vocab5_score(words[b * 89], guess, colors[b]);
+        greens += colors[i % VOCAB_BOARDS_CAP][0] == VOCAB_GREEN;
+    }
+    bench_sink += greens;
+}
+
+// One operation is a pass over the whole dictionary
+static void bench_candidate_filter(size_t iters) {
+    Vocab_Color colors[VOCAB_WORD_LENGTH];
+    size_t matches = 0;
+    for (size_t i = 0; i < iters; ++i) {
+        Cstr guess = words[i % words_count];
+        vocab5_score(words[(i * 7919) % words_count], guess, colors);
+        for (size_t j = 0; j < words_count; ++j) {
+            matches += vocab_candidate_matches(words[j], guess, colors);
+        }
+    }
+    bench_sink += matches;
+}
+
+// One operation types a guess and submits it, a fresh game every six guesses
+static void bench_submit(size_t iters) {
+    Vocab5 vocab = {0};
+    size_t attempts = 0;
+    for (size_t i = 0; i < iters; ++i) {
+        if (i % VOCAB_ATTEMPTS_COUNT == 0) {
+            memset(&vocab, 0, sizeof(vocab));
+            vocab.word = words[i % words_count];
+        }
+        Cstr guess = words[(i * 7919) % words_count];
+        for (size_t j = 0; j < VOCAB_WORD_LENGTH; ++j) vocab5_type_letter(&vocab, guess[j]);
+        vocab5_submit(&vocab, &bench_words);
+        attempts += vocab.current_attempt;
+    }
+    bench_sink += attempts;
+}
+
+static void bench_packed_submit(size_t iters) {
+    Vocab_Packed packed = {0};
+    size_t attempts = 0;
+    for (size_t i = 0; i < iters; ++i) {
+        if (i % VOCAB_ATTEMPTS_COUNT == 0) {
+            packed = vocab_packed_new(i % words_count);
+        }
+        Cstr guess = words[(i * 7919) % words_count];
+        for (size_t j = 0; j < VOCAB_WORD_LENGTH; ++j) vocab_packed_type_letter(&packed, guess[j]);
+        vocab_packed_submit(&packed, (const Cstr *) words, &bench_vocab_dict);
+        attempts += vocab_packed_attempt(&packed);
+    }
+    bench_sink += attempts;
+}
+
+// One operation is a round trip of a game in the middle of its third row
+static void bench_pack_unpack(size_t iters) {
+    Vocab5 vocab = {0};
+    vocab.word = words[0];
+    for (size_t i = 0; i < 2; ++i) {
+        for (size_t j = 0; j < VOCAB_WORD_LENGTH; ++j) vocab5_type_letter(&vocab, words[i + 1][j]);
+        vocab5_submit(&vocab, &bench_words);
+    }
+    vocab5_type_letter(&vocab, 'a');
+
+    size_t sum = 0;
+    for (size_t i = 0; i < iters; ++i) {
+        Vocab_Packed packed = vocab_pack(&vocab, i % words_count);
+        vocab = vocab_unpack(&packed, (const Cstr *) words);
+        sum += vocab.cursor;
+    }
+    bench_sink += sum;
+}
+
+// Same layout as the game grid, one operation is the whole grid
+static void bench_ui_layout(size_t iters) {
+    UI_Rect rect = { 390, 60, 500, 600 };
+    int sum = 0;
+    for (size_t n = 0; n < iters; ++n) {
+        ui_layout_begin(&bench_ui, rect, UI_VERT, ui_marginv(10), 10, VOCAB_ATTEMPTS_COUNT);
+        for (size_t i = 0; i < VOCAB_ATTEMPTS_COUNT; ++i) {
+            UI_Rect row = ui_layout_rect(&bench_ui);
+            ui_layout_begin(&bench_ui, row, UI_HORI, ui_marginv(0), 10, VOCAB_WORD_LENGTH);
+            for (size_t j = 0; j < VOCAB_WORD_LENGTH; ++j) {
+                UI_Rect square = ui_layout_rect(&bench_ui);
+                sum += square.x + square.y;
+            }
+            ui_layout_end(&bench_ui);
+        }
+        ui_layout_end(&bench_ui);
+    }
+    bench_sink += (size_t) sum;
+}
+
+static void bench_measure_text(size_t iters) {
+    char text[2] = {0};
+    float width = 0.0f;
+    for (size_t i = 0; i < iters; ++i) {
+        text[0] = 'A' + i % 26;
+        width += MeasureTextEx(bench_font, text, 48.0f, 6).x;
+    }
+    bench_sink += (size_t) width;
+}
+
+// Queues the game grid and submits the batch, one operation is the whole grid
+static void bench_draw_batch(size_t iters) {
+    for (size_t n = 0; n < iters; ++n) {
+        for (int i = 0; i < VOCAB_ATTEMPTS_COUNT; ++i) {
+            for (int j = 0; j < VOCAB_WORD_LENGTH; ++j) {
+                int x = 390 + j * 100;
+                int y = 60 + i * 100;
+                char text[2] = { 'A' + (i * VOCAB_WORD_LENGTH + j) % 26, '\0' };
+                DrawRectangle(x, y, 90, 90, GRAY);
+                DrawRectangleLines(x, y, 90, 90, WHITE);
+                DrawTextPro(bench_font, text, (Vector2) { x + 45, y + 45 }, (Vector2) { 12, 24 }, 0.0f, 48.0f, 6, WHITE);
+            }
+        }
+        rlDrawRenderBatchActive();
+    }
+}
+
+static Bench benches[] = {
+    { "hash_set_cstr_contains", bench_hash_set_contains, false },
+    { "vocab_dict_contains", bench_dict_contains, false },
+    { "vocab_dict_contains_batch", bench_dict_contains_batch, false },
+    { "vocab_columns_nearest", bench_columns_nearest, false },
+    { "vocab_columns_nearest_100x", bench_columns_nearest_big, false },
+    { "vocab_columns_match", bench_columns_match, false },
+    { "vocab_columns_match_100x", bench_columns_match_big, false },
+    { "vocab_prefix_find", bench_prefix_find, false },
+    { "vocab_anagrams_find", bench_anagrams_find, false },
+    { "vocab_anagrams_within", bench_anagrams_within, false },
+    { "vocab5_score", bench_score, false },
+    { "vocab_score_length", bench_score_length, false },
+    { "vocab_score_many_64", bench_score_many, false },
+    { "vocab_score_64_boards", bench_score_boards_one_by_one, false },
+    { "vocab_candidate_filter", bench_candidate_filter, false },
+    { "vocab_submit", bench_submit, false },
+    { "vocab_packed_submit", bench_packed_submit, false },
+    { "vocab_pack_unpack", bench_pack_unpack, false },
+    { "ui_layout_grid", bench_ui_layout, false },
+    { "MeasureTextEx", bench_measure_text, true },
+    { "draw_batch_grid", bench_draw_batch, true },
+};
+
+//------------------------------------------------------------------------------
+// Self-test, the fast paths against a plain scan of the word list
+//------------------------------------------------------------------------------
+
+// Greens first, then yellows while the answer has letters left that are not green
+static void naive_score(const char *answer, const char *guess, Vocab_Color colors[VOCAB_WORD_LENGTH]) {
+    size_t left[26] = {0};
+    for (size_t j = 0; j < VOCAB_WORD_LENGTH; ++j) {
+        if (answer[j] != guess[j]) left[answer[j] - 'a'] += 1;
+    }
+    for (size_t j = 0; j < VOCAB_WORD_LENGTH; ++j) {
+        size_t c = (size_t) (guess[j] - 'a');
+        if (answer[j] == guess[j]) {
+            colors[j] = VOCAB_GREEN;
+        } else if (left[c] > 0) {
+            colors[j] = VOCAB_YELLOW;
+            left[c] -= 1;
+        } else {
+            colors[j] = VOCAB_GRAY;
+        }
+    }
+}
+
+// Every word and typo as a guess, against 1 to VOCAB_BOARDS_CAP boards
+static bool bench_check_score_many(void) {
+    char answers[VOCAB_WORD_LENGTH][VOCAB_BOARDS_CAP];
+    Cstr boards[VOCAB_BOARDS_CAP];
+    Vocab_Color colors[VOCAB_BOARDS_CAP][VOCAB_WORD_LENGTH];
+    Vocab_Color expected[VOCAB_WORD_LENGTH];
+    Vocab_Color single[VOCAB_WORD_LENGTH];
+    for (size_t i = 0; i < words_count + ARRAY_LEN(bench_invalid); ++i) {
+        Cstr guess = i < words_count ? words[i] : bench_invalid[i - words_count];
+        size_t count = 1 + i % VOCAB_BOARDS_CAP;
+        for (size_t b = 0; b < count; ++b) {
+            boards[b] = words[(i * 7 + b * 89) % words_count];
+            for (size_t j = 0; j < VOCAB_WORD_LENGTH; ++j) answers[j][b] = boards[b][j];
+        }
+        vocab_score_many((const char (*)[VOCAB_BOARDS_CAP]) answers, count, guess, colors);
+        for (size_t b = 0; b < count; ++b) {
+            naive_score(boards[b], guess, expected);
+            vocab5_score(boards[b], guess, single);
+            if (memcmp(colors[b], expected, sizeof(expected)) != 0 || memcmp(single, expected, sizeof(expected)) != 0) {
+                fprintf(stderr, "Error: scoring '%.*s' against '%s' on board %zu of %zu is wrong\n", VOCAB_WORD_LENGTH, guess, boards[b], b, count);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static size_t naive_distance(const char *a, const char *b) {
+    size_t distance = 0;
+    for (size_t j = 0; j < VOCAB_WORD_LENGTH; ++j) distance += a[j] != b[j];
+    return distance;
+}
+
+// Typos and words with every distance limit and number of suggestions. The
+// plain way takes every distance in turn and the words at it in list order
+static bool bench_check_nearest(void) {
+    size_t nearest[VOCAB_NEAREST_CAP];
+    size_t expected[VOCAB_NEAREST_CAP];
+    for (size_t i = 0; i < bench_guesses_count; ++i) {
+        Cstr word = bench_guesses[i];
+        size_t max_distance = i % (VOCAB_WORD_LENGTH + 1);
+        size_t k = 1 + i % VOCAB_NEAREST_CAP;
+        size_t found = vocab_columns_nearest(&bench_columns, word, max_distance, nearest, k);
+
+        size_t count = 0;
+        for (size_t distance = 0; distance <= max_distance && count < k; ++distance) {
+            for (size_t w = 0; w < words_count && count < k; ++w) {
+                if (naive_distance(words[w], word) == distance) expected[count++] = w;
+            }
+        }
+        if (found != count || memcmp(nearest, expected, count*sizeof(size_t)) != 0) {
+            fprintf(stderr, "Error: the %zu nearest words to '%s' within %zu are wrong\n", k, word, max_distance);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool naive_pattern_matches(const Vocab_Pattern *pattern, const char *word) {
+    uint32_t letters = 0;
+    for (size_t j = 0; j < VOCAB_WORD_LENGTH; ++j) {
+        uint32_t bit = 1u << (word[j] - 'a');
+        if (pattern->letters[j] != 0 && pattern->letters[j] != word[j]) return false;
+        if (pattern->not_at[j] & bit) return false;
+        letters |= bit;
+    }
+    return (letters & pattern->has) == pattern->has && (letters & pattern->lacks) == 0;
+}
+
+// The pattern of no rows, then what one to three rows of a game teach, every
+// word of the list has to match or not like the plain check says
+static bool bench_check_match(void) {
+    size_t matches[64];
+    for (size_t i = 0; i < 2048; ++i) {
+        Vocab_Pattern pattern = {0};
+        const char *answer = words[(i * 31) % words_count];
+        for (size_t row = 0; row < i % 4; ++row) {
+            const char *guess = bench_guesses[(i * 7 + row * 13) % bench_guesses_count];
+            Vocab_Color colors[VOCAB_WORD_LENGTH];
+            vocab5_score(answer, guess, colors);
+            vocab_pattern_learn(&pattern, guess, colors);
+        }
+        size_t total = vocab_columns_match(&bench_columns, &pattern, matches, ARRAY_LEN(matches));
+
+        size_t count = 0;
+        bool same = true;
+        for (size_t w = 0; w < words_count; ++w) {
+            if (!naive_pattern_matches(&pattern, words[w])) continue;
+            if (count < ARRAY_LEN(matches)) same = same && matches[count] == w;
+            count += 1;
+        }
+        if (total != count || !same) {
+            fprintf(stderr, "Error: the matches of pattern %zu with answer '%s' are wrong\n", i, answer);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Every prefix of the bench guesses, the empty one too. The range has to hold
+// as many words as start with it, all of them starting with it alphabetically
+static bool bench_check_prefix(void) {
+    for (size_t i = 0; i < bench_guesses_count; ++i) {
+        Cstr word = bench_guesses[i];
+        for (size_t length = 0; length <= VOCAB_WORD_LENGTH; ++length) {
+            Vocab_Prefix_Range range = vocab_prefix_find(&bench_prefix, word, length);
+            size_t count = 0;
+            for (size_t w = 0; w < words_count; ++w) {
+                count += strncmp(words[w], word, length) == 0;
+            }
+            bool same = range.end - range.begin == count;
+            for (size_t r = range.begin; same && r < range.end; ++r) {
+                Cstr completion = words[bench_prefix.order[r]];
+                same = strncmp(completion, word, length) == 0;
+                if (same && r > range.begin) {
+                    int order = strcmp(words[bench_prefix.order[r - 1]], completion);
+                    same = order < 0 || (order == 0 && bench_prefix.order[r - 1] < bench_prefix.order[r]);
+                }
+            }
+            if (!same) {
+                fprintf(stderr, "Error: the completions of '%.*s' are wrong\n", (int) length, word);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Whether `word` can be spelled from the letters of `rack`, none more times
+// than they are there. Same length both ways is an anagram
+static bool naive_spelled_from(const char *word, const char *rack, size_t rack_length) {
+    int counts[26] = {0};
+    for (size_t j = 0; j < rack_length; ++j) {
+        if (rack[j] >= 'a' && rack[j] <= 'z') counts[rack[j] - 'a'] += 1;
+    }
+    for (size_t j = 0; j < VOCAB_WORD_LENGTH; ++j) {
+        if (word[j] < 'a' || word[j] > 'z' || --counts[word[j] - 'a'] < 0) return false;
+    }
+    return true;
+}
+
+// The anagram group of every bench guess, then racks of a word and zero to
+// four more letters like puzzle.c makes, against the words spelled from them
+static bool bench_check_anagrams(void) {
+    for (size_t i = 0; i < bench_guesses_count; ++i) {
+        Cstr word = bench_guesses[i];
+        Vocab_Prefix_Range range = vocab_anagrams_find(&bench_anagrams, word);
+        size_t count = 0;
+        for (size_t w = 0; w < words_count; ++w) {
+            count += naive_spelled_from(words[w], word, VOCAB_WORD_LENGTH);
+        }
+        bool same = range.end - range.begin == count;
+        for (size_t r = range.begin; same && r < range.end; ++r) {
+            same = naive_spelled_from(words[bench_anagrams.order[r]], word, VOCAB_WORD_LENGTH);
+            for (size_t s = range.begin; same && s < r; ++s) same = bench_anagrams.order[s] != bench_anagrams.order[r];
+        }
+        if (!same) {
+            fprintf(stderr, "Error: the anagrams of '%s' are wrong\n", word);
+            return false;
+        }
+    }
+
+    size_t matches[64];
+    for (size_t i = 0; i < 2048; ++i) {
+        char rack[VOCAB_WORD_LENGTH + 4];
+        size_t length = VOCAB_WORD_LENGTH + i % 5;
+        memcpy(rack, words[(i * 17) % words_count], VOCAB_WORD_LENGTH);
+        for (size_t j = VOCAB_WORD_LENGTH; j < length; ++j) rack[j] = words[(i * 5 + j) % words_count][j % VOCAB_WORD_LENGTH];
+        size_t total = vocab_anagrams_within(&bench_anagrams, vocab_letters(rack, length), matches, ARRAY_LEN(matches));
+
+        size_t count = 0;
+        bool same = true;
+        for (size_t w = 0; w < words_count; ++w) {
+            if (!naive_spelled_from(words[w], rack, length)) continue;
+            if (count < ARRAY_LEN(matches)) same = same && matches[count] == w;
+            count += 1;
+        }
+        if (total != count || !same) {
+            fprintf(stderr, "Error: the words spelled from '%.*s' are wrong\n", (int) length, rack);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool self_test(void) {
+    bool ok = true;
+    ok = bench_check_score_many() && ok;
+    ok = bench_check_nearest() && ok;
+    ok = bench_check_match() && ok;
+    ok = bench_check_prefix() && ok;
+    ok = bench_check_anagrams() && ok;
+    fprintf(stderr, "[BENCH]: self test %s\n", ok ? "passed" : "FAILED");
+    return ok;
+}
+
+//------------------------------------------------------------------------------
+// perf_event counters, cycles and instructions of the calling thread
+//------------------------------------------------------------------------------
+
+static int perf_fd = -1;
+
+#ifdef __linux__
+static int perf_open(uint64_t config, int group) {
+    struct perf_event_attr attr = {0};
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.disabled = (group == -1);
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return (int) syscall(SYS_perf_event_open, &attr, 0, -1, group, 0);
+}
+#endif
+
+static bool perf_init(void) {
+#ifdef __linux__
+    perf_fd = perf_open(PERF_COUNT_HW_CPU_CYCLES, -1);
+    if (perf_fd < 0) {
+        fprintf(stderr, "Warning: perf_event_open failed: %s, counters disabled\n", strerror(errno));
+        return false;
+    }
+    if (perf_open(PERF_COUNT_HW_INSTRUCTIONS, perf_fd) < 0) {
+        fprintf(stderr, "Warning: perf_event_open failed: %s, counters disabled\n", strerror(errno));
+        close(perf_fd);
+        perf_fd = -1;
+        return false;
+    }
+    return true;
+#else
+    fprintf(stderr, "Warning: perf_event is only available on Linux\n");
+    return false;
+#endif
+}
+
+static void perf_start(void) {
+#ifdef __linux__
+    if (perf_fd < 0) return;
+    ioctl(perf_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(perf_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+static void perf_stop(uint64_t *cycles, uint64_t *instructions) {
+    *cycles = 0;
+    *instructions = 0;
+#ifdef __linux__
+    if (perf_fd < 0) return;
+    ioctl(perf_fd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    struct { uint64_t nr; uint64_t values[2]; } group = {0};
+    if (read(perf_fd, &group, sizeof(group)) == (ssize_t) sizeof(group) && group.nr == 2) {
+        *cycles = group.values[0];
+        *instructions = group.values[1];
+    }
+#endif
+}
+
+//------------------------------------------------------------------------------
+// Running and reporting
+//------------------------------------------------------------------------------
+
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double*) a;
+    double y = *(const double*) b;
+    return (x > y) - (x < y);
+}
+
+static double median_of(double *xs, size_t n) {
+    qsort(xs, n, sizeof(double), compare_doubles);
+    return (n % 2 == 1) ? xs[n / 2] : (xs[n / 2 - 1] + xs[n / 2]) / 2.0;
+}
+
+static Bench_Result bench_run(Bench *bench, size_t samples) {
+    // Find an iteration count that makes one sample long enough to time
+    size_t iters = 1;
+    while (true) {
+        uint64_t start = time_now_ns();
+        bench->run(iters);
+        if (time_now_ns() - start >= BENCH_SAMPLE_NS) break;
+        iters *= 2;
+    }
+
+    for (size_t i = 0; i < BENCH_WARMUP_SAMPLES; ++i) {
+        bench->run(iters);
+    }
+
+    static double times[BENCH_MAX_SAMPLES];
+    static double cycles[BENCH_MAX_SAMPLES];
+    static double instructions[BENCH_MAX_SAMPLES];
+    for (size_t i = 0; i < samples; ++i) {
+        uint64_t c, ins;
+        perf_start();
+        uint64_t start = time_now_ns();
+        bench->run(iters);
+        uint64_t end = time_now_ns();
+        perf_stop(&c, &ins);
+        times[i] = (double) (end - start) / (double) iters;
+        cycles[i] = (double) c / (double) iters;
+        instructions[i] = (double) ins / (double) iters;
+    }
+
+    Bench_Result result = {0};
+    snprintf(result.name, sizeof(result.name), "%s", bench->name);
+    result.samples = samples;
+    result.median_ns = median_of(times, samples);
+    result.cycles = median_of(cycles, samples);
+    result.instructions = median_of(instructions, samples);
+
+    // Distribution free interval for the median, from the order statistics
+    double half = 1.96 * sqrt((double) samples) / 2.0;
+    double lo = floor((double) samples / 2.0 - half);
+    double hi = ceil((double) samples / 2.0 + half);
+    if (lo < 0) lo = 0;
+    if (hi > samples - 1) hi = samples - 1;
+    result.ci_low_ns = times[(size_t) lo];
+    result.ci_high_ns = times[(size_t) hi];
+
+    return result;
+}
+
+static bool results_save(Cstr filepath, Bench_Result *results, size_t count) {
+    FILE *f = fopen(filepath, "w");
+    if (f == NULL) {
+        fprintf(stderr, "Error: could not open '%s': %s\n", filepath, strerror(errno));
+        return false;
+    }
+
+    fprintf(f, "{\"benchmarks\": [\n");
+    for (size_t i = 0; i < count; ++i) {
+        Bench_Result *r = &results[i];
+        fprintf(f, "  {\"name\": \"%s\", \"samples\": %zu, \"median_ns\": %.3f, \"ci_low_ns\": %.3f, \"ci_high_ns\": %.3f, \"cycles\": %.1f, \"instructions\": %.1f}%s\n",
+            r->name, r->samples, r->median_ns, r->ci_low_ns, r->ci_high_ns, r->cycles, r->instructions,
+            (i + 1 < count) ? "," : "");
+    }
+    fprintf(f, "]}\n");
+
+    fclose(f);
+    return true;
+}
+
+// Only reads back what results_save writes, one benchmark per line
+static size_t results_load(Cstr filepath, Bench_Result *results, size_t cap) {
+    FILE *f = fopen(filepath, "r");
+    if (f == NULL) {
+        fprintf(stderr, "Error: could not open '%s': %s\n", filepath, strerror(errno));
+        return 0;
+    }
+
+    size_t count = 0;
+    char line[512];
+    while (count < cap && fgets(line, sizeof(line), f) != NULL) {
+        Bench_Result r = {0};
+        int n = sscanf(line,
+            " {\"name\": \"%63[^\"]\", \"samples\": %zu, \"median_ns\": %lf, \"ci_low_ns\": %lf, \"ci_high_ns\": %lf, \"cycles\": %lf, \"instructions\": %lf",
+            r.name, &r.samples, &r.median_ns, &r.ci_low_ns, &r.ci_high_ns, &r.cycles, &r.instructions);
+        if (n == 7) results[count++] = r;
+    }
+
+    fclose(f);
+    return count;
+}
+
+static void usage(Cstr program) {
+    fprintf(stderr, "Usage: %s [OPTIONS]\n", program);
+    fprintf(stderr, "    --filter <text>     only run benchmarks whose name contains text\n");
+    fprintf(stderr, "    --samples <n>       samples per benchmark (default %d)\n", BENCH_DEFAULT_SAMPLES);
+    fprintf(stderr, "    --perf              collect cycles and instructions with perf_event\n");
+    fprintf(stderr, "    --no-gfx            skip benchmarks that need a window, use it without a display\n");
+    fprintf(stderr, "    --json <file>       write the results as JSON\n");
+    fprintf(stderr, "    --baseline <file>   compare against results written by --json\n");
+    fprintf(stderr, "    --self-test         check the fast lookups against a plain scan of the words and exit\n");
+}
+
+int main(int argc, const char **argv) {
+    Cstr filter = NULL;
+    Cstr json_path = NULL;
+    Cstr baseline_path = NULL;
+    size_t samples = BENCH_DEFAULT_SAMPLES;
+    bool perf = false;
+    bool gfx = true;
+    bool check = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--samples") == 0 && i + 1 < argc) {
+            long number = 0;
+            if (!parse_flag_number("--samples", argv[++i], 3, BENCH_MAX_SAMPLES, &number)) return 1;
+            samples = (size_t) number;
+        } else if (strcmp(argv[i], "--perf") == 0) {
+            perf = true;
+        } else if (strcmp(argv[i], "--no-gfx") == 0) {
+            gfx = false;
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            baseline_path = argv[++i];
+        } else if (strcmp(argv[i], "--self-test") == 0) {
+            check = true;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (perf) perf_init();
+
+    for (size_t i = 0; i < words_count; ++i) {
+        hash_set_cstr_insert(&bench_dict, words[i]);
+    }
+    for (size_t i = 0; i < HASH_SET_CSTR_CAP; ++i) {
+        da_shrink_to_fit(&bench_dict.buckets[i]);
+    }
+    vocab_word_set_init(&bench_words, VOCAB_WORD_LENGTH, (const Cstr *) words, words_count);
+
+    // Half real words, half typos, spread over the dictionary
+    for (size_t i = 0; i < ARRAY_LEN(bench_invalid); ++i) {
+        memcpy(bench_invalid[i], words[(i * 31) % words_count], VOCAB_WORD_LENGTH);
+        bench_invalid[i][i % VOCAB_WORD_LENGTH] = 'q';
+        bench_invalid[i][(i + 2) % VOCAB_WORD_LENGTH] = 'x';
+    }
+    for (size_t i = 0; i < ARRAY_LEN(bench_guesses); ++i) {
+        bench_guesses[i] = (i % 2 == 0) ? words[(i * 11) % words_count] : bench_invalid[i / 2];
+    }
+    bench_guesses_count = ARRAY_LEN(bench_guesses);
+    for (size_t i = 0; i < words_count; ++i) {
+        vocab_dict_insert(&bench_vocab_dict, words[i]);
+    }
+    for (size_t i = 0; i < bench_guesses_count; ++i) {
+        memcpy(bench_guesses_fixed[i], bench_guesses[i], VOCAB_WORD_LENGTH);
+    }
+    if (!bench_check_dict()) return 1;
+    vocab_columns_init(&bench_columns, (const Cstr *) words, words_count);
+    vocab_prefix_init(&bench_prefix, (const Cstr *) words, words_count);
+    vocab_anagrams_init(&bench_anagrams, (const Cstr *) words, words_count);
+    for (size_t i = 0; i < ARRAY_LEN(bench_racks); ++i) {
+        char rack[VOCAB_WORD_LENGTH + 2];
+        memcpy(rack, words[(i * 17) % words_count], VOCAB_WORD_LENGTH);
+        rack[VOCAB_WORD_LENGTH] = words[(i * 5) % words_count][0];
+        rack[VOCAB_WORD_LENGTH + 1] = words[(i * 3) % words_count][1];
+        bench_racks[i] = vocab_letters(rack, sizeof(rack));
+    }
+    for (size_t i = 0; i < ARRAY_LEN(bench_patterns); ++i) {
+        const char *answer = words[(i * 31) % words_count];
+        for (size_t row = 0; row < 1 + i % 2; ++row) {
+            const char *guess = words[(i * 7 + row * 13) % words_count];
+            Vocab_Color colors[VOCAB_WORD_LENGTH];
+            vocab5_score(answer, guess, colors);
+            vocab_pattern_learn(&bench_patterns[i], guess, colors);
+        }
+    }
+    {
+        // The real words followed by random ones
+        char *letters = comp_realloc(NULL, BENCH_BIG_WORDS_COUNT*(VOCAB_WORD_LENGTH + 1));
+        Cstr *big = comp_realloc(NULL, BENCH_BIG_WORDS_COUNT*sizeof(Cstr));
+        assert(letters != NULL && big != NULL && "Buy more RAM lol");
+        uint64_t state = 0x9E3779B97F4A7C15ULL;
+        for (size_t i = 0; i < BENCH_BIG_WORDS_COUNT; ++i) {
+            char *word = letters + i*(VOCAB_WORD_LENGTH + 1);
+            for (size_t j = 0; j < VOCAB_WORD_LENGTH; ++j) {
+                state = state*6364136223846793005ULL + 1442695040888963407ULL;
+                word[j] = i < words_count ? words[i][j] : (char) ('a' + (state >> 33) % 26);
+            }
+            word[VOCAB_WORD_LENGTH] = '\0';
+            big[i] = word;
+        }
+        vocab_columns_init(&bench_columns_big, big, BENCH_BIG_WORDS_COUNT);
+        comp_free(big);
+        comp_free(letters);
+    }
+    if (check) return self_test() ? 0 : 1;
+
+    if (gfx) {
+        SetTraceLogLevel(LOG_WARNING);
+        SetConfigFlags(FLAG_WINDOW_HIDDEN);
+        InitWindow(1280, 720, "Vocab bench");
+        if (!IsWindowReady()) {
+            fprintf(stderr, "Warning: could not open a window, skipping graphics benchmarks\n");
+            gfx = false;
+        } else {
+            bench_font = LoadFont("./resources/ComicMono.ttf");
+            BeginDrawing();
+        }
+    }
+
+    static Bench_Result results[BENCH_RESULTS_CAP];
+    size_t results_count = 0;
+
+    printf("%-26s %12s %25s %12s %12s\n", "benchmark", "median ns", "95% interval", "cycles", "instructions");
+    for (size_t i = 0; i < ARRAY_LEN(benches); ++i) {
+        Bench *bench = &benches[i];
+        if (filter != NULL && strstr(bench->name, filter) == NULL) continue;
+        if (bench->gfx && !gfx) continue;
+
+        Bench_Result r = bench_run(bench, samples);
+        printf("%-26s %12.2f [%10.2f, %10.2f] %12.1f %12.1f\n",
+            r.name, r.median_ns, r.ci_low_ns, r.ci_high_ns, r.cycles, r.instructions);
+        results[results_count++] = r;
+    }
+
+    if (gfx) {
+        EndDrawing();
+        UnloadFont(bench_font);
+        CloseWindow();
+    }
+
+    if (json_path != NULL && !results_save(json_path, results, results_count)) {
+        return 1;
+    }
+
+    int status = 0;
+    if (baseline_path != NULL) {
+        static Bench_Result baseline[BENCH_RESULTS_CAP];
+        size_t baseline_count = results_load(baseline_path, baseline, BENCH_RESULTS_CAP);
+
+        printf("\n%-26s %12s %12s %9s\n", "benchmark", "baseline ns", "median ns", "change");
+        for (size_t i = 0; i < results_count; ++i) {
+            Bench_Result *r = &results[i];
+            Bench_Result *b = NULL;
+            for (size_t j = 0; j < baseline_count; ++j) {
+                if (strcmp(baseline[j].name, r->name) == 0) b = &baseline[j];
+            }
+            if (b == NULL) continue;
+
+            Cstr verdict = "same";
+            if (r->ci_low_ns > b->ci_high_ns) {
+                verdict = "SLOWER";
+                status = 1;
+            } else if (r->ci_high_ns < b->ci_low_ns) {
+                verdict = "faster";
+            }
+
+            double change = (r->median_ns - b->median_ns) / b->median_ns * 100.0;
+            printf("%-26s %12.2f %12.2f %+8.1f%% %s\n", r->name, b->median_ns, r->median_ns, change, verdict);
+        }
+    }
+
+    ui_stack_free(&bench_ui);
+    return status;
+}
@@ -2,9 +2,20 @@
 #include "./comp.h"
 
 #define EXE_FILEPATH "./build/vocab"
+#define HEADLESS_EXE_FILEPATH "./build/vocab-headless"
+#define BENCH_FILEPATH "./build/bench"
+#define SERVER_FILEPATH "./build/vocab-server"
+#define LOADGEN_FILEPATH "./build/vocab-loadgen"
+#define FIND_FILEPATH "./build/vocab-find"
+#define PUZZLE_FILEPATH "./build/vocab-puzzle"
 
 #define RAYLIB_SRC_PATH "./deps/raylib-5.0/src/"
 #define RAYLIB_LIB_PATH "./build/raylib-linux/"
+// Software rendered raylib, no display, GPU or GLFW needed
+#define RAYLIB_HEADLESS_LIB_PATH "./build/raylib-headless/"
+
+#define GOLDEN_PATH "./resources/golden/"
+#define GOLDEN_OUTPUT_PATH "./build/golden/"
 
 const char *OLOKO_MEU = "oloko meu!";
 
@@ -20,57 +31,238 @@ const char *raylib_units[] = {
 };
 size_t raylib_units_count = sizeof(raylib_units)/sizeof(raylib_units[0]);
 
-void build_raylib(void) {
+// `defines` ends with NULL, GLFW is only built for the desktop platform
+void build_raylib(Cstr lib_path, Cstr *defines, bool with_glfw) {
+    // All the paths and command lines live until raylib is built, so they
+    // all come from one arena that is dropped at the end
+    Arena arena = {0};
     Cmd cmd = {0};
 
-    cmd_append(&cmd, "mkdir", "-p", RAYLIB_LIB_PATH);
+    arena_cmd_append(&arena, &cmd, "mkdir", "-p", lib_path);
     cmd_exec_or_die(&cmd);
 
     String lib = {0};
-    string_append_cstr(&lib, RAYLIB_LIB_PATH);
-    string_append_cstr(&lib, "libraylib.a");
-    string_append_null(&lib);
+    arena_string_append_cstr(&arena, &lib, lib_path);
+    arena_string_append_cstr(&arena, &lib, "libraylib.a");
+    arena_string_append_null(&arena, &lib);
 
     Cmd cmd_rl = {0};
-    cmd_append(&cmd_rl, "ar", "-crs", lib.items);
+    arena_cmd_append(&arena, &cmd_rl, "ar", "-crs", lib.items);
 
     for (size_t i = 0; i < raylib_units_count; ++i) {
+        if (!with_glfw && strcmp(raylib_units[i], "rglfw") == 0) continue;
+
         String unit = {0};
-        string_append_cstr(&unit, RAYLIB_SRC_PATH);
-        string_append_cstr(&unit, raylib_units[i]);
-        string_append_cstr(&unit, ".c");
-        string_append_null(&unit);
+        arena_string_append_cstr(&arena, &unit, RAYLIB_SRC_PATH);
+        arena_string_append_cstr(&arena, &unit, raylib_units[i]);
+        arena_string_append_cstr(&arena, &unit, ".c");
+        arena_string_append_null(&arena, &unit);
 
         String obj = {0};
-        string_append_cstr(&obj, RAYLIB_LIB_PATH);
-        string_append_cstr(&obj, raylib_units[i]);
-        string_append_cstr(&obj, ".o");
-        string_append_null(&obj);
+        arena_string_append_cstr(&arena, &obj, lib_path);
+        arena_string_append_cstr(&arena, &obj, raylib_units[i]);
+        arena_string_append_cstr(&arena, &obj, ".o");
+        arena_string_append_null(&arena, &obj);
 
-        cmd_append(&cmd_rl, obj.items);
+        arena_cmd_append(&arena, &cmd_rl, obj.items);
 
         cmd.count = 0;
-        cmd_append(&cmd, "gcc", "-I"RAYLIB_SRC_PATH"external/glfw/include");
-        cmd_append(&cmd, "-DPLATFORM_DESKTOP");
-        cmd_append(&cmd, "-c", unit.items);
-        cmd_append(&cmd, "-o", obj.items);
+        arena_cmd_append(&arena, &cmd, "gcc", "-I"RAYLIB_SRC_PATH"external/glfw/include");
+        for (Cstr *define = defines; *define != NULL; ++define) {
+            arena_cmd_append(&arena, &cmd, *define);
+        }
+        arena_cmd_append(&arena, &cmd, "-c", unit.items);
+        arena_cmd_append(&arena, &cmd, "-o", obj.items);
         cmd_exec_or_die(&cmd);
     }
 
     cmd_exec_or_die(&cmd_rl);
+    arena_free(&arena);
+}
+
+// Replays whose last frame has to come out byte for byte the same as the
+// image next to them. After a change that is meant to move pixels, write the
+// new image with the same flags and --screenshot
+typedef struct {
+    Cstr name;
+    Cstr flags[5]; // Ends with NULL
+} Golden;
+
+Golden goldens[] = {
+    { "game", { NULL } },
+    { "helper", { "--helper", NULL } },
+    { "boards64", { "--boards", "64", NULL } },
+    { "length4", { "--length", "4", "--words", GOLDEN_PATH"words4.txt", NULL } },
+    { "length6", { "--length", "6", "--words", GOLDEN_PATH"words6.txt", NULL } },
+};
+size_t goldens_count = sizeof(goldens)/sizeof(goldens[0]);
+
+// Plays every golden replay on the headless game, returns how many differ
+size_t check_goldens(void) {
+    Arena arena = {0};
+    Cmd cmd = {0};
+
+    arena_cmd_append(&arena, &cmd, "mkdir", "-p", GOLDEN_OUTPUT_PATH);
+    cmd_exec_or_die(&cmd);
+
+    size_t failed = 0;
+    for (size_t i = 0; i < goldens_count; ++i) {
+        String replay = {0};
+        arena_string_append_cstr(&arena, &replay, GOLDEN_PATH);
+        arena_string_append_cstr(&arena, &replay, goldens[i].name);
+        arena_string_append_cstr(&arena, &replay, ".vocb");
+        arena_string_append_null(&arena, &replay);
+
+        String expected = {0};
+        arena_string_append_cstr(&arena, &expected, GOLDEN_PATH);
+        arena_string_append_cstr(&arena, &expected, goldens[i].name);
+        arena_string_append_cstr(&arena, &expected, ".png");
+        arena_string_append_null(&arena, &expected);
+
+        String actual = {0};
+        arena_string_append_cstr(&arena, &actual, GOLDEN_OUTPUT_PATH);
+        arena_string_append_cstr(&arena, &actual, goldens[i].name);
+        arena_string_append_cstr(&arena, &actual, ".png");
+        arena_string_append_null(&arena, &actual);
+
+        cmd.count = 0;
+        arena_cmd_append(&arena, &cmd, HEADLESS_EXE_FILEPATH, "--replay", replay.items, "--screenshot", actual.items);
+        for (Cstr *flag = goldens[i].flags; *flag != NULL; ++flag) {
+            arena_cmd_append(&arena, &cmd, *flag);
+        }
+        bool same = cmd_exec(&cmd) == 0;
+
+        if (same) {
+            cmd.count = 0;
+            arena_cmd_append(&arena, &cmd, "cmp", "-s", expected.items, actual.items);
+            same = cmd_exec(&cmd) == 0;
+        }
+        if (!same) {
+            fprintf(stderr, "Error: golden '%s' does not match, compare %s with %s\n", goldens[i].name, actual.items, expected.items);
+            failed += 1;
+        }
+    }
+    printf("[CHECK]: %zu of %zu goldens match\n", goldens_count - failed, goldens_count);
+
+    arena_free(&arena);
+    return failed;
 }
 
 #define CFLAGS "-Wall", "-Wextra", "-pedantic", "-ggdb", "-std=c11"
-#define CLIBS "-I"RAYLIB_SRC_PATH, "-L"RAYLIB_LIB_PATH, "-lraylib", "-lm"
+#define CLIBS "-I"RAYLIB_SRC_PATH, "-L"RAYLIB_LIB_PATH, "-lraylib", "-lm", "-lpthread"
+#define CLIBS_HEADLESS "-I"RAYLIB_SRC_PATH, "-L"RAYLIB_HEADLESS_LIB_PATH, "-lraylib", "-lm", "-lpthread"
+
+Cstr raylib_defines[] = {"-DPLATFORM_DESKTOP", "-DRL_MEMORY_CALLBACKS", NULL};
+Cstr raylib_headless_defines[] = {
+    "-DPLATFORM_HEADLESS", "-DGRAPHICS_API_OPENGL_11", "-DRL_MEMORY_CALLBACKS", NULL,
+};
 
 int main(int argc, const char **argv) {
     rebuild_self("gcc", argc, argv);
 
-    if (access(RAYLIB_LIB_PATH"libraylib.a", F_OK) != 0) {
-        build_raylib();
+    // COMP_TRACE=build.json ./comp writes a trace of every command it runs
+    Cstr trace_path = getenv("COMP_TRACE");
+    if (trace_path != NULL && !trace_start(trace_path)) {
+        return 1;
     }
 
+    // The tools below are built before raylib, which used to create it
     Cmd cmd = {0};
+    cmd_append(&cmd, "mkdir", "-p", "./build");
+    cmd_exec_or_die(&cmd);
+    cmd.count = 0;
+
+    // Same game on the software rasterizer, for machines without a display.
+    // Returns before the desktop raylib, which needs the X11 headers
+    if (argc > 1 && strcmp(argv[1], "headless") == 0) {
+        if (access(RAYLIB_HEADLESS_LIB_PATH"libraylib.a", F_OK) != 0) {
+            build_raylib(RAYLIB_HEADLESS_LIB_PATH, raylib_headless_defines, false);
+        }
+
+        cmd_append(&cmd, "gcc", CFLAGS, "-o", HEADLESS_EXE_FILEPATH, "./main.c", CLIBS_HEADLESS);
+        cmd_exec_or_die(&cmd);
+
+        // ./comp headless --check replays resources/golden/ and diffs the last frames
+        if (argc > 2 && strcmp(argv[2], "--check") == 0) {
+            size_t failed = check_goldens();
+            trace_stop();
+            return failed > 0;
+        }
+
+        cmd.count = 0;
+        cmd_append(&cmd, HEADLESS_EXE_FILEPATH);
+        for (int i = 2; i < argc; ++i) {
+            cmd_append(&cmd, argv[i]);
+        }
+        int result = cmd_exec(&cmd);
+        trace_stop();
+        return result;
+    }
+
+    // Many games over TCP and Unix sockets, no raylib needed
+    if (argc > 1 && strcmp(argv[1], "server") == 0) {
+        cmd_append(&cmd, "gcc", CFLAGS, "-O2", "-o", SERVER_FILEPATH, "./server.c", "-lpthread");
+        cmd_exec_or_die(&cmd);
+
+        cmd.count = 0;
+        cmd_append(&cmd, SERVER_FILEPATH);
+        for (int i = 2; i < argc; ++i) {
+            cmd_append(&cmd, argv[i]);
+        }
+        int result = cmd_exec(&cmd);
+        trace_stop();
+        return result;
+    }
+
+    // Plays games against a running server, see loadgen.c
+    if (argc > 1 && strcmp(argv[1], "loadgen") == 0) {
+        cmd_append(&cmd, "gcc", CFLAGS, "-O2", "-o", LOADGEN_FILEPATH, "./loadgen.c", "-lpthread");
+        cmd_exec_or_die(&cmd);
+
+        cmd.count = 0;
+        cmd_append(&cmd, LOADGEN_FILEPATH);
+        for (int i = 2; i < argc; ++i) {
+            cmd_append(&cmd, argv[i]);
+        }
+        int result = cmd_exec(&cmd);
+        trace_stop();
+        return result;
+    }
+
+    // Looks words up by pattern, see find.c
+    if (argc > 1 && strcmp(argv[1], "find") == 0) {
+        cmd_append(&cmd, "gcc", CFLAGS, "-O2", "-o", FIND_FILEPATH, "./find.c");
+        cmd_exec_or_die(&cmd);
+
+        cmd.count = 0;
+        cmd_append(&cmd, FIND_FILEPATH);
+        for (int i = 2; i < argc; ++i) {
+            cmd_append(&cmd, argv[i]);
+        }
+        int result = cmd_exec(&cmd);
+        trace_stop();
+        return result;
+    }
+
+    // Letter rack puzzles, see puzzle.c
+    if (argc > 1 && strcmp(argv[1], "puzzle") == 0) {
+        cmd_append(&cmd, "gcc", CFLAGS, "-O2", "-o", PUZZLE_FILEPATH, "./puzzle.c");
+        cmd_exec_or_die(&cmd);
+
+        cmd.count = 0;
+        cmd_append(&cmd, PUZZLE_FILEPATH);
+        for (int i = 2; i < argc; ++i) {
+            cmd_append(&cmd, argv[i]);
+        }
+        int result = cmd_exec(&cmd);
+        trace_stop();
+        return result;
+    }
+
+    if (access(RAYLIB_LIB_PATH"libraylib.a", F_OK) != 0) {
+        build_raylib(RAYLIB_LIB_PATH, raylib_defines, true);
+    }
+
     cmd_append(&cmd, "gcc", CFLAGS, "-o", EXE_FILEPATH, "./main.c", CLIBS);
     cmd_exec_or_die(&cmd);
 
@@ -83,5 +275,21 @@ int main(int argc, const char **argv) {
         cmd_exec(&cmd);
     }
 
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        cmd.count = 0;
+        cmd_append(&cmd, "gcc", CFLAGS, "-O2", "-o", BENCH_FILEPATH, "./bench.c", CLIBS);
+        cmd_exec_or_die(&cmd);
+
+        cmd.count = 0;
+        cmd_append(&cmd, BENCH_FILEPATH);
+        for (int i = 2; i < argc; ++i) {
+            cmd_append(&cmd, argv[i]);
+        }
+        int result = cmd_exec(&cmd);
+        trace_stop();
+        return result;
+    }
+
+    trace_stop();
     return 0;
 }
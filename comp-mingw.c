@@ -19,51 +19,61 @@ const char *raylib_units[] = {
 size_t raylib_units_count = sizeof(raylib_units)/sizeof(raylib_units[0]);
 
 void build_raylib(void) {
+    // All the paths and command lines live until raylib is built, so they
+    // all come from one arena that is dropped at the end
+    Arena arena = {0};
     Cmd cmd = {0};
 
-    cmd_append(&cmd, "mkdir", "-p", RAYLIB_LIB_PATH);
+    arena_cmd_append(&arena, &cmd, "mkdir", "-p", RAYLIB_LIB_PATH);
     cmd_exec_or_die(&cmd);
 
     String lib = {0};
-    string_append_cstr(&lib, RAYLIB_LIB_PATH);
-    string_append_cstr(&lib, "libraylib.a");
-    string_append_null(&lib);
+    arena_string_append_cstr(&arena, &lib, RAYLIB_LIB_PATH);
+    arena_string_append_cstr(&arena, &lib, "libraylib.a");
+    arena_string_append_null(&arena, &lib);
 
     Cmd cmd_rl = {0};
-    cmd_append(&cmd_rl, "x86_64-w64-mingw32-ar", "-crs", lib.items);
+    arena_cmd_append(&arena, &cmd_rl, "x86_64-w64-mingw32-ar", "-crs", lib.items);
 
     for (size_t i = 0; i < raylib_units_count; ++i) {
         String unit = {0};
-        string_append_cstr(&unit, RAYLIB_SRC_PATH);
-        string_append_cstr(&unit, raylib_units[i]);
-        string_append_cstr(&unit, ".c");
-        string_append_null(&lib);
+        arena_string_append_cstr(&arena, &unit, RAYLIB_SRC_PATH);
+        arena_string_append_cstr(&arena, &unit, raylib_units[i]);
+        arena_string_append_cstr(&arena, &unit, ".c");
+        arena_string_append_null(&arena, &unit);
 
         String obj = {0};
-        string_append_cstr(&obj, RAYLIB_LIB_PATH);
-        string_append_cstr(&obj, raylib_units[i]);
-        string_append_cstr(&obj, ".o");
-        string_append_null(&lib);
+        arena_string_append_cstr(&arena, &obj, RAYLIB_LIB_PATH);
+        arena_string_append_cstr(&arena, &obj, raylib_units[i]);
+        arena_string_append_cstr(&arena, &obj, ".o");
+        arena_string_append_null(&arena, &obj);
 
-        cmd_append(&cmd_rl, obj.items);
+        arena_cmd_append(&arena, &cmd_rl, obj.items);
 
         cmd.count = 0;
-        cmd_append(&cmd, "x86_64-w64-mingw32-gcc", "-I"RAYLIB_SRC_PATH"external/glfw/include");
-        cmd_append(&cmd, "-DPLATFORM_DESKTOP");
-        cmd_append(&cmd, "-c", unit.items);
-        cmd_append(&cmd, "-o", obj.items);
+        arena_cmd_append(&arena, &cmd, "x86_64-w64-mingw32-gcc", "-I"RAYLIB_SRC_PATH"external/glfw/include");
+        arena_cmd_append(&arena, &cmd, "-DPLATFORM_DESKTOP", "-DRL_MEMORY_CALLBACKS");
+        arena_cmd_append(&arena, &cmd, "-c", unit.items);
+        arena_cmd_append(&arena, &cmd, "-o", obj.items);
         cmd_exec_or_die(&cmd);
     }
 
     cmd_exec_or_die(&cmd_rl);
+    arena_free(&arena);
 }
 
 #define CFLAGS "-Wall", "-Wextra", "-pedantic", "-ggdb", "-std=c11"
-#define CLIBS "-I"RAYLIB_SRC_PATH, "-L"RAYLIB_LIB_PATH, "-l:libraylib.a", "-lm", "-lwinmm", "-lgdi32"
+#define CLIBS "-I"RAYLIB_SRC_PATH, "-L"RAYLIB_LIB_PATH, "-l:libraylib.a", "-lm", "-lwinmm", "-lgdi32", "-lpthread"
 
 int main(int argc, const char **argv) {
     rebuild_self("gcc", argc, argv);
 
+    // COMP_TRACE=build.json ./comp writes a trace of every command it runs
+    Cstr trace_path = getenv("COMP_TRACE");
+    if (trace_path != NULL && !trace_start(trace_path)) {
+        return 1;
+    }
+
     // TODO(nic): add caching of raylib later
     build_raylib();
 
@@ -80,5 +90,6 @@ int main(int argc, const char **argv) {
         cmd_exec(&cmd);
     }
 
+    trace_stop();
     return 0;
 }
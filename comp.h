@@ -1,13 +1,21 @@
 #ifndef COMP_H_
 #define COMP_H_
 
+// clock_gettime() is POSIX, not C11. Only works if comp.h comes before any
+// other include, otherwise define it yourself.
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+    #define _POSIX_C_SOURCE 200809L
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
 #include <assert.h>
 #include <string.h>
+#include <stdint.h>
 #include <errno.h>
 #include <time.h>
+#include <stdatomic.h>
 
 #ifdef _WIN32
     #include <windows.h>
@@ -23,7 +31,15 @@
     typedef pid_t PID;
 #endif
 
-#define DA_DEFAULT_CAP 1024
+// Dynamic arrays start with as many elements as fit in a cache line and
+// double from there, so small arrays of small things stay small.
+#define DA_CACHE_LINE_SIZE 64
+#define da_init_cap(da)                                 \
+    ((sizeof(*(da)->items) >= DA_CACHE_LINE_SIZE)       \
+        ? (size_t) 1                                    \
+        : DA_CACHE_LINE_SIZE / sizeof(*(da)->items))
+
+#define ARRAY_LEN(array) (sizeof(array)/sizeof((array)[0]))
 
 // Used for *null terminated* strings
 typedef const char *Cstr;
@@ -42,36 +58,174 @@ typedef struct {
 
 typedef Da_Cstr Cmd;
 
-#define da_append(da, item)                                             \
+// Every allocation made by the da_* macros goes through the current allocator.
+// By default that's just libc, `allocator_set` lets you plug something else,
+// like the tracking allocator below. Set it before allocating anything, memory
+// must be released by the same allocator that created it.
+typedef struct {
+    void *(*realloc)(void *user, void *ptr, size_t size, Cstr file, int line);
+    void (*free)(void *user, void *ptr, Cstr file, int line);
+    void *user;
+} Allocator;
+
+void allocator_set(Allocator allocator);
+void *allocator_realloc(void *ptr, size_t size, Cstr file, int line);
+void allocator_free(void *ptr, Cstr file, int line);
+
+#define comp_realloc(ptr, size) allocator_realloc((ptr), (size), __FILE__, __LINE__)
+#define comp_free(ptr) allocator_free((ptr), __FILE__, __LINE__)
+
+#define ALLOC_SITES_CAP 128
+
+typedef struct {
+    Cstr file;
+    int line;
+    size_t count;
+    size_t bytes;
+} Alloc_Site;
+
+typedef struct {
+    size_t count;
+    size_t bytes;
+    size_t live_bytes;
+    size_t peak_bytes;
+    size_t frame_count;
+    size_t frame_bytes;
+} Alloc_Stats;
+
+// Tracking allocator, counts allocations, bytes, peak usage and call sites.
+// Frames are delimited by `alloc_frame_end`, which returns the stats for the
+// frame that just finished and resets the per frame counters.
+// NOTE: not thread safe
+Allocator alloc_tracker(void);
+Alloc_Stats alloc_stats(void);
+Alloc_Stats alloc_frame_end(void);
+void alloc_report(FILE *stream);
+
+#define da_reserve(da, needed)                                          \
     do {                                                                \
-        if ((da)->count >= (da)->capacity) {                            \
+        if ((da)->capacity < (needed)) {                                \
             size_t new_cap = ((da)->capacity == 0)                      \
-                ? DA_DEFAULT_CAP                                        \
-                : (da)->capacity * 2;                                   \
-            (da)->items = realloc((da)->items, new_cap * sizeof(*(da)->items)); \
+                ? da_init_cap(da)                                       \
+                : (da)->capacity;                                       \
+            while (new_cap < (needed)) {                                \
+                new_cap *= 2;                                           \
+            }                                                           \
+            (da)->items = comp_realloc((da)->items, new_cap * sizeof(*(da)->items)); \
             assert((da)->items != NULL && "Error: not enough RAM");     \
             (da)->capacity = new_cap;                                   \
         }                                                               \
+    } while(0)
+
+#define da_append(da, item)                                             \
+    do {                                                                \
+        da_reserve((da), (da)->count + 1);                              \
         (da)->items[(da)->count++] = item;                              \
     } while(0)
 
 #define da_append_many(da, items_ptr, items_count)                      \
     do {                                                                \
-        if ((da)->capacity < (da)->count + (items_count)) {             \
-            size_t new_cap = ((da)->capacity == 0)                      \
-                ? DA_DEFAULT_CAP                                        \
-                : (da)->capacity;                                       \
-            while (new_cap < (da)->count + (items_count)) {             \
+        da_reserve((da), (da)->count + (items_count));                  \
+        memcpy((da)->items + (da)->count, (items_ptr), (items_count) * sizeof(*(da)->items)); \
+        (da)->count += (items_count);                                   \
+    } while(0)
+
+// Give back the capacity that is not used, for arrays that are done growing
+#define da_shrink_to_fit(da)                                            \
+    do {                                                                \
+        if ((da)->count == 0) {                                         \
+            da_free(da);                                                \
+        } else if ((da)->count < (da)->capacity) {                      \
+            (da)->items = comp_realloc((da)->items, (da)->count * sizeof(*(da)->items)); \
+            assert((da)->items != NULL && "Error: not enough RAM");     \
+            (da)->capacity = (da)->count;                               \
+        }                                                               \
+    } while(0)
+
+#define da_free(da)                                                     \
+    do {                                                                \
+        comp_free((da)->items);                                         \
+        (da)->items = NULL;                                             \
+        (da)->count = 0;                                                \
+        (da)->capacity = 0;                                             \
+    } while(0)
+
+// Dynamic array that keeps its first n elements inside the struct and only
+// goes to the heap past that. Zero initialize it like any other da, e.g.
+//     typedef Da_Small(Cstr, 8) Small_Cstrs;
+// NOTE: items points into the struct itself while the elements are inline,
+// so don't copy a small array by value after appending to it.
+#define Da_Small(type, n)                       \
+    struct {                                    \
+        type *items;                            \
+        size_t count;                           \
+        size_t capacity;                        \
+        type inline_items[n];                   \
+    }
+
+#define da_small_reserve(da, needed)                                    \
+    do {                                                                \
+        if ((da)->items == NULL) {                                      \
+            (da)->items = (da)->inline_items;                           \
+            (da)->capacity = ARRAY_LEN((da)->inline_items);             \
+        }                                                               \
+        if ((da)->capacity < (needed)) {                                \
+            size_t new_cap = (da)->capacity * 2;                        \
+            while (new_cap < (needed)) {                                \
                 new_cap *= 2;                                           \
             }                                                           \
-            (da)->items = realloc((da)->items, new_cap * sizeof(*(da)->items)); \
-            assert((da)->items != NULL && "Error: not enough RAM");     \
+            if ((da)->items == (da)->inline_items) {                    \
+                void *heap = comp_realloc(NULL, new_cap * sizeof(*(da)->items)); \
+                assert(heap != NULL && "Error: not enough RAM");        \
+                memcpy(heap, (da)->inline_items, (da)->count * sizeof(*(da)->items)); \
+                (da)->items = heap;                                     \
+            } else {                                                    \
+                (da)->items = comp_realloc((da)->items, new_cap * sizeof(*(da)->items)); \
+                assert((da)->items != NULL && "Error: not enough RAM"); \
+            }                                                           \
             (da)->capacity = new_cap;                                   \
         }                                                               \
+    } while(0)
+
+#define da_small_append(da, item)                                       \
+    do {                                                                \
+        da_small_reserve((da), (da)->count + 1);                        \
+        (da)->items[(da)->count++] = item;                              \
+    } while(0)
+
+#define da_small_append_many(da, items_ptr, items_count)                \
+    do {                                                                \
+        da_small_reserve((da), (da)->count + (items_count));            \
         memcpy((da)->items + (da)->count, (items_ptr), (items_count) * sizeof(*(da)->items)); \
         (da)->count += (items_count);                                   \
     } while(0)
 
+// Moves the elements back inline when they fit, otherwise trims the heap block
+#define da_small_shrink_to_fit(da)                                      \
+    do {                                                                \
+        if ((da)->items == NULL || (da)->items == (da)->inline_items) break; \
+        if ((da)->count <= ARRAY_LEN((da)->inline_items)) {             \
+            memcpy((da)->inline_items, (da)->items, (da)->count * sizeof(*(da)->items)); \
+            comp_free((da)->items);                                     \
+            (da)->items = (da)->inline_items;                           \
+            (da)->capacity = ARRAY_LEN((da)->inline_items);             \
+        } else if ((da)->count < (da)->capacity) {                      \
+            (da)->items = comp_realloc((da)->items, (da)->count * sizeof(*(da)->items)); \
+            assert((da)->items != NULL && "Error: not enough RAM");     \
+            (da)->capacity = (da)->count;                               \
+        }                                                               \
+    } while(0)
+
+#define da_small_free(da)                                               \
+    do {                                                                \
+        if ((da)->items != (da)->inline_items) {                        \
+            comp_free((da)->items);                                     \
+        }                                                               \
+        (da)->items = NULL;                                             \
+        (da)->count = 0;                                                \
+        (da)->capacity = 0;                                             \
+    } while(0)
+
 #define cmd_append(cmd, ...)                        \
     da_append_many(                                 \
         (cmd),                                      \
@@ -87,6 +241,132 @@ typedef Da_Cstr Cmd;
 #define string_append_null(string) \
     da_append((string), '\0')
 
+// Arena allocator, a linked list of regions that allocations are bumped from.
+// Nothing is freed individually, `arena_rewind` drops everything allocated
+// after a mark and `arena_reset` drops everything, both in O(1) per region.
+#define ARENA_REGION_DEFAULT_CAP (8*1024)
+
+typedef struct Arena_Region Arena_Region;
+
+struct Arena_Region {
+    Arena_Region *next;
+    size_t count;
+    size_t capacity;
+    uintptr_t data[];
+};
+
+typedef struct {
+    Arena_Region *begin;
+    Arena_Region *end;
+} Arena;
+
+typedef struct {
+    Arena_Region *region;
+    size_t count;
+} Arena_Mark;
+
+void *arena_alloc(Arena *arena, size_t size);
+void *arena_realloc(Arena *arena, void *old, size_t old_size, size_t new_size);
+Arena_Mark arena_mark(Arena *arena);
+void arena_rewind(Arena *arena, Arena_Mark mark);
+void arena_reset(Arena *arena);
+void arena_free(Arena *arena);
+
+// Arena backed versions of the da_* helpers. Growing the most recent
+// allocation of an arena happens in place, so appending stays cheap.
+
+#define arena_da_reserve(arena, da, needed)                             \
+    do {                                                                \
+        if ((da)->capacity < (needed)) {                                \
+            size_t new_cap = ((da)->capacity == 0)                      \
+                ? da_init_cap(da)                                       \
+                : (da)->capacity;                                       \
+            while (new_cap < (needed)) {                                \
+                new_cap *= 2;                                           \
+            }                                                           \
+            (da)->items = arena_realloc(                                \
+                (arena), (da)->items,                                   \
+                (da)->capacity * sizeof(*(da)->items),                  \
+                new_cap * sizeof(*(da)->items));                        \
+            (da)->capacity = new_cap;                                   \
+        }                                                               \
+    } while(0)
+
+#define arena_da_append(arena, da, item)                                \
+    do {                                                                \
+        arena_da_reserve((arena), (da), (da)->count + 1);               \
+        (da)->items[(da)->count++] = item;                              \
+    } while(0)
+
+#define arena_da_append_many(arena, da, items_ptr, items_count)         \
+    do {                                                                \
+        arena_da_reserve((arena), (da), (da)->count + (items_count));   \
+        memcpy((da)->items + (da)->count, (items_ptr), (items_count) * sizeof(*(da)->items)); \
+        (da)->count += (items_count);                                   \
+    } while(0)
+
+#define arena_cmd_append(arena, cmd, ...)           \
+    arena_da_append_many(                           \
+        (arena),                                    \
+        (cmd),                                      \
+        ((Cstr[]){__VA_ARGS__}),                    \
+        sizeof((Cstr[]){__VA_ARGS__})/sizeof(Cstr))
+
+#define arena_string_append_cstr(arena, string, cstr) \
+    arena_da_append_many(                           \
+        (arena),                                    \
+        (string),                                   \
+        (cstr),                                     \
+        strlen(cstr))
+
+#define arena_string_append_null(arena, string) \
+    arena_da_append((arena), (string), '\0')
+
+// Monotonic clock in nanoseconds, only meaningful relative to other calls
+uint64_t time_now_ns(void);
+
+// Command line numbers. The whole of `text` has to be a number from `min` to
+// `max`, otherwise the error is printed with the flag name and false returned
+bool parse_flag_number(Cstr flag, Cstr text, long min, long max, long *value);
+// Same for seeds, which can be any 64 bit number
+bool parse_flag_seed(Cstr flag, Cstr text, uint64_t *value);
+// Same for fractional numbers like rates and seconds
+bool parse_flag_real(Cstr flag, Cstr text, double min, double max, double *value);
+
+// Tracing, spans, instant events and counters written as Chrome trace event
+// JSON, open the file in chrome://tracing or https://ui.perfetto.dev.
+// Each thread gets its own lock-free ring that only it writes to, `trace_flush`
+// drains all the rings into the file. Events that don't fit in a full ring
+// are dropped and counted. Names are copied, so they don't need to outlive
+// the call. Nothing is recorded before `trace_start` or after `trace_stop`.
+#define TRACE_RING_CAP (16*1024) // Must be a power of two
+#define TRACE_NAME_CAP 40
+
+typedef enum {
+    TRACE_BEGIN,
+    TRACE_END,
+    TRACE_INSTANT,
+    TRACE_COUNTER,
+} Trace_Kind;
+
+typedef struct {
+    char name[TRACE_NAME_CAP];
+    Trace_Kind kind;
+    uint64_t ts;
+    int64_t value;
+} Trace_Event;
+
+bool trace_start(Cstr filepath);
+void trace_stop(void);
+// NOTE: call it from one thread at a time
+void trace_flush(void);
+bool trace_enabled(void);
+
+void trace_begin(Cstr name);
+void trace_end(Cstr name);
+void trace_instant(Cstr name);
+void trace_counter(Cstr name, int64_t value);
+
 #define rebuild_self(compiler_path, argc, argv)                 \
     rebuild_self_impl(compiler_path, (argc), (argv), __FILE__)  \
 
@@ -103,6 +383,442 @@ void cmd_exec_or_die(Cmd *cmd);
 #ifdef COMP_IMPLEMENTATION
 #undef COMP_IMPLEMENTATION
 
+static Allocator comp_allocator = {0};
+
+void allocator_set(Allocator allocator) {
+    comp_allocator = allocator;
+}
+
+void *allocator_realloc(void *ptr, size_t size, Cstr file, int line) {
+    if (comp_allocator.realloc == NULL) {
+        return realloc(ptr, size);
+    }
+    return comp_allocator.realloc(comp_allocator.user, ptr, size, file, line);
+}
+
+void allocator_free(void *ptr, Cstr file, int line) {
+    if (comp_allocator.free == NULL) {
+        free(ptr);
+        return;
+    }
+    comp_allocator.free(comp_allocator.user, ptr, file, line);
+}
+
+// Each tracked block is prefixed with its size, so frees can be accounted for
+// without a lookup table. 16 bytes keeps the user pointer aligned for anything.
+#define ALLOC_HEADER_SIZE 16
+
+// raylib encodes captures on a worker thread, so the tracker can be entered
+// from more than one thread. Blocks are only held for a few stores.
+static struct {
+    atomic_bool locked;
+    Alloc_Stats stats;
+    Alloc_Site sites[ALLOC_SITES_CAP];
+    size_t sites_count;
+} alloc_tracker_state = {0};
+
+static void alloc_tracker_lock(void) {
+    while (atomic_exchange_explicit(&alloc_tracker_state.locked, true, memory_order_acquire)) {}
+}
+
+static void alloc_tracker_unlock(void) {
+    atomic_store_explicit(&alloc_tracker_state.locked, false, memory_order_release);
+}
+
+static void alloc_tracker_record(size_t size, Cstr file, int line) {
+    Alloc_Stats *stats = &alloc_tracker_state.stats;
+    stats->count += 1;
+    stats->bytes += size;
+    stats->frame_count += 1;
+    stats->frame_bytes += size;
+
+    Alloc_Site *site = NULL;
+    for (size_t i = 0; i < alloc_tracker_state.sites_count; ++i) {
+        Alloc_Site *it = &alloc_tracker_state.sites[i];
+        if (it->line == line && strcmp(it->file, file) == 0) {
+            site = it;
+            break;
+        }
+    }
+    if (site == NULL && alloc_tracker_state.sites_count < ALLOC_SITES_CAP) {
+        site = &alloc_tracker_state.sites[alloc_tracker_state.sites_count++];
+        site->file = file;
+        site->line = line;
+    }
+    if (site != NULL) {
+        site->count += 1;
+        site->bytes += size;
+    }
+}
+
+static void *alloc_tracker_realloc(void *user, void *ptr, size_t size, Cstr file, int line) {
+    (void) user;
+    Alloc_Stats *stats = &alloc_tracker_state.stats;
+
+    char *block = (ptr == NULL) ? NULL : (char*) ptr - ALLOC_HEADER_SIZE;
+    size_t old_size = (block == NULL) ? 0 : *(size_t*) block;
+
+    block = realloc(block, size + ALLOC_HEADER_SIZE);
+    if (block == NULL) return NULL;
+    *(size_t*) block = size;
+
+    alloc_tracker_lock();
+    stats->live_bytes = stats->live_bytes - old_size + size;
+    if (stats->live_bytes > stats->peak_bytes) {
+        stats->peak_bytes = stats->live_bytes;
+    }
+    alloc_tracker_record(size, file, line);
+    alloc_tracker_unlock();
+
+    return block + ALLOC_HEADER_SIZE;
+}
+
+static void alloc_tracker_free(void *user, void *ptr, Cstr file, int line) {
+    (void) user;
+    (void) file;
+    (void) line;
+    if (ptr == NULL) return;
+
+    char *block = (char*) ptr - ALLOC_HEADER_SIZE;
+    alloc_tracker_lock();
+    alloc_tracker_state.stats.live_bytes -= *(size_t*) block;
+    alloc_tracker_unlock();
+    free(block);
+}
+
+Allocator alloc_tracker(void) {
+    return (Allocator) {
+        .realloc = alloc_tracker_realloc,
+        .free = alloc_tracker_free,
+        .user = NULL,
+    };
+}
+
+Alloc_Stats alloc_stats(void) {
+    alloc_tracker_lock();
+    Alloc_Stats stats = alloc_tracker_state.stats;
+    alloc_tracker_unlock();
+    return stats;
+}
+
+Alloc_Stats alloc_frame_end(void) {
+    alloc_tracker_lock();
+    Alloc_Stats frame = alloc_tracker_state.stats;
+    alloc_tracker_state.stats.frame_count = 0;
+    alloc_tracker_state.stats.frame_bytes = 0;
+    alloc_tracker_unlock();
+    return frame;
+}
+
+void alloc_report(FILE *stream) {
+    Alloc_Stats *stats = &alloc_tracker_state.stats;
+    fprintf(stream, "[ALLOC]: %zu allocations, %zu bytes total, %zu bytes live, %zu bytes peak\n",
+        stats->count, stats->bytes, stats->live_bytes, stats->peak_bytes);
+    for (size_t i = 0; i < alloc_tracker_state.sites_count; ++i) {
+        Alloc_Site *site = &alloc_tracker_state.sites[i];
+        fprintf(stream, "[ALLOC]:     %s:%d: %zu allocations, %zu bytes\n",
+            site->file, site->line, site->count, site->bytes);
+    }
+}
+
+static Arena_Region *arena_region_new(size_t capacity) {
+    Arena_Region *region = comp_realloc(NULL, sizeof(Arena_Region) + capacity * sizeof(uintptr_t));
+    assert(region != NULL && "Error: not enough RAM");
+    region->next = NULL;
+    region->count = 0;
+    region->capacity = capacity;
+    return region;
+}
+
+void *arena_alloc(Arena *arena, size_t size) {
+    size_t words = (size + sizeof(uintptr_t) - 1) / sizeof(uintptr_t);
+
+    if (arena->end == NULL) {
+        size_t capacity = ARENA_REGION_DEFAULT_CAP;
+        if (capacity < words) capacity = words;
+        arena->end = arena_region_new(capacity);
+        arena->begin = arena->end;
+    }
+
+    // Regions past the end are left over from a rewind, reuse them first
+    while (arena->end->count + words > arena->end->capacity && arena->end->next != NULL) {
+        arena->end = arena->end->next;
+    }
+
+    if (arena->end->count + words > arena->end->capacity) {
+        size_t capacity = ARENA_REGION_DEFAULT_CAP;
+        if (capacity < words) capacity = words;
+        arena->end->next = arena_region_new(capacity);
+        arena->end = arena->end->next;
+    }
+
+    void *result = &arena->end->data[arena->end->count];
+    arena->end->count += words;
+    return result;
+}
+
+void *arena_realloc(Arena *arena, void *old, size_t old_size, size_t new_size) {
+    if (new_size <= old_size) return old;
+
+    // The last allocation of the current region can just grow in place
+    if (old != NULL && arena->end != NULL) {
+        size_t old_words = (old_size + sizeof(uintptr_t) - 1) / sizeof(uintptr_t);
+        size_t new_words = (new_size + sizeof(uintptr_t) - 1) / sizeof(uintptr_t);
+        Arena_Region *region = arena->end;
+        if (region->count >= old_words &&
+            (uintptr_t*) old == &region->data[region->count - old_words] &&
+            region->count - old_words + new_words <= region->capacity) {
+            region->count += new_words - old_words;
+            return old;
+        }
+    }
+
+    void *result = arena_alloc(arena, new_size);
+    if (old != NULL) {
+        memcpy(result, old, old_size);
+    }
+    return result;
+}
+
+Arena_Mark arena_mark(Arena *arena) {
+    if (arena->end == NULL) {
+        return (Arena_Mark) {0};
+    }
+    return (Arena_Mark) { arena->end, arena->end->count };
+}
+
+void arena_rewind(Arena *arena, Arena_Mark mark) {
+    if (mark.region == NULL) {
+        arena_reset(arena);
+        return;
+    }
+
+    mark.region->count = mark.count;
+    for (Arena_Region *it = mark.region->next; it != NULL; it = it->next) {
+        it->count = 0;
+    }
+    arena->end = mark.region;
+}
+
+void arena_reset(Arena *arena) {
+    for (Arena_Region *it = arena->begin; it != NULL; it = it->next) {
+        it->count = 0;
+    }
+    arena->end = arena->begin;
+}
+
+void arena_free(Arena *arena) {
+    Arena_Region *it = arena->begin;
+    while (it != NULL) {
+        Arena_Region *next = it->next;
+        comp_free(it);
+        it = next;
+    }
+    arena->begin = NULL;
+    arena->end = NULL;
+}
+
+uint64_t time_now_ns(void) {
+#ifdef _WIN32
+    LARGE_INTEGER freq, counter;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&counter);
+    return (uint64_t) (counter.QuadPart / freq.QuadPart) * 1000000000
+        + (uint64_t) (counter.QuadPart % freq.QuadPart) * 1000000000 / freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000 + (uint64_t) ts.tv_nsec;
+#endif
+}
+
+bool parse_flag_number(Cstr flag, Cstr text, long min, long max, long *value) {
+    char *end = NULL;
+    errno = 0;
+    *value = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || errno == ERANGE || *value < min || *value > max) {
+        fprintf(stderr, "Error: %s takes a number from %ld to %ld, got '%s'\n", flag, min, max, text);
+        return false;
+    }
+    return true;
+}
+
+bool parse_flag_seed(Cstr flag, Cstr text, uint64_t *value) {
+    char *end = NULL;
+    errno = 0;
+    unsigned long long seed = strtoull(text, &end, 10);
+    // strtoull() skips spaces and negates a leading '-' without complaining
+    if (text[0] < '0' || text[0] > '9' || *end != '\0' || errno == ERANGE) {
+        fprintf(stderr, "Error: %s takes a number from 0 to %llu, got '%s'\n", flag, (unsigned long long) UINT64_MAX, text);
+        return false;
+    }
+    *value = (uint64_t) seed;
+    return true;
+}
+
+bool parse_flag_real(Cstr flag, Cstr text, double min, double max, double *value) {
+    char *end = NULL;
+    errno = 0;
+    *value = strtod(text, &end);
+    // Written so that NaN is out of range
+    if (end == text || *end != '\0' || errno == ERANGE || !(*value >= min && *value <= max)) {
+        fprintf(stderr, "Error: %s takes a number from %g to %g, got '%s'\n", flag, min, max, text);
+        return false;
+    }
+    return true;
+}
+
+typedef struct Trace_Ring Trace_Ring;
+
+struct Trace_Ring {
+    Trace_Event events[TRACE_RING_CAP];
+    atomic_size_t head; // Only moved by the thread that owns the ring
+    atomic_size_t tail; // Only moved by trace_flush
+    atomic_size_t dropped;
+    size_t tid;
+    Trace_Ring *next;
+};
+
+static struct {
+    atomic_bool enabled;
+    FILE *file;
+    uint64_t start;
+    bool first_event;
+    _Atomic(Trace_Ring*) rings;
+    atomic_size_t next_tid;
+} trace_state = {0};
+
+static _Thread_local Trace_Ring *trace_ring = NULL;
+
+static Trace_Ring *trace_ring_get(void) {
+    if (trace_ring != NULL) return trace_ring;
+
+    // Straight from libc, a tracer that shows up in the allocation stats is not helpful
+    Trace_Ring *ring = calloc(1, sizeof(Trace_Ring));
+    assert(ring != NULL && "Error: not enough RAM");
+    ring->tid = atomic_fetch_add(&trace_state.next_tid, 1) + 1;
+
+    Trace_Ring *head = atomic_load(&trace_state.rings);
+    do {
+        ring->next = head;
+    } while (!atomic_compare_exchange_weak(&trace_state.rings, &head, ring));
+
+    trace_ring = ring;
+    return ring;
+}
+
+static void trace_emit(Trace_Kind kind, Cstr name, int64_t value) {
+    if (!atomic_load_explicit(&trace_state.enabled, memory_order_relaxed)) return;
+
+    Trace_Ring *ring = trace_ring_get();
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (head - tail >= TRACE_RING_CAP) {
+        atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    Trace_Event *event = &ring->events[head & (TRACE_RING_CAP - 1)];
+    strncpy(event->name, name, TRACE_NAME_CAP - 1);
+    event->name[TRACE_NAME_CAP - 1] = '\0';
+    event->kind = kind;
+    event->ts = time_now_ns();
+    event->value = value;
+
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+static void trace_write_event(Trace_Event *event, size_t tid) {
+    FILE *f = trace_state.file;
+    fprintf(f, "%s\n{\"name\":\"", trace_state.first_event ? "" : ",");
+    trace_state.first_event = false;
+
+    for (char *c = event->name; *c != '\0'; ++c) {
+        if (*c == '"' || *c == '\\') fputc('\\', f);
+        fputc(*c, f);
+    }
+
+    double ts = (double) (event->ts - trace_state.start) / 1000.0;
+    fprintf(f, "\",\"pid\":1,\"tid\":%zu,\"ts\":%.3f", tid, ts);
+
+    switch (event->kind) {
+    case TRACE_BEGIN: fprintf(f, ",\"ph\":\"B\"}"); break;
+    case TRACE_END: fprintf(f, ",\"ph\":\"E\"}"); break;
+    case TRACE_INSTANT: fprintf(f, ",\"ph\":\"i\",\"s\":\"t\"}"); break;
+    case TRACE_COUNTER:
+        fprintf(f, ",\"ph\":\"C\",\"args\":{\"value\":%lld}}", (long long) event->value);
+        break;
+    }
+}
+
+bool trace_start(Cstr filepath) {
+    assert(trace_state.file == NULL && "Error: tracing already started");
+    trace_state.file = fopen(filepath, "w");
+    if (trace_state.file == NULL) {
+        fprintf(stderr, "Error: could not open '%s': %s\n", filepath, strerror(errno));
+        return false;
+    }
+
+    fprintf(trace_state.file, "{\"traceEvents\":[");
+    trace_state.first_event = true;
+    trace_state.start = time_now_ns();
+    atomic_store(&trace_state.enabled, true);
+    return true;
+}
+
+void trace_flush(void) {
+    if (trace_state.file == NULL) return;
+
+    for (Trace_Ring *ring = atomic_load(&trace_state.rings); ring != NULL; ring = ring->next) {
+        size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        for (; tail != head; ++tail) {
+            trace_write_event(&ring->events[tail & (TRACE_RING_CAP - 1)], ring->tid);
+        }
+        atomic_store_explicit(&ring->tail, tail, memory_order_release);
+    }
+}
+
+// NOTE: the rings stay around, threads may still hold on to theirs
+void trace_stop(void) {
+    if (trace_state.file == NULL) return;
+
+    atomic_store(&trace_state.enabled, false);
+    trace_flush();
+
+    size_t dropped = 0;
+    for (Trace_Ring *ring = atomic_load(&trace_state.rings); ring != NULL; ring = ring->next) {
+        dropped += atomic_exchange(&ring->dropped, 0);
+    }
+    if (dropped > 0) {
+        fprintf(stderr, "[TRACE]: dropped %zu events, flush more often\n", dropped);
+    }
+
+    fprintf(trace_state.file, "\n]}\n");
+    fclose(trace_state.file);
+    trace_state.file = NULL;
+}
+
+bool trace_enabled(void) {
+    return atomic_load_explicit(&trace_state.enabled, memory_order_relaxed);
+}
+
+void trace_begin(Cstr name) {
+    trace_emit(TRACE_BEGIN, name, 0);
+}
+
+void trace_end(Cstr name) {
+    trace_emit(TRACE_END, name, 0);
+}
+
+void trace_instant(Cstr name) {
+    trace_emit(TRACE_INSTANT, name, 0);
+}
+
+void trace_counter(Cstr name, int64_t value) {
+    trace_emit(TRACE_COUNTER, name, value);
+}
+
 TIME get_last_time_modified(Cstr filepath) {
 #ifdef _WIN32
     HANDLE handle = CreateFile(
@@ -147,32 +863,34 @@ void rebuild_self_impl(Cstr compiler_path, int argc, const char **argv, Cstr src
     TIME src_last_modified = get_last_time_modified(src_filepath);
 
     if (src_last_modified > exe_last_modified) {
+        Arena arena = {0};
         Cmd cmd = {0};
 
         String old_exe_filepath = {0};
-        string_append_cstr(&old_exe_filepath, exe_filepath);
-        string_append_cstr(&old_exe_filepath, ".old");
-        string_append_null(&old_exe_filepath);
+        arena_string_append_cstr(&arena, &old_exe_filepath, exe_filepath);
+        arena_string_append_cstr(&arena, &old_exe_filepath, ".old");
+        arena_string_append_null(&arena, &old_exe_filepath);
 
         cmd.count = 0;
-        cmd_append(&cmd, "mv", exe_filepath, old_exe_filepath.items);
+        arena_cmd_append(&arena, &cmd, "mv", exe_filepath, old_exe_filepath.items);
         cmd_exec_or_die(&cmd);
 
         cmd.count = 0;
-        cmd_append(&cmd, compiler_path, "-o", exe_filepath, src_filepath);
+        arena_cmd_append(&arena, &cmd, compiler_path, "-o", exe_filepath, src_filepath);
 
         int result = cmd_exec(&cmd);
         if (result != 0) {
             cmd.count = 0;
-            cmd_append(&cmd, "mv", old_exe_filepath.items, exe_filepath);
+            arena_cmd_append(&arena, &cmd, "mv", old_exe_filepath.items, exe_filepath);
             cmd_exec_or_die(&cmd);
+            arena_free(&arena);
             return;
         }
 
         cmd.count = 0;
-        cmd_append(&cmd, exe_filepath);
+        arena_cmd_append(&arena, &cmd, exe_filepath);
         for (int i = 1; i < argc; ++i) {
-            cmd_append(&cmd, argv[i]);
+            arena_cmd_append(&arena, &cmd, argv[i]);
         }
         cmd_exec_or_die(&cmd);
 
@@ -232,6 +950,17 @@ int cmd_exec(Cmd *cmd) {
         printf("%s", (i >= cmd->count - 1) ? "\n" : " ");
     }
 
+    // Name the span after the program and its output file if there is one
+    char span[TRACE_NAME_CAP] = {0};
+    if (trace_enabled()) {
+        Cstr target = cmd->items[cmd->count - 1];
+        for (size_t i = 0; i + 1 < cmd->count; ++i) {
+            if (strcmp(cmd->items[i], "-o") == 0) target = cmd->items[i + 1];
+        }
+        snprintf(span, sizeof(span), "%s %s", cmd->items[0], target);
+    }
+    trace_begin(span);
+
 #ifdef _WIN32
     String args = {0};
     for (size_t i = 0; i < cmd->count; ++i) {
@@ -249,7 +978,9 @@ int cmd_exec(Cmd *cmd) {
         exit(1);
     }
 
-    return pid_wait(info.hProcess);
+    int result = pid_wait(info.hProcess);
+    trace_end(span);
+    return result;
 #else
     pid_t cpid = fork();
     if (cpid < 0) {
@@ -269,7 +1000,9 @@ int cmd_exec(Cmd *cmd) {
         exit(0);
     }
 
-    return pid_wait(cpid);
+    int result = pid_wait(cpid);
+    trace_end(span);
+    return result;
 #endif
 }
 
@@ -58,10 +58,15 @@
 //#define SUPPORT_BUSY_WAIT_LOOP          1
 // Use a partial-busy wait loop, in this case frame sleeps for most of the time, but then runs a busy loop at the end for accuracy
 #define SUPPORT_PARTIALBUSY_WAIT_LOOP    1
+// Pace frames against absolute deadlines, sleeping with clock_nanosleep(TIMER_ABSTIME) and only busy waiting
+// for as long as the measured wakeup jitter requires (Linux/FreeBSD, other platforms keep using WaitTime())
+#define SUPPORT_PRECISE_FRAME_PACING     1
 // Allow automatic screen capture of current screen pressing F12, defined in KeyCallback()
 #define SUPPORT_SCREEN_CAPTURE          1
 // Allow automatic gif recording of current screen pressing CTRL+F12, defined in KeyCallback()
 #define SUPPORT_GIF_RECORDING           1
+// Read back captures through pixel pack buffers and encode them on a worker thread (not on Windows, uses pthreads)
+#define SUPPORT_ASYNC_CAPTURE           1
 // Support CompressData() and DecompressData() functions
 #define SUPPORT_COMPRESSION_API         1
 // Support automatic generated events, loading and recording of those events when required
@@ -170,6 +175,8 @@
 // Support multiple image editing functions to scale, adjust colors, flip, draw on images, crop...
 // If not defined, still some functions are supported: ImageFormat(), ImageCrop(), ImageToPOT()
 #define SUPPORT_IMAGE_MANIPULATION      1
+// Use SSE2/AVX2/NEON kernels for RGBA8 image fills and alpha blending, when the target has them
+#define SUPPORT_IMAGE_SIMD              1
 
 
 //------------------------------------------------------------------------------------
@@ -457,6 +457,15 @@ void SetMouseCursor(int cursor)
     TRACELOG(LOG_WARNING, "SetMouseCursor() not implemented on target platform");
 }
 
+// Poll platform events again without starting a new input frame
+// NOTE: Only the input queue is drained here, app commands (LOOPER_ID_MAIN) can pause the
+// activity or destroy the window and are left for PollInputEvents() between frames
+void LatchInputEvents(void)
+{
+    // Same as the glue does for a LOOPER_ID_INPUT poll result, AndroidInputCallback() queues the events
+    if (platform.app->inputQueue != NULL) platform.app->inputPollSource.process(platform.app, &platform.app->inputPollSource);
+}
+
 // Register all input events
 void PollInputEvents(void)
 {
@@ -1024,9 +1033,21 @@ static int32_t AndroidInputCallback(struct android_app *app, AInputEvent *event)
 
             CORE.Input.Keyboard.keyPressedQueue[CORE.Input.Keyboard.keyPressedQueueCount] = keycode;
             CORE.Input.Keyboard.keyPressedQueueCount++;
+
+            PushInputEvent(INPUT_EVENT_KEY_PRESSED, keycode);
+        }
+        else if (AKeyEvent_getAction(event) == AKEY_EVENT_ACTION_MULTIPLE)
+        {
+            CORE.Input.Keyboard.keyRepeatInFrame[keycode] = 1;
+
+            PushInputEvent(INPUT_EVENT_KEY_REPEAT, keycode);
+        }
+        else
+        {
+            CORE.Input.Keyboard.currentKeyState[keycode] = 0;  // Key up
+
+            PushInputEvent(INPUT_EVENT_KEY_RELEASED, keycode);
         }
-        else if (AKeyEvent_getAction(event) == AKEY_EVENT_ACTION_MULTIPLE) CORE.Input.Keyboard.keyRepeatInFrame[keycode] = 1;
-        else CORE.Input.Keyboard.currentKeyState[keycode] = 0;  // Key up
 
         if (keycode == AKEYCODE_POWER)
         {
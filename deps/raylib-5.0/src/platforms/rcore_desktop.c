@@ -1094,6 +1094,14 @@ void SetMouseCursor(int cursor)
     }
 }
 
+// Poll platform events again without starting a new input frame
+// NOTE: Keys and chars that arrive here are only seen through GetInputEvent() and IsKeyDown(),
+// the per-frame key/char queues are reset by the next PollInputEvents() before they can be read
+void LatchInputEvents(void)
+{
+    glfwPollEvents();       // Callbacks push into the input events queue
+}
+
 // Register all input events
 void PollInputEvents(void)
 {
@@ -1710,6 +1718,11 @@ static void KeyCallback(GLFWwindow *window, int key, int scancode, int action, i
         CORE.Input.Keyboard.keyPressedQueueCount++;
     }
 
+    // NOTE: GLFW does not timestamp events, time is taken when glfwPollEvents() dispatches them
+    if (action == GLFW_RELEASE) PushInputEvent(INPUT_EVENT_KEY_RELEASED, key);
+    else if (action == GLFW_PRESS) PushInputEvent(INPUT_EVENT_KEY_PRESSED, key);
+    else if (action == GLFW_REPEAT) PushInputEvent(INPUT_EVENT_KEY_REPEAT, key);
+
     // Check the exit key to set close window
     if ((key == CORE.Input.Keyboard.exitKey) && (action == GLFW_PRESS)) glfwSetWindowShouldClose(platform.handle, GLFW_TRUE);
 }
@@ -1731,6 +1744,7 @@ static void CharCallback(GLFWwindow *window, unsigned int key)
         CORE.Input.Keyboard.charPressedQueue[CORE.Input.Keyboard.charPressedQueueCount] = key;
         CORE.Input.Keyboard.charPressedQueueCount++;
     }
+    PushInputEvent(INPUT_EVENT_CHAR, key);
 }
 
 // GLFW3 Mouse Button Callback, runs on mouse button pressed
@@ -948,6 +948,31 @@ void SetMouseCursor(int cursor)
     CORE.Input.Mouse.cursor = cursor;
 }
 
+// Poll platform events again without starting a new input frame
+// NOTE: Only keyboard events are taken, everything else stays queued for PollInputEvents()
+void LatchInputEvents(void)
+{
+    SDL_PumpEvents();
+
+    SDL_Event event = { 0 };
+    while (SDL_PeepEvents(&event, 1, SDL_GETEVENT, SDL_KEYDOWN, SDL_KEYUP) > 0)
+    {
+        KeyboardKey key = ConvertScancodeToKey(event.key.keysym.scancode);
+        if (key == KEY_NULL) continue;
+
+        if (event.type == SDL_KEYDOWN)
+        {
+            CORE.Input.Keyboard.currentKeyState[key] = 1;
+            PushInputEvent(event.key.repeat? INPUT_EVENT_KEY_REPEAT : INPUT_EVENT_KEY_PRESSED, key);
+        }
+        else
+        {
+            CORE.Input.Keyboard.currentKeyState[key] = 0;
+            PushInputEvent(INPUT_EVENT_KEY_RELEASED, key);
+        }
+    }
+}
+
 // Register all input events
 void PollInputEvents(void)
 {
@@ -1088,6 +1113,7 @@ void PollInputEvents(void)
             {
                 KeyboardKey key = ConvertScancodeToKey(event.key.keysym.scancode);
                 if (key != KEY_NULL) CORE.Input.Keyboard.currentKeyState[key] = 1;
+                if (key != KEY_NULL) PushInputEvent(event.key.repeat? INPUT_EVENT_KEY_REPEAT : INPUT_EVENT_KEY_PRESSED, key);
 
                 // TODO: Put exitKey verification outside the switch?
                 if (CORE.Input.Keyboard.currentKeyState[CORE.Input.Keyboard.exitKey])
@@ -1100,6 +1126,7 @@ void PollInputEvents(void)
             {
                 KeyboardKey key = ConvertScancodeToKey(event.key.keysym.scancode);
                 if (key != KEY_NULL) CORE.Input.Keyboard.currentKeyState[key] = 0;
+                if (key != KEY_NULL) PushInputEvent(INPUT_EVENT_KEY_RELEASED, key);
             } break;
 
             // Check mouse events
@@ -533,6 +533,13 @@ void SetMouseCursor(int cursor)
     TRACELOG(LOG_WARNING, "SetMouseCursor() not implemented on target platform");
 }
 
+// Poll platform events again without starting a new input frame
+// NOTE: Keyboard events are pushed by the event threads as they arrive, they are already queued
+void LatchInputEvents(void)
+{
+    // Nothing to do
+}
+
 // Register all input events
 void PollInputEvents(void)
 {
@@ -1715,6 +1722,11 @@ static void PollKeyboardEvents(void)
                         CORE.Input.Keyboard.keyPressedQueueCount++;
                     }
 
+                    // NOTE: Runs on the keyboard thread, the events queue is safe for one producer
+                    if (event.value == 0) PushInputEvent(INPUT_EVENT_KEY_RELEASED, keycode);
+                    else if (event.value == 1) PushInputEvent(INPUT_EVENT_KEY_PRESSED, keycode);
+                    else PushInputEvent(INPUT_EVENT_KEY_REPEAT, keycode);
+
                 #if defined(SUPPORT_SCREEN_CAPTURE)
                     // Check screen capture key (raylib key: KEY_F12)
                     if (CORE.Input.Keyboard.currentKeyState[301] == 1)
@@ -1734,6 +1746,8 @@ static void PollKeyboardEvents(void)
                             CORE.Input.Keyboard.charPressedQueue[CORE.Input.Keyboard.charPressedQueueCount] = EvkeyToUnicodeLUT[event.code];
                             CORE.Input.Keyboard.charPressedQueueCount++;
                         }
+
+                        PushInputEvent(INPUT_EVENT_CHAR, EvkeyToUnicodeLUT[event.code]);
                     }
 
                     if (CORE.Input.Keyboard.currentKeyState[CORE.Input.Keyboard.exitKey] == 1) CORE.Window.shouldClose = true;
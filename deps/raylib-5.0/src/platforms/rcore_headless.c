@@ -0,0 +1,1301 @@
+/**********************************************************************************************
+*
+*   rcore_headless - Functions to manage window, graphics device and inputs
+*
+*   PLATFORM: HEADLESS
+*       - Any system, no display, no GPU and no windowing system required
+*       - Software rasterizer drawing into an in-memory Image, for CI, benchmarks and golden images
+*
+*   LIMITATIONS:
+*       - Only GRAPHICS_API_OPENGL_11 is supported, the backend provides the subset of OpenGL 1.1 rlgl uses
+*       - 2D only: quads, triangles and lines are rasterized, meshes (glDrawArrays/glDrawElements) are ignored
+*       - No depth buffer, render textures or shaders, blending is always straight alpha blending
+*       - Textures are sampled nearest on the triangle path, lines are not blended
+*       - No input devices, input events can still be pushed by the application
+*
+*   POSSIBLE IMPROVEMENTS:
+*       - Bilinear sampling on the triangle path
+*       - Recycle texture ids, they only grow for now
+*
+*   ADDITIONAL NOTES:
+*       - TRACELOG() function is located in raylib [utils] module
+*       - Axis-aligned quads, which is everything rshapes and rtext emit without rotation, are drawn
+*         with ImageDrawRectangleRec() or sampled bilinear straight from the texture, nothing is
+*         allocated while drawing
+*       - The framebuffer is kept after SwapScreenBuffer(), so LoadImageFromScreen() returns the last frame
+*
+*   CONFIGURATION:
+*       #define GRAPHICS_API_OPENGL_11
+*           Required, rlgl must emit immediate-mode OpenGL 1.1 calls for this backend to implement
+*
+*   DEPENDENCIES:
+*       - GL/gl.h: Only the header for the OpenGL 1.1 types and constants, no libGL is linked
+*       - rtextures: Image drawing functions used by the rasterizer
+*
+*
+*   LICENSE: zlib/libpng
+*
+*   Copyright (c) 2013-2023 Ramon Santamaria (@raysan5) and contributors
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#if !defined(GRAPHICS_API_OPENGL_11)
+    #error "PLATFORM_HEADLESS requires GRAPHICS_API_OPENGL_11"
+#endif
+
+#if !defined(SUPPORT_MODULE_RTEXTURES)
+    #error "PLATFORM_HEADLESS requires SUPPORT_MODULE_RTEXTURES for the Image drawing functions"
+#endif
+
+#include <stdlib.h>         // Required for: abs()
+#include <math.h>           // Required for: floorf(), cosf(), sinf(), sqrtf()
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define SOFTGL_MATRIX_STACK_SIZE    32      // Matrices per stack, same as the OpenGL 1.1 minimum for modelview
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Vertex after transformation, in framebuffer pixels with top-left origin
+typedef struct {
+    float x, y;                         // Position
+    float u, v;                         // Texture coordinates
+    Color color;                        // Vertex color
+} SoftVertex;
+
+typedef struct {
+    Image framebuffer;                  // Render target (R8G8B8A8), top row first
+
+    // Software OpenGL 1.1 state
+    float matrixStack[3][SOFTGL_MATRIX_STACK_SIZE][16];  // Modelview, projection and texture stacks (column-major)
+    int matrixTop[3];                   // Current matrix of every stack
+    int matrixMode;                     // Stack the matrix functions work on
+    int viewport[4];                    // Viewport x, y, width, height (bottom-left origin)
+    int scissor[4];                     // Scissor x, y, width, height (bottom-left origin)
+    bool scissorEnabled;                // GL_SCISSOR_TEST
+    Color clearColor;                   // glClearColor()
+
+    Image *textures;                    // Texture images by id, id 0 is never used
+    unsigned int texturesCount;         // Texture ids handed out, plus one
+    unsigned int texturesCapacity;      // Allocated texture slots
+    unsigned int textureBound;          // GL_TEXTURE_2D binding
+    bool textureEnabled;                // GL_TEXTURE_2D enabled
+
+    int primitive;                      // Mode passed to glBegin(), -1 outside glBegin()/glEnd()
+    SoftVertex vertices[4];             // Vertices of the primitive being built
+    int verticesCount;                  // Vertices of the primitive received so far
+    Color color;                        // Current color
+    float texcoord[2];                  // Current texture coordinates
+    bool meshWarned;                    // Vertex arrays are not supported, warn once
+} PlatformData;
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition
+//----------------------------------------------------------------------------------
+extern CoreData CORE;                   // Global CORE state context
+
+static PlatformData platform = { 0 };   // Platform specific data
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions Declaration
+//----------------------------------------------------------------------------------
+int InitPlatform(void);          // Initialize platform (graphics, inputs and more)
+void ClosePlatform(void);        // Close platform
+
+static float *SoftGetMatrix(void);                                  // Get current matrix of the selected stack
+static void SoftMultMatrix(const float *mat);                       // Multiply current matrix by mat (column-major)
+static void SoftDrawPrimitive(void);                                // Rasterize the primitive in platform.vertices
+static bool SoftDrawQuadAligned(const SoftVertex *v);               // Draw axis-aligned quad with Image functions, false if not possible
+static void SoftDrawTriangle(SoftVertex a, SoftVertex b, SoftVertex c);  // Rasterize triangle, blended
+static void SoftDrawLine(SoftVertex a, SoftVertex b);               // Rasterize line
+static void SoftGetClipRect(int *x0, int *y0, int *x1, int *y1);     // Get pixels that can be drawn, framebuffer and scissor
+static Color SoftSampleTexture(float u, float v);                   // Get bound texture texel (nearest, repeat)
+static void SoftDrawTextureRec(const Image *texture, Rectangle srcRec, Rectangle dstRec, Color tint);  // Draw texture part stretched, bilinear
+static inline Color SoftGetTexel(const Image *texture, int x, int y);  // Get texel, formats used by fonts and shapes read directly
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+// NOTE: Functions declaration is provided by raylib.h
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition: Window and Graphics Device
+//----------------------------------------------------------------------------------
+
+// Check if application should close
+bool WindowShouldClose(void)
+{
+    if (CORE.Window.ready) return CORE.Window.shouldClose;
+    else return true;
+}
+
+// Toggle fullscreen mode
+void ToggleFullscreen(void)
+{
+    TRACELOG(LOG_WARNING, "ToggleFullscreen() not available on target platform");
+}
+
+// Toggle borderless windowed mode
+void ToggleBorderlessWindowed(void)
+{
+    TRACELOG(LOG_WARNING, "ToggleBorderlessWindowed() not available on target platform");
+}
+
+// Set window state: maximized, if resizable
+void MaximizeWindow(void)
+{
+    TRACELOG(LOG_WARNING, "MaximizeWindow() not available on target platform");
+}
+
+// Set window state: minimized
+void MinimizeWindow(void)
+{
+    TRACELOG(LOG_WARNING, "MinimizeWindow() not available on target platform");
+}
+
+// Set window state: not minimized/maximized
+void RestoreWindow(void)
+{
+    TRACELOG(LOG_WARNING, "RestoreWindow() not available on target platform");
+}
+
+// Set window configuration state using flags
+void SetWindowState(unsigned int flags)
+{
+    TRACELOG(LOG_WARNING, "SetWindowState() not available on target platform");
+}
+
+// Clear window configuration state flags
+void ClearWindowState(unsigned int flags)
+{
+    TRACELOG(LOG_WARNING, "ClearWindowState() not available on target platform");
+}
+
+// Set icon for window
+void SetWindowIcon(Image image)
+{
+    TRACELOG(LOG_WARNING, "SetWindowIcon() not available on target platform");
+}
+
+// Set icon for window
+void SetWindowIcons(Image *images, int count)
+{
+    TRACELOG(LOG_WARNING, "SetWindowIcons() not available on target platform");
+}
+
+// Set title for window
+void SetWindowTitle(const char *title)
+{
+    CORE.Window.title = title;
+}
+
+// Set window position on screen (windowed mode)
+void SetWindowPosition(int x, int y)
+{
+    TRACELOG(LOG_WARNING, "SetWindowPosition() not available on target platform");
+}
+
+// Set monitor for the current window
+void SetWindowMonitor(int monitor)
+{
+    TRACELOG(LOG_WARNING, "SetWindowMonitor() not available on target platform");
+}
+
+// Set window minimum dimensions (FLAG_WINDOW_RESIZABLE)
+void SetWindowMinSize(int width, int height)
+{
+    CORE.Window.screenMin.width = width;
+    CORE.Window.screenMin.height = height;
+}
+
+// Set window maximum dimensions (FLAG_WINDOW_RESIZABLE)
+void SetWindowMaxSize(int width, int height)
+{
+    CORE.Window.screenMax.width = width;
+    CORE.Window.screenMax.height = height;
+}
+
+// Set window dimensions
+void SetWindowSize(int width, int height)
+{
+    TRACELOG(LOG_WARNING, "SetWindowSize() not available on target platform");
+}
+
+// Set window opacity, value opacity is between 0.0 and 1.0
+void SetWindowOpacity(float opacity)
+{
+    TRACELOG(LOG_WARNING, "SetWindowOpacity() not available on target platform");
+}
+
+// Set window focused
+void SetWindowFocused(void)
+{
+    TRACELOG(LOG_WARNING, "SetWindowFocused() not available on target platform");
+}
+
+// Get native window handle
+void *GetWindowHandle(void)
+{
+    return NULL;
+}
+
+// Get number of monitors
+int GetMonitorCount(void)
+{
+    return 1;
+}
+
+// Get number of monitors
+int GetCurrentMonitor(void)
+{
+    return 0;
+}
+
+// Get selected monitor position
+Vector2 GetMonitorPosition(int monitor)
+{
+    TRACELOG(LOG_WARNING, "GetMonitorPosition() not implemented on target platform");
+    return (Vector2){ 0, 0 };
+}
+
+// Get selected monitor width (currently used by monitor)
+int GetMonitorWidth(int monitor)
+{
+    return CORE.Window.display.width;
+}
+
+// Get selected monitor height (currently used by monitor)
+int GetMonitorHeight(int monitor)
+{
+    return CORE.Window.display.height;
+}
+
+// Get selected monitor physical width in millimetres
+int GetMonitorPhysicalWidth(int monitor)
+{
+    return 0;
+}
+
+// Get selected monitor physical height in millimetres
+int GetMonitorPhysicalHeight(int monitor)
+{
+    return 0;
+}
+
+// Get selected monitor refresh rate
+// NOTE: There is no display to pace to, 0 lets frames run as fast as they can be rasterized
+int GetMonitorRefreshRate(int monitor)
+{
+    return 0;
+}
+
+// Get the human-readable, UTF-8 encoded name of the selected monitor
+const char *GetMonitorName(int monitor)
+{
+    return "Headless";
+}
+
+// Get window position XY on monitor
+Vector2 GetWindowPosition(void)
+{
+    return (Vector2){ 0, 0 };
+}
+
+// Get window scale DPI factor for current monitor
+Vector2 GetWindowScaleDPI(void)
+{
+    return (Vector2){ 1.0f, 1.0f };
+}
+
+// Set clipboard text content
+void SetClipboardText(const char *text)
+{
+    TRACELOG(LOG_WARNING, "SetClipboardText() not implemented on target platform");
+}
+
+// Get clipboard text content
+// NOTE: There is no clipboard without a windowing system, always returns NULL
+const char *GetClipboardText(void)
+{
+    TRACELOG(LOG_WARNING, "GetClipboardText() not implemented on target platform");
+    return NULL;
+}
+
+// Show mouse cursor
+void ShowCursor(void)
+{
+    CORE.Input.Mouse.cursorHidden = false;
+}
+
+// Hides mouse cursor
+void HideCursor(void)
+{
+    CORE.Input.Mouse.cursorHidden = true;
+}
+
+// Enables cursor (unlock cursor)
+void EnableCursor(void)
+{
+    // Set cursor position in the middle
+    SetMousePosition(CORE.Window.screen.width/2, CORE.Window.screen.height/2);
+
+    CORE.Input.Mouse.cursorHidden = false;
+}
+
+// Disables cursor (lock cursor)
+void DisableCursor(void)
+{
+    // Set cursor position in the middle
+    SetMousePosition(CORE.Window.screen.width/2, CORE.Window.screen.height/2);
+
+    CORE.Input.Mouse.cursorHidden = true;
+}
+
+// Swap back buffer with front buffer (screen drawing)
+// NOTE: There is a single framebuffer, it is kept as is so it can be read back after the frame
+void SwapScreenBuffer(void)
+{
+    // Nothing to present
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition: Misc
+//----------------------------------------------------------------------------------
+
+// Get elapsed time measure in seconds since InitTimer()
+double GetTime(void)
+{
+    double time = 0.0;
+    struct timespec ts = { 0 };
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    unsigned long long int nanoSeconds = (unsigned long long int)ts.tv_sec*1000000000LLU + (unsigned long long int)ts.tv_nsec;
+
+    time = (double)(nanoSeconds - CORE.Time.base)*1e-9;  // Elapsed time since InitTimer()
+
+    return time;
+}
+
+// Open URL with default system browser (if available)
+void OpenURL(const char *url)
+{
+    TRACELOG(LOG_WARNING, "OpenURL() not available on target platform");
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition: Inputs
+//----------------------------------------------------------------------------------
+
+// Set internal gamepad mappings
+int SetGamepadMappings(const char *mappings)
+{
+    TRACELOG(LOG_WARNING, "SetGamepadMappings() not available on target platform");
+    return 0;
+}
+
+// Set mouse position XY
+void SetMousePosition(int x, int y)
+{
+    CORE.Input.Mouse.currentPosition = (Vector2){ (float)x, (float)y };
+    CORE.Input.Mouse.previousPosition = CORE.Input.Mouse.currentPosition;
+}
+
+// Set mouse cursor
+void SetMouseCursor(int cursor)
+{
+    CORE.Input.Mouse.cursor = cursor;
+}
+
+// Poll platform events again without starting a new input frame
+void LatchInputEvents(void)
+{
+    // There are no input devices, events only come from PushInputEvent() callers
+}
+
+// Register all input events
+void PollInputEvents(void)
+{
+#if defined(SUPPORT_GESTURES_SYSTEM)
+    // NOTE: Gestures update must be called every frame to reset gestures correctly
+    // because ProcessGestureEvent() is just called on an event, not every frame
+    UpdateGestures();
+#endif
+
+    // Reset keys/chars pressed registered
+    CORE.Input.Keyboard.keyPressedQueueCount = 0;
+    CORE.Input.Keyboard.charPressedQueueCount = 0;
+
+    // Reset last gamepad button/axis registered state
+    CORE.Input.Gamepad.lastButtonPressed = 0; // GAMEPAD_BUTTON_UNKNOWN
+
+    // Register previous touch states
+    for (int i = 0; i < MAX_TOUCH_POINTS; i++) CORE.Input.Touch.previousTouchState[i] = CORE.Input.Touch.currentTouchState[i];
+
+    // Register previous keys states
+    for (int i = 0; i < MAX_KEYBOARD_KEYS; i++)
+    {
+        CORE.Input.Keyboard.previousKeyState[i] = CORE.Input.Keyboard.currentKeyState[i];
+        CORE.Input.Keyboard.keyRepeatInFrame[i] = 0;
+    }
+
+    // Register previous mouse states
+    for (int i = 0; i < MAX_MOUSE_BUTTONS; i++) CORE.Input.Mouse.previousButtonState[i] = CORE.Input.Mouse.currentButtonState[i];
+    CORE.Input.Mouse.previousWheelMove = CORE.Input.Mouse.currentWheelMove;
+    CORE.Input.Mouse.currentWheelMove = (Vector2){ 0.0f, 0.0f };
+    CORE.Input.Mouse.previousPosition = CORE.Input.Mouse.currentPosition;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition: Software OpenGL 1.1
+//----------------------------------------------------------------------------------
+// NOTE: Only the functions rlgl calls with GRAPHICS_API_OPENGL_11 are provided,
+// they replace libGL, so the signatures must match GL/gl.h
+
+void glViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    platform.viewport[0] = x;
+    platform.viewport[1] = y;
+    platform.viewport[2] = width;
+    platform.viewport[3] = height;
+}
+
+void glScissor(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    platform.scissor[0] = x;
+    platform.scissor[1] = y;
+    platform.scissor[2] = width;
+    platform.scissor[3] = height;
+}
+
+void glEnable(GLenum cap)
+{
+    if (cap == GL_TEXTURE_2D) platform.textureEnabled = true;
+    else if (cap == GL_SCISSOR_TEST) platform.scissorEnabled = true;
+}
+
+void glDisable(GLenum cap)
+{
+    if (cap == GL_TEXTURE_2D) platform.textureEnabled = false;
+    else if (cap == GL_SCISSOR_TEST) platform.scissorEnabled = false;
+}
+
+void glClearColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha)
+{
+    platform.clearColor = (Color){ (unsigned char)(red*255.0f), (unsigned char)(green*255.0f), (unsigned char)(blue*255.0f), (unsigned char)(alpha*255.0f) };
+}
+
+void glClear(GLbitfield mask)
+{
+    if (mask & GL_COLOR_BUFFER_BIT) ImageClearBackground(&platform.framebuffer, platform.clearColor);
+}
+
+void glReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, GLvoid *pixels)
+{
+    if ((format != GL_RGBA) || (type != GL_UNSIGNED_BYTE))
+    {
+        TRACELOG(LOG_WARNING, "GL: Only RGBA8 pixels can be read back from the software framebuffer");
+        return;
+    }
+
+    const Image *fb = &platform.framebuffer;
+    if ((x < 0) || (y < 0) || ((x + width) > fb->width) || ((y + height) > fb->height)) return;
+
+    // Rows are returned bottom row first, like from a GPU framebuffer
+    for (int row = 0; row < height; row++)
+    {
+        const unsigned char *src = (const unsigned char *)fb->data + ((fb->height - 1 - (y + row))*fb->width + x)*4;
+        memcpy((unsigned char *)pixels + row*width*4, src, width*4);
+    }
+}
+
+void glMatrixMode(GLenum mode)
+{
+    switch (mode)
+    {
+        case GL_MODELVIEW: platform.matrixMode = 0; break;
+        case GL_PROJECTION: platform.matrixMode = 1; break;
+        case GL_TEXTURE: platform.matrixMode = 2; break;
+        default: break;
+    }
+}
+
+void glLoadIdentity(void)
+{
+    float *mat = SoftGetMatrix();
+    for (int i = 0; i < 16; i++) mat[i] = ((i%5) == 0)? 1.0f : 0.0f;
+}
+
+void glPushMatrix(void)
+{
+    int *top = &platform.matrixTop[platform.matrixMode];
+    if (*top >= (SOFTGL_MATRIX_STACK_SIZE - 1))
+    {
+        TRACELOG(LOG_WARNING, "GL: Matrix stack overflow");
+        return;
+    }
+
+    memcpy(platform.matrixStack[platform.matrixMode][*top + 1], platform.matrixStack[platform.matrixMode][*top], 16*sizeof(float));
+    (*top)++;
+}
+
+void glPopMatrix(void)
+{
+    int *top = &platform.matrixTop[platform.matrixMode];
+    if (*top > 0) (*top)--;
+    else TRACELOG(LOG_WARNING, "GL: Matrix stack underflow");
+}
+
+void glMultMatrixf(const GLfloat *m)
+{
+    SoftMultMatrix(m);
+}
+
+void glTranslatef(GLfloat x, GLfloat y, GLfloat z)
+{
+    const float mat[16] = { 1, 0, 0, 0,  0, 1, 0, 0,  0, 0, 1, 0,  x, y, z, 1 };
+    SoftMultMatrix(mat);
+}
+
+void glScalef(GLfloat x, GLfloat y, GLfloat z)
+{
+    const float mat[16] = { x, 0, 0, 0,  0, y, 0, 0,  0, 0, z, 0,  0, 0, 0, 1 };
+    SoftMultMatrix(mat);
+}
+
+void glRotatef(GLfloat angle, GLfloat x, GLfloat y, GLfloat z)
+{
+    float length = sqrtf(x*x + y*y + z*z);
+    if (length == 0.0f) return;
+    x /= length;
+    y /= length;
+    z /= length;
+
+    float c = cosf(angle*DEG2RAD);
+    float s = sinf(angle*DEG2RAD);
+    float t = 1.0f - c;
+
+    const float mat[16] = {
+        x*x*t + c,      y*x*t + z*s,    z*x*t - y*s,    0,
+        x*y*t - z*s,    y*y*t + c,      z*y*t + x*s,    0,
+        x*z*t + y*s,    y*z*t - x*s,    z*z*t + c,      0,
+        0,              0,              0,              1
+    };
+    SoftMultMatrix(mat);
+}
+
+void glOrtho(GLdouble left, GLdouble right, GLdouble bottom, GLdouble top, GLdouble near_val, GLdouble far_val)
+{
+    float rl = (float)(right - left);
+    float tb = (float)(top - bottom);
+    float fn = (float)(far_val - near_val);
+
+    const float mat[16] = {
+        2.0f/rl, 0, 0, 0,
+        0, 2.0f/tb, 0, 0,
+        0, 0, -2.0f/fn, 0,
+        -(float)(right + left)/rl, -(float)(top + bottom)/tb, -(float)(far_val + near_val)/fn, 1
+    };
+    SoftMultMatrix(mat);
+}
+
+void glFrustum(GLdouble left, GLdouble right, GLdouble bottom, GLdouble top, GLdouble near_val, GLdouble far_val)
+{
+    float rl = (float)(right - left);
+    float tb = (float)(top - bottom);
+    float fn = (float)(far_val - near_val);
+
+    const float mat[16] = {
+        (float)(near_val*2.0)/rl, 0, 0, 0,
+        0, (float)(near_val*2.0)/tb, 0, 0,
+        (float)(right + left)/rl, (float)(top + bottom)/tb, -(float)(far_val + near_val)/fn, -1,
+        0, 0, -(float)(far_val*near_val*2.0)/fn, 0
+    };
+    SoftMultMatrix(mat);
+}
+
+void glGetFloatv(GLenum pname, GLfloat *params)
+{
+    switch (pname)
+    {
+        case GL_MODELVIEW_MATRIX: memcpy(params, platform.matrixStack[0][platform.matrixTop[0]], 16*sizeof(float)); break;
+        case GL_PROJECTION_MATRIX: memcpy(params, platform.matrixStack[1][platform.matrixTop[1]], 16*sizeof(float)); break;
+        case GL_TEXTURE_MATRIX: memcpy(params, platform.matrixStack[2][platform.matrixTop[2]], 16*sizeof(float)); break;
+        default: break;
+    }
+}
+
+const GLubyte *glGetString(GLenum name)
+{
+    switch (name)
+    {
+        case GL_VENDOR: return (const GLubyte *)"raylib";
+        case GL_RENDERER: return (const GLubyte *)"raylib headless software rasterizer";
+        case GL_VERSION: return (const GLubyte *)"1.1";
+        default: return (const GLubyte *)"";
+    }
+}
+
+void glBegin(GLenum mode)
+{
+    platform.primitive = mode;
+    platform.verticesCount = 0;
+}
+
+void glEnd(void)
+{
+    // Vertices of an incomplete primitive are dropped, like OpenGL does
+    platform.primitive = -1;
+    platform.verticesCount = 0;
+}
+
+void glColor4ub(GLubyte red, GLubyte green, GLubyte blue, GLubyte alpha)
+{
+    platform.color = (Color){ red, green, blue, alpha };
+}
+
+void glColor4f(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+{
+    glColor4ub((GLubyte)(red*255.0f), (GLubyte)(green*255.0f), (GLubyte)(blue*255.0f), (GLubyte)(alpha*255.0f));
+}
+
+void glColor3f(GLfloat red, GLfloat green, GLfloat blue)
+{
+    glColor4f(red, green, blue, 1.0f);
+}
+
+void glTexCoord2f(GLfloat s, GLfloat t)
+{
+    platform.texcoord[0] = s;
+    platform.texcoord[1] = t;
+}
+
+void glNormal3f(GLfloat nx, GLfloat ny, GLfloat nz)
+{
+    // No lighting, normals are not needed
+}
+
+void glVertex3f(GLfloat x, GLfloat y, GLfloat z)
+{
+    if (platform.primitive < 0) return;
+
+    const float *mv = platform.matrixStack[0][platform.matrixTop[0]];
+    const float *p = platform.matrixStack[1][platform.matrixTop[1]];
+
+    // Eye space, then clip space
+    float eye[4] = { 0 };
+    float clip[4] = { 0 };
+    for (int row = 0; row < 4; row++) eye[row] = mv[row]*x + mv[4 + row]*y + mv[8 + row]*z + mv[12 + row];
+    for (int row = 0; row < 4; row++) clip[row] = p[row]*eye[0] + p[4 + row]*eye[1] + p[8 + row]*eye[2] + p[12 + row]*eye[3];
+    if (clip[3] == 0.0f) clip[3] = 1.0f;
+
+    // Normalized device coordinates to framebuffer pixels, flipped to top-left origin
+    float windowX = platform.viewport[0] + (clip[0]/clip[3] + 1.0f)*0.5f*platform.viewport[2];
+    float windowY = platform.viewport[1] + (clip[1]/clip[3] + 1.0f)*0.5f*platform.viewport[3];
+
+    SoftVertex *vertex = &platform.vertices[platform.verticesCount++];
+    vertex->x = windowX;
+    vertex->y = platform.framebuffer.height - windowY;
+    vertex->u = platform.texcoord[0];
+    vertex->v = platform.texcoord[1];
+    vertex->color = platform.color;
+
+    int verticesPerPrimitive = 0;
+    switch (platform.primitive)
+    {
+        case GL_LINES: verticesPerPrimitive = 2; break;
+        case GL_TRIANGLES: verticesPerPrimitive = 3; break;
+        case GL_QUADS: verticesPerPrimitive = 4; break;
+        default: break;
+    }
+
+    if (platform.verticesCount >= verticesPerPrimitive)
+    {
+        if (verticesPerPrimitive > 0) SoftDrawPrimitive();
+        platform.verticesCount = 0;
+    }
+}
+
+void glVertex2f(GLfloat x, GLfloat y)
+{
+    glVertex3f(x, y, 0.0f);
+}
+
+void glVertex2i(GLint x, GLint y)
+{
+    glVertex3f((float)x, (float)y, 0.0f);
+}
+
+void glGenTextures(GLsizei n, GLuint *textures)
+{
+    for (int i = 0; i < n; i++)
+    {
+        if (platform.texturesCount >= platform.texturesCapacity)
+        {
+            unsigned int capacity = (platform.texturesCapacity == 0)? 16 : platform.texturesCapacity*2;
+            platform.textures = (Image *)RL_REALLOC(platform.textures, capacity*sizeof(Image));
+            memset(platform.textures + platform.texturesCapacity, 0, (capacity - platform.texturesCapacity)*sizeof(Image));
+            platform.texturesCapacity = capacity;
+        }
+
+        textures[i] = platform.texturesCount++;
+    }
+}
+
+void glDeleteTextures(GLsizei n, const GLuint *textures)
+{
+    for (int i = 0; i < n; i++)
+    {
+        if ((textures[i] == 0) || (textures[i] >= platform.texturesCount)) continue;
+
+        RL_FREE(platform.textures[textures[i]].data);
+        platform.textures[textures[i]] = (Image){ 0 };
+        if (platform.textureBound == textures[i]) platform.textureBound = 0;
+    }
+}
+
+void glBindTexture(GLenum target, GLuint texture)
+{
+    if (target == GL_TEXTURE_2D) platform.textureBound = (texture < platform.texturesCount)? texture : 0;
+}
+
+// Get the raylib pixel format of OpenGL texture data
+static int SoftGetPixelFormat(GLenum format, GLenum type)
+{
+    if (type == GL_UNSIGNED_BYTE)
+    {
+        switch (format)
+        {
+            case GL_LUMINANCE: return PIXELFORMAT_UNCOMPRESSED_GRAYSCALE;
+            case GL_LUMINANCE_ALPHA: return PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA;
+            case GL_RGB: return PIXELFORMAT_UNCOMPRESSED_R8G8B8;
+            case GL_RGBA: return PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+            default: break;
+        }
+    }
+    else if (type == GL_FLOAT)
+    {
+        switch (format)
+        {
+            case GL_LUMINANCE: return PIXELFORMAT_UNCOMPRESSED_R32;
+            case GL_RGB: return PIXELFORMAT_UNCOMPRESSED_R32G32B32;
+            case GL_RGBA: return PIXELFORMAT_UNCOMPRESSED_R32G32B32A32;
+            default: break;
+        }
+    }
+    else if ((type == GL_UNSIGNED_SHORT_5_6_5) && (format == GL_RGB)) return PIXELFORMAT_UNCOMPRESSED_R5G6B5;
+    else if ((type == GL_UNSIGNED_SHORT_5_5_5_1) && (format == GL_RGBA)) return PIXELFORMAT_UNCOMPRESSED_R5G5B5A1;
+    else if ((type == GL_UNSIGNED_SHORT_4_4_4_4) && (format == GL_RGBA)) return PIXELFORMAT_UNCOMPRESSED_R4G4B4A4;
+
+    return 0;
+}
+
+void glTexImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid *pixels)
+{
+    // Mipmaps are never sampled, only the base level is kept
+    if ((target != GL_TEXTURE_2D) || (level != 0) || (platform.textureBound == 0)) return;
+
+    int pixelFormat = SoftGetPixelFormat(format, type);
+    if (pixelFormat == 0)
+    {
+        TRACELOG(LOG_WARNING, "GL: Texture format not supported by the software rasterizer");
+        return;
+    }
+
+    Image *texture = &platform.textures[platform.textureBound];
+    RL_FREE(texture->data);
+
+    int size = GetPixelDataSize(width, height, pixelFormat);
+    texture->data = RL_CALLOC(size, 1);
+    texture->width = width;
+    texture->height = height;
+    texture->mipmaps = 1;
+    texture->format = pixelFormat;
+    if (pixels != NULL) memcpy(texture->data, pixels, size);
+}
+
+void glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const GLvoid *pixels)
+{
+    if ((target != GL_TEXTURE_2D) || (level != 0) || (platform.textureBound == 0)) return;
+
+    Image *texture = &platform.textures[platform.textureBound];
+    if ((texture->data == NULL) || (SoftGetPixelFormat(format, type) != texture->format)) return;
+    if ((xoffset < 0) || (yoffset < 0) || ((xoffset + width) > texture->width) || ((yoffset + height) > texture->height)) return;
+
+    int bytesPerPixel = GetPixelDataSize(1, 1, texture->format);
+    for (int row = 0; row < height; row++)
+    {
+        unsigned char *dst = (unsigned char *)texture->data + ((yoffset + row)*texture->width + xoffset)*bytesPerPixel;
+        memcpy(dst, (const unsigned char *)pixels + row*width*bytesPerPixel, width*bytesPerPixel);
+    }
+}
+
+void glGetTexImage(GLenum target, GLint level, GLenum format, GLenum type, GLvoid *pixels)
+{
+    if ((target != GL_TEXTURE_2D) || (level != 0) || (platform.textureBound == 0)) return;
+
+    Image *texture = &platform.textures[platform.textureBound];
+    if ((texture->data == NULL) || (SoftGetPixelFormat(format, type) != texture->format)) return;
+
+    memcpy(pixels, texture->data, GetPixelDataSize(texture->width, texture->height, texture->format));
+}
+
+// Vertex arrays are only used by rlDrawMesh(), meshes are not rasterized
+void glDrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+    if (!platform.meshWarned) TRACELOG(LOG_WARNING, "GL: Meshes are not drawn by the software rasterizer");
+    platform.meshWarned = true;
+}
+
+void glDrawElements(GLenum mode, GLsizei count, GLenum type, const GLvoid *indices)
+{
+    glDrawArrays(mode, 0, count);
+}
+
+// State the software rasterizer has no use for
+void glBlendFunc(GLenum sfactor, GLenum dfactor) { }
+void glClearDepth(GLclampd depth) { }
+void glCullFace(GLenum mode) { }
+void glFrontFace(GLenum mode) { }
+void glDepthFunc(GLenum func) { }
+void glDepthMask(GLboolean flag) { }
+void glHint(GLenum target, GLenum mode) { }
+void glShadeModel(GLenum mode) { }
+void glLineWidth(GLfloat width) { }
+void glPolygonMode(GLenum face, GLenum mode) { }
+void glPixelStorei(GLenum pname, GLint param) { }
+void glTexParameteri(GLenum target, GLenum pname, GLint param) { }
+void glEnableClientState(GLenum cap) { }
+void glDisableClientState(GLenum cap) { }
+void glVertexPointer(GLint size, GLenum type, GLsizei stride, const GLvoid *ptr) { }
+void glTexCoordPointer(GLint size, GLenum type, GLsizei stride, const GLvoid *ptr) { }
+void glNormalPointer(GLenum type, GLsizei stride, const GLvoid *ptr) { }
+void glColorPointer(GLint size, GLenum type, GLsizei stride, const GLvoid *ptr) { }
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions Definition
+//----------------------------------------------------------------------------------
+
+// Initialize platform: graphics, inputs and more
+int InitPlatform(void)
+{
+    // The screen is whatever size was asked for, there is no display to fit
+    if ((CORE.Window.screen.width <= 0) || (CORE.Window.screen.height <= 0))
+    {
+        TRACELOG(LOG_WARNING, "DISPLAY: Headless framebuffer requires a size");
+        return -1;
+    }
+
+    CORE.Window.display.width = CORE.Window.screen.width;
+    CORE.Window.display.height = CORE.Window.screen.height;
+    CORE.Window.render.width = CORE.Window.screen.width;
+    CORE.Window.render.height = CORE.Window.screen.height;
+    CORE.Window.currentFbo.width = CORE.Window.render.width;
+    CORE.Window.currentFbo.height = CORE.Window.render.height;
+
+    platform.framebuffer = GenImageColor(CORE.Window.render.width, CORE.Window.render.height, BLANK);
+    if (platform.framebuffer.data == NULL)
+    {
+        TRACELOG(LOG_FATAL, "PLATFORM: Failed to allocate headless framebuffer");
+        return -1;
+    }
+
+    // Same initial state as an OpenGL 1.1 context
+    for (int i = 0; i < 3; i++)
+    {
+        platform.matrixMode = i;
+        glLoadIdentity();
+    }
+    platform.matrixMode = 0;
+    platform.primitive = -1;
+    platform.color = WHITE;
+    platform.texturesCount = 1;     // Texture id 0 means no texture
+    glViewport(0, 0, CORE.Window.render.width, CORE.Window.render.height);
+    glScissor(0, 0, CORE.Window.render.width, CORE.Window.render.height);
+
+    CORE.Window.ready = true;
+
+    TRACELOG(LOG_INFO, "DISPLAY: Headless framebuffer initialized successfully");
+    TRACELOG(LOG_INFO, "    > Screen size:  %i x %i", CORE.Window.screen.width, CORE.Window.screen.height);
+    TRACELOG(LOG_INFO, "    > Render size:  %i x %i", CORE.Window.render.width, CORE.Window.render.height);
+
+    // Nothing to load, the OpenGL 1.1 functions are the ones above
+    rlLoadExtensions(NULL);
+
+    InitTimer();
+
+    CORE.Storage.basePath = GetWorkingDirectory();
+
+    TRACELOG(LOG_INFO, "PLATFORM: HEADLESS: Initialized successfully");
+
+    return 0;
+}
+
+// Close platform
+void ClosePlatform(void)
+{
+    for (unsigned int i = 1; i < platform.texturesCount; i++) RL_FREE(platform.textures[i].data);
+    RL_FREE(platform.textures);
+    UnloadImage(platform.framebuffer);
+
+    platform = (PlatformData){ 0 };
+}
+
+// Get current matrix of the selected stack
+static float *SoftGetMatrix(void)
+{
+    return platform.matrixStack[platform.matrixMode][platform.matrixTop[platform.matrixMode]];
+}
+
+// Multiply current matrix by mat, both column-major: current = current*mat
+static void SoftMultMatrix(const float *mat)
+{
+    float *current = SoftGetMatrix();
+    float result[16] = { 0 };
+
+    for (int col = 0; col < 4; col++)
+    {
+        for (int row = 0; row < 4; row++)
+        {
+            result[col*4 + row] = current[row]*mat[col*4] + current[4 + row]*mat[col*4 + 1] +
+                                  current[8 + row]*mat[col*4 + 2] + current[12 + row]*mat[col*4 + 3];
+        }
+    }
+
+    memcpy(current, result, 16*sizeof(float));
+}
+
+// Rasterize the primitive in platform.vertices
+static void SoftDrawPrimitive(void)
+{
+    const SoftVertex *v = platform.vertices;
+
+    switch (platform.primitive)
+    {
+        case GL_LINES: SoftDrawLine(v[0], v[1]); break;
+        case GL_TRIANGLES: SoftDrawTriangle(v[0], v[1], v[2]); break;
+        case GL_QUADS:
+        {
+            if (!SoftDrawQuadAligned(v))
+            {
+                SoftDrawTriangle(v[0], v[1], v[2]);
+                SoftDrawTriangle(v[0], v[2], v[3]);
+            }
+        } break;
+        default: break;
+    }
+}
+
+// Draw axis-aligned quad without going through triangles, false if it has to be rasterized as triangles
+// NOTE: Expects rshapes/rtext vertex order: top-left, bottom-left, bottom-right, top-right
+static bool SoftDrawQuadAligned(const SoftVertex *v)
+{
+    if (platform.scissorEnabled) return false;
+
+    // Same color on every vertex and not flipped nor rotated, in space and in texture
+    if ((memcmp(&v[0].color, &v[1].color, sizeof(Color)) != 0) ||
+        (memcmp(&v[0].color, &v[2].color, sizeof(Color)) != 0) ||
+        (memcmp(&v[0].color, &v[3].color, sizeof(Color)) != 0)) return false;
+    if ((v[0].x != v[1].x) || (v[2].x != v[3].x) || (v[0].y != v[3].y) || (v[1].y != v[2].y)) return false;
+    if ((v[0].u != v[1].u) || (v[2].u != v[3].u) || (v[0].v != v[3].v) || (v[1].v != v[2].v)) return false;
+    if ((v[0].x > v[2].x) || (v[0].y > v[1].y) || (v[0].u > v[2].u) || (v[0].v > v[1].v)) return false;
+
+    Rectangle dstRec = { v[0].x, v[0].y, v[2].x - v[0].x, v[1].y - v[0].y };
+    Color color = v[0].color;
+
+    const Image *texture = platform.textureEnabled? &platform.textures[platform.textureBound] : NULL;
+    if ((texture != NULL) && (texture->data == NULL)) texture = NULL;
+
+    if (texture != NULL)
+    {
+        Rectangle srcRec = { v[0].u*texture->width, v[0].v*texture->height, (v[2].u - v[0].u)*texture->width, (v[1].v - v[0].v)*texture->height };
+
+        // A single texel stretched over the quad, like the white pixel used for shapes
+        if ((srcRec.width <= 1.0f) && (srcRec.height <= 1.0f)) color = ColorTint(SoftSampleTexture(v[0].u, v[0].v), color);
+        else
+        {
+            SoftDrawTextureRec(texture, srcRec, dstRec, color);
+            return true;
+        }
+    }
+
+    // Filled rectangles are only overwritten when opaque, the triangle path blends
+    if (color.a == 0) return true;
+    if (color.a < 255) return false;
+
+    ImageDrawRectangleRec(&platform.framebuffer, dstRec, color);
+    return true;
+}
+
+// Get bound texture texel (nearest, repeat), white if no texture is enabled
+static Color SoftSampleTexture(float u, float v)
+{
+    const Image *texture = platform.textureEnabled? &platform.textures[platform.textureBound] : NULL;
+    if ((texture == NULL) || (texture->data == NULL)) return WHITE;
+
+    int x = (int)floorf(u*texture->width)%texture->width;
+    int y = (int)floorf(v*texture->height)%texture->height;
+    if (x < 0) x += texture->width;
+    if (y < 0) y += texture->height;
+
+    return GetImageColor(*texture, x, y);
+}
+
+// Draw srcRec of texture stretched over dstRec, bilinear and blended over the framebuffer
+// NOTE: Texels are read in place, ImageDraw() would allocate a cropped and a resized copy for every quad,
+// samples are clamped to srcRec so glyphs don't pick up their neighbors in the atlas
+static void SoftDrawTextureRec(const Image *texture, Rectangle srcRec, Rectangle dstRec, Color tint)
+{
+    Image *fb = &platform.framebuffer;
+    Color *pixels = (Color *)fb->data;
+
+    // Pixels with their center inside dstRec, same rule as the triangles
+    int minX = (int)ceilf(dstRec.x - 0.5f);
+    int minY = (int)ceilf(dstRec.y - 0.5f);
+    int maxX = (int)ceilf(dstRec.x + dstRec.width - 0.5f);
+    int maxY = (int)ceilf(dstRec.y + dstRec.height - 0.5f);
+    if (minX < 0) minX = 0;
+    if (minY < 0) minY = 0;
+    if (maxX > fb->width) maxX = fb->width;
+    if (maxY > fb->height) maxY = fb->height;
+    if ((minX >= maxX) || (minY >= maxY) || (dstRec.width <= 0.0f) || (dstRec.height <= 0.0f)) return;
+
+    // Texels that can be sampled
+    int srcMinX = (int)floorf(srcRec.x);
+    int srcMinY = (int)floorf(srcRec.y);
+    int srcMaxX = (int)ceilf(srcRec.x + srcRec.width) - 1;
+    int srcMaxY = (int)ceilf(srcRec.y + srcRec.height) - 1;
+    if (srcMinX < 0) srcMinX = 0;
+    if (srcMinY < 0) srcMinY = 0;
+    if (srcMaxX > texture->width - 1) srcMaxX = texture->width - 1;
+    if (srcMaxY > texture->height - 1) srcMaxY = texture->height - 1;
+    if ((srcMinX > srcMaxX) || (srcMinY > srcMaxY)) return;
+
+    float scaleX = srcRec.width/dstRec.width;
+    float scaleY = srcRec.height/dstRec.height;
+
+    for (int y = minY; y < maxY; y++)
+    {
+        // Texel centers are at +0.5, like GL_LINEAR
+        float v = srcRec.y + (y + 0.5f - dstRec.y)*scaleY - 0.5f;
+        int y0 = (int)floorf(v);
+        float ty = v - y0;
+        int y1 = y0 + 1;
+        if (y0 < srcMinY) y0 = srcMinY;
+        if (y1 < srcMinY) y1 = srcMinY;
+        if (y0 > srcMaxY) y0 = srcMaxY;
+        if (y1 > srcMaxY) y1 = srcMaxY;
+
+        for (int x = minX; x < maxX; x++)
+        {
+            float u = srcRec.x + (x + 0.5f - dstRec.x)*scaleX - 0.5f;
+            int x0 = (int)floorf(u);
+            float tx = u - x0;
+            int x1 = x0 + 1;
+            if (x0 < srcMinX) x0 = srcMinX;
+            if (x1 < srcMinX) x1 = srcMinX;
+            if (x0 > srcMaxX) x0 = srcMaxX;
+            if (x1 > srcMaxX) x1 = srcMaxX;
+
+            Color c00 = SoftGetTexel(texture, x0, y0);
+            Color c10 = SoftGetTexel(texture, x1, y0);
+            Color c01 = SoftGetTexel(texture, x0, y1);
+            Color c11 = SoftGetTexel(texture, x1, y1);
+
+            // Most of a glyph quad is empty
+            if ((c00.a | c10.a | c01.a | c11.a) == 0) continue;
+
+            float w00 = (1.0f - tx)*(1.0f - ty);
+            float w10 = tx*(1.0f - ty);
+            float w01 = (1.0f - tx)*ty;
+            float w11 = tx*ty;
+
+            Color texel = {
+                (unsigned char)(w00*c00.r + w10*c10.r + w01*c01.r + w11*c11.r + 0.5f),
+                (unsigned char)(w00*c00.g + w10*c10.g + w01*c01.g + w11*c11.g + 0.5f),
+                (unsigned char)(w00*c00.b + w10*c10.b + w01*c01.b + w11*c11.b + 0.5f),
+                (unsigned char)(w00*c00.a + w10*c10.a + w01*c01.a + w11*c11.a + 0.5f)
+            };
+
+            Color *dst = &pixels[y*fb->width + x];
+            *dst = ColorAlphaBlend(*dst, texel, tint);
+        }
+    }
+}
+
+// Get texel at x, y, which must be inside the texture
+static inline Color SoftGetTexel(const Image *texture, int x, int y)
+{
+    const unsigned char *data = (const unsigned char *)texture->data;
+
+    switch (texture->format)
+    {
+        case PIXELFORMAT_UNCOMPRESSED_R8G8B8A8: return ((const Color *)data)[y*texture->width + x];
+        case PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA:
+        {
+            const unsigned char *texel = data + (y*texture->width + x)*2;
+            return (Color){ texel[0], texel[0], texel[0], texel[1] };
+        }
+        default: return GetImageColor(*texture, x, y);
+    }
+}
+
+// Rasterize triangle at pixel centers, blended over the framebuffer
+// NOTE: Pixels exactly on an edge shared by two triangles are only drawn once (top-left rule)
+static void SoftDrawTriangle(SoftVertex a, SoftVertex b, SoftVertex c)
+{
+    float area = (b.x - a.x)*(c.y - a.y) - (b.y - a.y)*(c.x - a.x);
+    if (area == 0.0f) return;
+    if (area < 0.0f)
+    {
+        SoftVertex temp = b;
+        b = c;
+        c = temp;
+        area = -area;
+    }
+
+    Image *fb = &platform.framebuffer;
+
+    // Bounding box, clipped to the framebuffer and the scissor rectangle
+    int minX = (int)floorf(fminf(a.x, fminf(b.x, c.x)));
+    int minY = (int)floorf(fminf(a.y, fminf(b.y, c.y)));
+    int maxX = (int)ceilf(fmaxf(a.x, fmaxf(b.x, c.x)));
+    int maxY = (int)ceilf(fmaxf(a.y, fmaxf(b.y, c.y)));
+
+    int clipX0, clipY0, clipX1, clipY1;
+    SoftGetClipRect(&clipX0, &clipY0, &clipX1, &clipY1);
+    if (minX < clipX0) minX = clipX0;
+    if (minY < clipY0) minY = clipY0;
+    if (maxX > clipX1) maxX = clipX1;
+    if (maxY > clipY1) maxY = clipY1;
+
+    const SoftVertex *edges[3][2] = { { &b, &c }, { &c, &a }, { &a, &b } };
+    bool inclusive[3] = { 0 };
+    for (int i = 0; i < 3; i++)
+    {
+        float dx = edges[i][1]->x - edges[i][0]->x;
+        float dy = edges[i][1]->y - edges[i][0]->y;
+        inclusive[i] = (dy > 0.0f) || ((dy == 0.0f) && (dx < 0.0f));
+    }
+
+    bool textured = platform.textureEnabled && (platform.textures[platform.textureBound].data != NULL);
+    Color *pixels = (Color *)fb->data;
+
+    for (int y = minY; y < maxY; y++)
+    {
+        for (int x = minX; x < maxX; x++)
+        {
+            float px = x + 0.5f;
+            float py = y + 0.5f;
+
+            // Barycentric weights of a, b and c
+            float w[3] = { 0 };
+            bool inside = true;
+            for (int i = 0; (i < 3) && inside; i++)
+            {
+                const SoftVertex *p0 = edges[i][0];
+                const SoftVertex *p1 = edges[i][1];
+                w[i] = ((p1->x - p0->x)*(py - p0->y) - (p1->y - p0->y)*(px - p0->x))/area;
+                inside = (w[i] > 0.0f) || ((w[i] == 0.0f) && inclusive[i]);
+            }
+            if (!inside) continue;
+
+            Color color = {
+                (unsigned char)(w[0]*a.color.r + w[1]*b.color.r + w[2]*c.color.r),
+                (unsigned char)(w[0]*a.color.g + w[1]*b.color.g + w[2]*c.color.g),
+                (unsigned char)(w[0]*a.color.b + w[1]*b.color.b + w[2]*c.color.b),
+                (unsigned char)(w[0]*a.color.a + w[1]*b.color.a + w[2]*c.color.a)
+            };
+            Color texel = textured? SoftSampleTexture(w[0]*a.u + w[1]*b.u + w[2]*c.u, w[0]*a.v + w[1]*b.v + w[2]*c.v) : WHITE;
+
+            Color *dst = &pixels[y*fb->width + x];
+            *dst = ColorAlphaBlend(*dst, texel, color);
+        }
+    }
+}
+
+// Rasterize line, endpoints are snapped to the pixel they fall in
+// NOTE: rshapes puts line vertices on the far corner of the pixel they are meant to cover,
+// pixels are the ones ImageDrawLine() would draw, minus the ones outside the clip rectangle
+static void SoftDrawLine(SoftVertex a, SoftVertex b)
+{
+    int x0 = (int)floorf(a.x - 0.5f);
+    int y0 = (int)floorf(a.y - 0.5f);
+    int x1 = (int)floorf(b.x - 0.5f);
+    int y1 = (int)floorf(b.y - 0.5f);
+
+    // Walk the major axis (u) in increasing order, the minor axis (v) follows by Bresenham
+    bool steep = abs(y1 - y0) >= abs(x1 - x0);
+    int u0 = steep? y0 : x0, v0 = steep? x0 : y0;
+    int u1 = steep? y1 : x1, v1 = steep? x1 : y1;
+    if (u0 > u1)
+    {
+        int temp = u0; u0 = u1; u1 = temp;
+        temp = v0; v0 = v1; v1 = temp;
+    }
+
+    int du = u1 - u0;
+    int dv = abs(v1 - v0);
+    int stepV = (v1 < v0)? -1 : 1;
+    int A = 2*dv, B = A - 2*du, P = A - du;
+
+    int clipX0, clipY0, clipX1, clipY1;
+    SoftGetClipRect(&clipX0, &clipY0, &clipX1, &clipY1);
+
+    Image *fb = &platform.framebuffer;
+    Color *pixels = (Color *)fb->data;
+
+    for (int u = u0, v = v0; u <= u1; u++)
+    {
+        int x = steep? v : u;
+        int y = steep? u : v;
+        if ((x >= clipX0) && (x < clipX1) && (y >= clipY0) && (y < clipY1)) pixels[y*fb->width + x] = a.color;
+
+        if (P >= 0)
+        {
+            v += stepV;
+            P += B;
+        }
+        else P += A;
+    }
+}
+
+// Get pixels that can be drawn: the framebuffer, and the scissor rectangle (flipped to top-left origin) when enabled
+static void SoftGetClipRect(int *x0, int *y0, int *x1, int *y1)
+{
+    Image *fb = &platform.framebuffer;
+
+    *x0 = 0;
+    *y0 = 0;
+    *x1 = fb->width;
+    *y1 = fb->height;
+
+    if (platform.scissorEnabled)
+    {
+        int scissorY0 = fb->height - (platform.scissor[1] + platform.scissor[3]);
+        int scissorY1 = fb->height - platform.scissor[1];
+
+        if (platform.scissor[0] > *x0) *x0 = platform.scissor[0];
+        if (platform.scissor[0] + platform.scissor[2] < *x1) *x1 = platform.scissor[0] + platform.scissor[2];
+        if (scissorY0 > *y0) *y0 = scissorY0;
+        if (scissorY1 < *y1) *y1 = scissorY1;
+    }
+}
+
+// EOF
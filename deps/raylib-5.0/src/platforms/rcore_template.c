@@ -384,6 +384,14 @@ void SetMouseCursor(int cursor)
     TRACELOG(LOG_WARNING, "SetMouseCursor() not implemented on target platform");
 }
 
+// Poll platform events again without starting a new input frame
+// NOTE: A port drains the keyboard events that arrived since PollInputEvents() and queues them with
+// PushInputEvent(), everything else stays for the next PollInputEvents(). Platforms that queue
+// events as they arrive (event threads, browser callbacks) have nothing to do here
+void LatchInputEvents(void)
+{
+}
+
 // Register all input events
 void PollInputEvents(void)
 {
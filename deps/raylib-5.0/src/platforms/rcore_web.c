@@ -547,6 +547,13 @@ void SetMouseCursor(int cursor)
     }
 }
 
+// Poll platform events again without starting a new input frame
+// NOTE: Browser events are dispatched by the runtime as they arrive, they are already queued
+void LatchInputEvents(void)
+{
+    // Nothing to do
+}
+
 // Register all input events
 void PollInputEvents(void)
 {
@@ -1064,6 +1071,10 @@ static void KeyCallback(GLFWwindow *window, int key, int scancode, int action, i
         CORE.Input.Keyboard.keyPressedQueueCount++;
     }
 
+    if (action == GLFW_RELEASE) PushInputEvent(INPUT_EVENT_KEY_RELEASED, key);
+    else if (action == GLFW_PRESS) PushInputEvent(INPUT_EVENT_KEY_PRESSED, key);
+    else if (action == GLFW_REPEAT) PushInputEvent(INPUT_EVENT_KEY_REPEAT, key);
+
     // Check the exit key to set close window
     if ((key == CORE.Input.Keyboard.exitKey) && (action == GLFW_PRESS)) glfwSetWindowShouldClose(platform.handle, GLFW_TRUE);
 }
@@ -1085,6 +1096,7 @@ static void CharCallback(GLFWwindow *window, unsigned int key)
         CORE.Input.Keyboard.charPressedQueue[CORE.Input.Keyboard.charPressedQueueCount] = key;
         CORE.Input.Keyboard.charPressedQueueCount++;
     }
+    PushInputEvent(INPUT_EVENT_CHAR, key);
 }
 
 // GLFW3 Mouse Button Callback, runs on mouse button pressed
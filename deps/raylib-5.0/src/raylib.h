@@ -118,6 +118,13 @@
 
 // Allow custom memory allocators
 // NOTE: Require recompiling raylib sources
+#if defined(RL_MEMORY_CALLBACKS)
+    // Route every internal allocation through the callbacks set by SetMemoryCallbacks()
+    #define RL_MALLOC(sz)       MemAllocAt(sz, __FILE__, __LINE__)
+    #define RL_CALLOC(n,sz)     MemCallocAt(n, sz, __FILE__, __LINE__)
+    #define RL_REALLOC(ptr,sz)  MemReallocAt(ptr, sz, __FILE__, __LINE__)
+    #define RL_FREE(ptr)        MemFreeAt(ptr, __FILE__, __LINE__)
+#endif
 #ifndef RL_MALLOC
     #define RL_MALLOC(sz)       malloc(sz)
 #endif
@@ -520,6 +527,13 @@ typedef struct AutomationEventList {
     AutomationEvent *events;        // Events entries
 } AutomationEventList;
 
+// Input event, timestamped when the platform layer received it
+typedef struct InputEvent {
+    int type;                       // Event type (InputEventType)
+    int value;                      // Key code for key events, unicode codepoint for char events
+    double time;                    // Time the event was received, same clock as GetTime()
+} InputEvent;
+
 //----------------------------------------------------------------------------------
 // Enumerators Definition
 //----------------------------------------------------------------------------------
@@ -678,6 +692,14 @@ typedef enum {
     KEY_VOLUME_DOWN     = 25        // Key: Android volume down button
 } KeyboardKey;
 
+// Input event types
+typedef enum {
+    INPUT_EVENT_KEY_PRESSED = 0,    // Key went down (value: KeyboardKey)
+    INPUT_EVENT_KEY_RELEASED,       // Key went up (value: KeyboardKey)
+    INPUT_EVENT_KEY_REPEAT,         // Key held down long enough to repeat (value: KeyboardKey)
+    INPUT_EVENT_CHAR                // Character typed (value: unicode codepoint)
+} InputEventType;
+
 // Add backwards compatibility support for deprecated names
 #define MOUSE_LEFT_BUTTON   MOUSE_BUTTON_LEFT
 #define MOUSE_RIGHT_BUTTON  MOUSE_BUTTON_RIGHT
@@ -936,6 +958,9 @@ typedef unsigned char *(*LoadFileDataCallback)(const char *fileName, int *dataSi
 typedef bool (*SaveFileDataCallback)(const char *fileName, void *data, int dataSize);   // FileIO: Save binary data
 typedef char *(*LoadFileTextCallback)(const char *fileName);            // FileIO: Load text data
 typedef bool (*SaveFileTextCallback)(const char *fileName, char *text); // FileIO: Save text data
+typedef void *(*MemAllocCallback)(unsigned int size, const char *file, int line);              // Memory: Allocate
+typedef void *(*MemReallocCallback)(void *ptr, unsigned int size, const char *file, int line); // Memory: Reallocate
+typedef void (*MemFreeCallback)(void *ptr, const char *file, int line);                        // Memory: Free
 
 //------------------------------------------------------------------------------------
 // Global Variables Definition
@@ -1058,6 +1083,8 @@ RLAPI void SetTargetFPS(int fps);                                 // Set target
 RLAPI float GetFrameTime(void);                                   // Get time in seconds for last frame drawn (delta time)
 RLAPI double GetTime(void);                                       // Get elapsed time in seconds since InitWindow()
 RLAPI int GetFPS(void);                                           // Get current FPS
+RLAPI double GetFramePacingError(void);                           // Get how late (positive) or early the last frame wait ended, in seconds
+RLAPI double GetFrameSwapTime(void);                               // Get time the last frame was handed to the display (after SwapScreenBuffer())
 
 // Custom frame control functions
 // NOTE: Those functions are intended for advance users that want full control over the frame processing
@@ -1065,6 +1092,7 @@ RLAPI int GetFPS(void);                                           // Get current
 // To avoid that behaviour and control frame processes manually, enable in config.h: SUPPORT_CUSTOM_FRAME_CONTROL
 RLAPI void SwapScreenBuffer(void);                                // Swap back buffer with front buffer (screen drawing)
 RLAPI void PollInputEvents(void);                                 // Register all input events
+RLAPI void LatchInputEvents(void);                                // Poll platform events again mid-frame, new input is only queued for GetInputEvent()
 RLAPI void WaitTime(double seconds);                              // Wait for some time (halt program execution)
 
 // Random values generation functions
@@ -1075,6 +1103,7 @@ RLAPI void UnloadRandomSequence(int *sequence);                   // Unload rand
 
 // Misc. functions
 RLAPI void TakeScreenshot(const char *fileName);                  // Takes a screenshot of current screen (filename extension defines format)
+RLAPI unsigned int GetCaptureFramesDropped(void);                 // Get number of gif frames dropped because encoding fell behind
 RLAPI void SetConfigFlags(unsigned int flags);                    // Setup init configuration flags (view FLAGS)
 RLAPI void OpenURL(const char *url);                              // Open URL with default system browser (if available)
 
@@ -1085,6 +1114,12 @@ RLAPI void SetTraceLogLevel(int logLevel);                        // Set the cur
 RLAPI void *MemAlloc(unsigned int size);                          // Internal memory allocator
 RLAPI void *MemRealloc(void *ptr, unsigned int size);             // Internal memory reallocator
 RLAPI void MemFree(void *ptr);                                    // Internal memory free
+#if defined(RL_MEMORY_CALLBACKS)
+RLAPI void *MemAllocAt(unsigned int size, const char *file, int line);             // Internal allocation through memory callbacks
+RLAPI void *MemCallocAt(unsigned int count, unsigned int size, const char *file, int line); // Internal zeroed allocation through memory callbacks
+RLAPI void *MemReallocAt(void *ptr, unsigned int size, const char *file, int line); // Internal reallocation through memory callbacks
+RLAPI void MemFreeAt(void *ptr, const char *file, int line);                      // Internal free through memory callbacks
+#endif
 
 // Set custom callbacks
 // WARNING: Callbacks setup is intended for advance users
@@ -1093,6 +1128,7 @@ RLAPI void SetLoadFileDataCallback(LoadFileDataCallback callback); // Set custom
 RLAPI void SetSaveFileDataCallback(SaveFileDataCallback callback); // Set custom file binary data saver
 RLAPI void SetLoadFileTextCallback(LoadFileTextCallback callback); // Set custom file text data loader
 RLAPI void SetSaveFileTextCallback(SaveFileTextCallback callback); // Set custom file text data saver
+RLAPI void SetMemoryCallbacks(MemAllocCallback allocCallback, MemReallocCallback reallocCallback, MemFreeCallback freeCallback); // Set custom memory allocator, call before any raylib allocation (requires RL_MEMORY_CALLBACKS)
 
 // Files management functions
 RLAPI unsigned char *LoadFileData(const char *fileName, int *dataSize); // Load file data as byte array (read)
@@ -1155,6 +1191,8 @@ RLAPI bool IsKeyUp(int key);                                  // Check if a key
 RLAPI int GetKeyPressed(void);                                // Get key pressed (keycode), call it multiple times for keys queued, returns 0 when the queue is empty
 RLAPI int GetCharPressed(void);                               // Get char pressed (unicode), call it multiple times for chars queued, returns 0 when the queue is empty
 RLAPI void SetExitKey(int key);                               // Set a custom key to exit program (default is ESC)
+RLAPI bool GetInputEvent(InputEvent *event);                  // Get oldest queued input event in arrival order, returns false when the queue is empty
+RLAPI unsigned int GetInputEventsDropped(void);               // Get number of input events dropped because the queue was full
 
 // Input-related functions: gamepads
 RLAPI bool IsGamepadAvailable(int gamepad);                   // Check if a gamepad is available
@@ -19,6 +19,8 @@
 *           - Linux DRM subsystem (KMS mode)
 *       > PLATFORM_ANDROID:
 *           - Android (ARM, ARM64)
+*       > PLATFORM_HEADLESS (software rasterizer, requires GRAPHICS_API_OPENGL_11):
+*           - Any system, no display or GPU required
 *
 *   CONFIGURATION:
 *       #define SUPPORT_DEFAULT_FONT (default)
@@ -41,12 +43,20 @@
 *       #define SUPPORT_PARTIALBUSY_WAIT_LOOP
 *           Use a partial-busy wait loop, in this case frame sleeps for most of the time and runs a busy-wait-loop at the end
 *
+*       #define SUPPORT_PRECISE_FRAME_PACING
+*           Frames end on a fixed grid of absolute deadlines, reached with clock_nanosleep(TIMER_ABSTIME) (Linux/FreeBSD)
+*           followed by a short busy wait that adapts to the measured wakeup jitter, see GetFramePacingError()
+*
 *       #define SUPPORT_SCREEN_CAPTURE
 *           Allow automatic screen capture of current screen pressing F12, defined in KeyCallback()
 *
 *       #define SUPPORT_GIF_RECORDING
 *           Allow automatic gif recording of current screen pressing CTRL+F12, defined in KeyCallback()
 *
+*       #define SUPPORT_ASYNC_CAPTURE
+*           Screenshots and gif frames are read back through double-buffered pixel pack buffers and encoded
+*           on a worker thread, gif frames are dropped when the worker falls behind, see GetCaptureFramesDropped()
+*
 *       #define SUPPORT_COMPRESSION_API
 *           Support CompressData() and DecompressData() functions, those functions use zlib implementation
 *           provided by stb_image and stb_image_write libraries, so, those libraries must be enabled on textures module
@@ -96,6 +106,14 @@
 #include <string.h>                 // Required for: strrchr(), strcmp(), strlen(), memset()
 #include <time.h>                   // Required for: time() [Used in InitTimer()]
 #include <math.h>                   // Required for: tan() [Used in BeginMode3D()], atan2f() [Used in LoadVrStereoConfig()]
+#include <errno.h>                  // Required for: EINTR [Used in WaitUntil()]
+
+#if !defined(__STDC_NO_ATOMICS__)
+    #include <stdatomic.h>          // Required for: atomic_uint [Used by input events queue]
+    typedef atomic_uint QueueIndex;
+#else
+    typedef volatile unsigned int QueueIndex;   // Without C11 atomics the queue must be filled from the main thread
+#endif
 
 #define RLGL_IMPLEMENTATION
 #include "rlgl.h"                   // OpenGL abstraction layer to OpenGL 1.1, 3.3+ or ES2
@@ -122,6 +140,14 @@
     #include "external/msf_gif.h"   // GIF recording functionality
 #endif
 
+#if defined(SUPPORT_ASYNC_CAPTURE) && defined(_WIN32)
+    #undef SUPPORT_ASYNC_CAPTURE    // Capture worker uses pthreads, captures stay synchronous on Windows
+#endif
+
+#if defined(SUPPORT_ASYNC_CAPTURE)
+    #include <pthread.h>            // Required for: pthread_create(), pthread_mutex_lock() [Used by capture worker]
+#endif
+
 #if defined(SUPPORT_COMPRESSION_API)
     #define SINFL_IMPLEMENTATION
     #define SINFL_NO_SIMD
@@ -220,6 +246,16 @@ __declspec(dllimport) int __stdcall WideCharToMultiByte(unsigned int cp, unsigne
 #ifndef MAX_CHAR_PRESSED_QUEUE
     #define MAX_CHAR_PRESSED_QUEUE        16        // Maximum number of characters in the char input queue
 #endif
+#ifndef MAX_INPUT_EVENT_QUEUE
+    #define MAX_INPUT_EVENT_QUEUE       1024        // Maximum number of timestamped input events queued (power of two)
+#endif
+#if (MAX_INPUT_EVENT_QUEUE & (MAX_INPUT_EVENT_QUEUE - 1)) != 0
+    #error "MAX_INPUT_EVENT_QUEUE must be a power of two"
+#endif
+
+#ifndef MAX_CAPTURE_QUEUE
+    #define MAX_CAPTURE_QUEUE              4        // Maximum number of captures waiting for the capture worker
+#endif
 
 #ifndef MAX_DECOMPRESSION_SIZE
     #define MAX_DECOMPRESSION_SIZE        64        // Maximum size allocated for decompression in MB
@@ -229,6 +265,16 @@ __declspec(dllimport) int __stdcall WideCharToMultiByte(unsigned int cp, unsigne
     #define MAX_AUTOMATION_EVENTS      16384        // Maximum number of automation events to record
 #endif
 
+#ifndef FRAME_PACING_MIN_SPIN
+    #define FRAME_PACING_MIN_SPIN    0.00005        // Minimum busy wait before a deadline, in seconds
+#endif
+#ifndef FRAME_PACING_MAX_SPIN
+    #define FRAME_PACING_MAX_SPIN      0.002        // Maximum busy wait before a deadline, in seconds
+#endif
+#ifndef FRAME_PACING_JITTER_DECAY
+    #define FRAME_PACING_JITTER_DECAY   0.98        // How fast the worst measured wakeup delay is forgotten, per wait
+#endif
+
 // Flags operation macros
 #define FLAG_SET(n, f) ((n) |= (f))
 #define FLAG_CLEAR(n, f) ((n) &= ~(f))
@@ -293,6 +339,13 @@ typedef struct CoreData {
             int charPressedQueue[MAX_CHAR_PRESSED_QUEUE]; // Input characters queue (unicode)
             int charPressedQueueCount;      // Input characters queue count
 
+            // NOTE: Events queue is not reset every frame, events stay until GetInputEvent() reads them,
+            // it is lock-free for one producer (platform layer, may be an input thread) and one consumer
+            InputEvent eventQueue[MAX_INPUT_EVENT_QUEUE]; // Timestamped input events queue (ring buffer)
+            QueueIndex eventQueueHead;      // Input events written, only moved by PushInputEvent()
+            QueueIndex eventQueueTail;      // Input events read, only moved by GetInputEvent()
+            QueueIndex eventQueueDropped;   // Input events dropped because the queue was full
+
         } Keyboard;
         struct {
             Vector2 offset;                 // Mouse offset
@@ -338,6 +391,10 @@ typedef struct CoreData {
         double target;                      // Desired time for one frame, if 0 not applied
         unsigned long long int base;        // Base time measure for hi-res timer (PLATFORM_ANDROID, PLATFORM_DRM)
         unsigned int frameCounter;          // Frame counter
+        double deadline;                    // Time at which the current frame should end, moves by target every frame
+        double wakeJitter;                  // Worst recent delay of a wakeup after sleeping, slowly decays
+        double pacingError;                 // Time the last frame wait ended at minus its deadline
+        double swap;                        // Time the last SwapScreenBuffer() returned
 
     } Time;
 } CoreData;
@@ -359,6 +416,53 @@ bool gifRecording = false;           // GIF recording state
 MsfGifState gifState = { 0 };        // MSGIF context state
 #endif
 
+#if defined(SUPPORT_ASYNC_CAPTURE)
+// Capture job types
+typedef enum {
+    CAPTURE_SCREENSHOT = 0,         // Export pixels to an image file
+    CAPTURE_GIF_BEGIN,              // Start gif recording (no pixels)
+    CAPTURE_GIF_FRAME,              // Add pixels as a gif frame
+    CAPTURE_GIF_END                 // Finish gif recording and save it (no pixels)
+} CaptureJobType;
+
+// Capture job, processed by the capture worker
+typedef struct CaptureJob {
+    int type;                       // Job type (CaptureJobType)
+    int width;                      // Pixels width
+    int height;                     // Pixels height
+    bool topDown;                   // Pixels rows are top-down, otherwise bottom-up as read from the framebuffer
+    unsigned char *pixels;          // Pixels data (RGBA), buffers are kept and reused by the queue slots
+    int capacity;                   // Pixels buffer size
+    char path[MAX_FILEPATH_LENGTH]; // Output file path
+} CaptureJob;
+
+// Capture pipeline state
+// NOTE: The main thread reads the screen back and queues jobs, the worker encodes and saves them,
+// gifState belongs to the worker while it is running
+typedef struct CaptureData {
+    bool running;                   // Worker thread started
+    bool stop;                      // Worker must exit once the queue is empty
+    pthread_t thread;               // Worker thread
+    pthread_mutex_t mutex;          // Protects the queue
+    pthread_cond_t jobQueued;       // Signaled when a job is queued or the worker must stop
+    pthread_cond_t jobDone;         // Signaled when the worker finished a job
+
+    CaptureJob queue[MAX_CAPTURE_QUEUE]; // Jobs queue (ring buffer)
+    int head;                       // First job in the queue
+    int count;                      // Jobs in the queue, including the one being processed
+    unsigned int dropped;           // Gif frames dropped because the queue was full
+
+    unsigned int pbo[2];            // Pixel pack buffers, one can be written while the other is read back
+    int pboSize;                    // Pixel pack buffers size
+    int pboIndex;                   // Next pixel pack buffer to write, also the oldest one
+    bool pboPending[2];             // Readback started but not queued yet
+    unsigned int pboFrame[2];       // Frame the readback was started on
+    CaptureJob pboJob[2];           // Job to queue once the readback is complete (no pixels)
+} CaptureData;
+
+static CaptureData capture = { 0 };
+#endif
+
 #if defined(SUPPORT_AUTOMATION_EVENTS)
 // Automation events type
 typedef enum AutomationEventType {
@@ -463,6 +567,8 @@ extern void ClosePlatform(void);        // Close platform
 static void InitTimer(void);                                // Initialize timer, hi-resolution if available (required by InitPlatform())
 static void SetupFramebuffer(int width, int height);        // Setup main framebuffer (required by InitPlatform())
 static void SetupViewport(int width, int height);           // Set viewport for a provided width and height
+static void WaitUntil(double deadline);                     // Wait until an absolute time, used for frame pacing
+static void PushInputEvent(int type, int value);            // Push a timestamped input event (used by platform layer)
 
 static void ScanDirectoryFiles(const char *basePath, FilePathList *list, const char *filter);   // Scan all files and directories in a base path
 static void ScanDirectoryFilesRecursively(const char *basePath, FilePathList *list, const char *filter);  // Scan all files and directories recursively from a base path
@@ -471,6 +577,13 @@ static void ScanDirectoryFilesRecursively(const char *basePath, FilePathList *li
 static void RecordAutomationEvent(void); // Record frame events (to internal events array)
 #endif
 
+#if defined(SUPPORT_ASYNC_CAPTURE)
+static void CaptureScreenAsync(int type, const char *path); // Start reading the screen back for a capture job
+static void QueueCaptureJob(CaptureJob job, bool wait);     // Queue capture job without pixels
+static void UpdateCapture(bool flush);                      // Queue completed readbacks, all of them if flush is set
+static void CloseCapture(void);                             // Finish queued captures and stop capture worker
+#endif
+
 #if defined(_WIN32)
 // NOTE: We declare Sleep() function symbol to avoid including windows.h (kernel32.lib linkage required)
 void __stdcall Sleep(unsigned long msTimeout);              // Required for: WaitTime()
@@ -491,6 +604,8 @@ const char *TextFormat(const char *text, ...);              // Formatting of tex
     #include "platforms/rcore_drm.c"
 #elif defined(PLATFORM_ANDROID)
     #include "platforms/rcore_android.c"
+#elif defined(PLATFORM_HEADLESS)
+    #include "platforms/rcore_headless.c"
 #else
     // TODO: Include your custom platform backend!
     // i.e software rendering backend or console backend!
@@ -559,6 +674,8 @@ void InitWindow(int width, int height, const char *title)
     TRACELOG(LOG_INFO, "Platform backend: NATIVE DRM");
 #elif defined(PLATFORM_ANDROID)
     TRACELOG(LOG_INFO, "Platform backend: ANDROID");
+#elif defined(PLATFORM_HEADLESS)
+    TRACELOG(LOG_INFO, "Platform backend: HEADLESS (software)");
 #else
     // TODO: Include your custom platform backend!
     // i.e software rendering backend or console backend!
@@ -667,6 +784,10 @@ void InitWindow(int width, int height, const char *title)
 // Close window and unload OpenGL context
 void CloseWindow(void)
 {
+#if defined(SUPPORT_ASYNC_CAPTURE)
+    CloseCapture();             // Worker is stopped, gifState can be used below
+#endif
+
 #if defined(SUPPORT_GIF_RECORDING)
     if (gifRecording)
     {
@@ -834,6 +955,10 @@ void EndDrawing(void)
 {
     rlDrawRenderBatchActive();      // Update and draw internal render batch
 
+#if defined(SUPPORT_ASYNC_CAPTURE)
+    UpdateCapture(false);           // Readbacks from previous frames are complete by now
+#endif
+
 #if defined(SUPPORT_GIF_RECORDING)
     // Draw record indicator
     if (gifRecording)
@@ -844,6 +969,9 @@ void EndDrawing(void)
         // NOTE: We record one gif frame every 10 game frames
         if ((gifFrameCounter%GIF_RECORD_FRAMERATE) == 0)
         {
+        #if defined(SUPPORT_ASYNC_CAPTURE)
+            CaptureScreenAsync(CAPTURE_GIF_FRAME, NULL);
+        #else
             // Get image data for the current frame (from backbuffer)
             // NOTE: This process is quite slow... :(
             Vector2 scale = GetWindowScaleDPI();
@@ -851,6 +979,7 @@ void EndDrawing(void)
             msf_gif_frame(&gifState, screenData, 10, 16, (int)((float)CORE.Window.render.width*scale.x)*4);
 
             RL_FREE(screenData);    // Free image data
+        #endif
         }
 
     #if defined(SUPPORT_MODULE_RSHAPES) && defined(SUPPORT_MODULE_RTEXT)
@@ -874,12 +1003,39 @@ void EndDrawing(void)
 
     // Frame time control system
     CORE.Time.current = GetTime();
+    CORE.Time.swap = CORE.Time.current;
     CORE.Time.draw = CORE.Time.current - CORE.Time.previous;
     CORE.Time.previous = CORE.Time.current;
 
     CORE.Time.frame = CORE.Time.update + CORE.Time.draw;
 
     // Wait for some milliseconds...
+#if defined(SUPPORT_PRECISE_FRAME_PACING)
+    if (CORE.Time.target > 0.0)
+    {
+        // Frames end on a fixed grid of deadlines, so sleep error does not add up from frame to frame
+        if (CORE.Time.deadline == 0.0) CORE.Time.deadline = CORE.Time.current;
+        CORE.Time.deadline += CORE.Time.target;
+
+        if (CORE.Time.deadline > CORE.Time.current)
+        {
+            WaitUntil(CORE.Time.deadline);
+
+            CORE.Time.current = GetTime();
+            double waitTime = CORE.Time.current - CORE.Time.previous;
+            CORE.Time.previous = CORE.Time.current;
+
+            CORE.Time.frame += waitTime;    // Total frame time: update + draw + wait
+            CORE.Time.pacingError = CORE.Time.current - CORE.Time.deadline;
+        }
+        else
+        {
+            // Frame took too long, restart the grid from here instead of rushing to catch up
+            CORE.Time.pacingError = CORE.Time.current - CORE.Time.deadline;
+            CORE.Time.deadline = CORE.Time.current;
+        }
+    }
+#else
     if (CORE.Time.frame < CORE.Time.target)
     {
         WaitTime(CORE.Time.target - CORE.Time.frame);
@@ -890,6 +1046,7 @@ void EndDrawing(void)
 
         CORE.Time.frame += waitTime;    // Total frame time: update + draw + wait
     }
+#endif
 
     PollInputEvents();      // Poll user events (before next frame update)
 #endif
@@ -904,10 +1061,19 @@ void EndDrawing(void)
             {
                 gifRecording = false;
 
+            #if defined(SUPPORT_ASYNC_CAPTURE)
+                UpdateCapture(true);    // Pending gif frames go before the end of the recording
+
+                CaptureJob job = { 0 };
+                job.type = CAPTURE_GIF_END;
+                strcpy(job.path, TextFormat("%s/screenrec%03i.gif", CORE.Storage.basePath, screenshotCounter));
+                QueueCaptureJob(job, true);
+            #else
                 MsfGifResult result = msf_gif_end(&gifState);
 
                 SaveFileData(TextFormat("%s/screenrec%03i.gif", CORE.Storage.basePath, screenshotCounter), result.data, (unsigned int)result.dataSize);
                 msf_gif_free(result);
+            #endif
 
                 TRACELOG(LOG_INFO, "SYSTEM: Finish animated GIF recording");
             }
@@ -917,7 +1083,15 @@ void EndDrawing(void)
                 gifFrameCounter = 0;
 
                 Vector2 scale = GetWindowScaleDPI();
+            #if defined(SUPPORT_ASYNC_CAPTURE)
+                CaptureJob job = { 0 };
+                job.type = CAPTURE_GIF_BEGIN;
+                job.width = (int)((float)CORE.Window.render.width*scale.x);
+                job.height = (int)((float)CORE.Window.render.height*scale.y);
+                QueueCaptureJob(job, true);
+            #else
                 msf_gif_begin(&gifState, (int)((float)CORE.Window.render.width*scale.x), (int)((float)CORE.Window.render.height*scale.y));
+            #endif
                 screenshotCounter++;
 
                 TRACELOG(LOG_INFO, "SYSTEM: Start animated GIF recording: %s", TextFormat("screenrec%03i.gif", screenshotCounter));
@@ -1564,6 +1738,8 @@ void SetTargetFPS(int fps)
     if (fps < 1) CORE.Time.target = 0.0;
     else CORE.Time.target = 1.0/(double)fps;
 
+    CORE.Time.deadline = 0.0;
+
     TRACELOG(LOG_INFO, "TIMER: Target time per frame: %02.03f milliseconds", (float)CORE.Time.target*1000.0f);
 }
 
@@ -1624,6 +1800,19 @@ float GetFrameTime(void)
 //void SwapScreenBuffer(void);
 //void PollInputEvents(void);
 
+// Get how late (positive) or early the last frame wait ended compared to its deadline, in seconds
+double GetFramePacingError(void)
+{
+    return CORE.Time.pacingError;
+}
+
+// Get time the last frame was handed to the display, before waiting for the next one
+// NOTE: With vsync enabled, SwapScreenBuffer() may block until the previous frame is shown
+double GetFrameSwapTime(void)
+{
+    return CORE.Time.swap;
+}
+
 // Wait for some time (stop program execution)
 // NOTE: Sleep() granularity could be around 10 ms, it means, Sleep() could
 // take longer than expected... for that reason we use the busy wait loop
@@ -1633,6 +1822,9 @@ void WaitTime(double seconds)
 {
     if (seconds < 0) return;
 
+#if defined(SUPPORT_PRECISE_FRAME_PACING) && (defined(__linux__) || defined(__FreeBSD__))
+    WaitUntil(GetTime() + seconds);
+#else
 #if defined(SUPPORT_BUSY_WAIT_LOOP) || defined(SUPPORT_PARTIALBUSY_WAIT_LOOP)
     double destinationTime = GetTime() + seconds;
 #endif
@@ -1668,8 +1860,317 @@ void WaitTime(double seconds)
         while (GetTime() < destinationTime) { }
     #endif
 #endif
+#endif
+}
+
+// Wait until an absolute time, as returned by GetTime()
+// NOTE: Sleeps until a bit before the deadline and busy waits the rest, the busy wait
+// margin follows the worst recent wakeup delay so it stays small on a quiet system
+static void WaitUntil(double deadline)
+{
+#if defined(SUPPORT_PRECISE_FRAME_PACING) && (defined(__linux__) || defined(__FreeBSD__))
+    double spinMargin = CORE.Time.wakeJitter*1.25 + FRAME_PACING_MIN_SPIN;
+    if (spinMargin > FRAME_PACING_MAX_SPIN) spinMargin = FRAME_PACING_MAX_SPIN;
+
+    double sleepUntil = deadline - spinMargin;
+    double now = GetTime();
+
+    if (now < sleepUntil)
+    {
+        // GetTime() has its own base, move the wakeup time over to CLOCK_MONOTONIC
+        struct timespec monotonic = { 0 };
+        clock_gettime(CLOCK_MONOTONIC, &monotonic);
+
+        long long int wakeNs = (long long int)monotonic.tv_sec*1000000000LL + monotonic.tv_nsec + (long long int)((sleepUntil - now)*1e9);
+        struct timespec wake = { 0 };
+        wake.tv_sec = wakeNs/1000000000LL;
+        wake.tv_nsec = wakeNs%1000000000LL;
+
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, NULL) == EINTR) continue;
+
+        double late = GetTime() - sleepUntil;
+        CORE.Time.wakeJitter *= FRAME_PACING_JITTER_DECAY;
+        if (late > CORE.Time.wakeJitter) CORE.Time.wakeJitter = late;
+    }
+
+    while (GetTime() < deadline) { }
+#else
+    double seconds = deadline - GetTime();
+    if (seconds > 0.0) WaitTime(seconds);
+#endif
+}
+
+// Push a timestamped input event, the newest event is dropped if the queue is full
+static void PushInputEvent(int type, int value)
+{
+    unsigned int head = CORE.Input.Keyboard.eventQueueHead;
+
+    if ((head - CORE.Input.Keyboard.eventQueueTail) >= MAX_INPUT_EVENT_QUEUE)
+    {
+        CORE.Input.Keyboard.eventQueueDropped++;
+        return;
+    }
+
+    InputEvent *event = &CORE.Input.Keyboard.eventQueue[head & (MAX_INPUT_EVENT_QUEUE - 1)];
+    event->type = type;
+    event->value = value;
+    event->time = GetTime();
+
+    CORE.Input.Keyboard.eventQueueHead = head + 1;  // Publish the event to the consumer
+}
+#if defined(SUPPORT_ASYNC_CAPTURE)
+// Capture worker, encodes and saves queued captures in order
+static void *CaptureWorker(void *arg)
+{
+    (void)arg;
+
+    pthread_mutex_lock(&capture.mutex);
+
+    while (true)
+    {
+        while ((capture.count == 0) && !capture.stop) pthread_cond_wait(&capture.jobQueued, &capture.mutex);
+        if (capture.count == 0) break;
+
+        // NOTE: The main thread does not touch the head slot until it is released
+        CaptureJob *job = &capture.queue[capture.head];
+        pthread_mutex_unlock(&capture.mutex);
+
+        int stride = job->width*4;
+
+        switch (job->type)
+        {
+            case CAPTURE_SCREENSHOT:
+            {
+            #if defined(SUPPORT_MODULE_RTEXTURES)
+                // Flip image vertically in place and set alpha to 255, like rlReadScreenPixels()
+                if (!job->topDown)
+                {
+                    for (int y = 0; y < job->height/2; y++)
+                    {
+                        unsigned char *top = job->pixels + y*stride;
+                        unsigned char *bottom = job->pixels + (job->height - 1 - y)*stride;
+
+                        for (int x = 0; x < stride; x++)
+                        {
+                            unsigned char temp = top[x];
+                            top[x] = bottom[x];
+                            bottom[x] = temp;
+                        }
+                    }
+
+                    for (int i = 3; i < stride*job->height; i += 4) job->pixels[i] = 255;
+                }
+
+                // NOTE: Only .png screenshots are queued, TakeScreenshot() checked the extension on the main thread,
+                // ExportImage() can't be used here, its extension checks use rtext static buffers
+                Image image = { job->pixels, job->width, job->height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+                int dataSize = 0;
+                unsigned char *data = ExportImageToMemory(image, ".png", &dataSize);     // WARNING: Module required: rtextures
+                bool saved = (data != NULL) && SaveFileData(job->path, data, dataSize);
+                RL_FREE(data);
+
+                if (saved) TRACELOG(LOG_INFO, "SYSTEM: [%s] Screenshot taken successfully", job->path);
+                else TRACELOG(LOG_WARNING, "SYSTEM: [%s] Screenshot could not be saved", job->path);
+            #endif
+            } break;
+        #if defined(SUPPORT_GIF_RECORDING)
+            case CAPTURE_GIF_BEGIN: msf_gif_begin(&gifState, job->width, job->height); break;
+            case CAPTURE_GIF_FRAME:
+            {
+                // NOTE: Negative pitch makes msf_gif read the rows bottom-up
+                msf_gif_frame(&gifState, job->pixels, 10, 16, job->topDown? stride : -stride);
+            } break;
+            case CAPTURE_GIF_END:
+            {
+                MsfGifResult result = msf_gif_end(&gifState);
+
+                SaveFileData(job->path, result.data, (unsigned int)result.dataSize);
+                msf_gif_free(result);
+            } break;
+        #endif
+            default: break;
+        }
+
+        pthread_mutex_lock(&capture.mutex);
+        capture.head = (capture.head + 1)%MAX_CAPTURE_QUEUE;
+        capture.count--;
+        pthread_cond_signal(&capture.jobDone);
+    }
+
+    pthread_mutex_unlock(&capture.mutex);
+
+    return NULL;
+}
+
+// Queue capture job, pixels are copied into the queue slot
+// NOTE: Waits for a free slot if requested, otherwise the job is dropped when the queue is full
+static void QueueCaptureJobPixels(CaptureJob job, const unsigned char *pixels, bool wait)
+{
+    if (!capture.running)
+    {
+        pthread_mutex_init(&capture.mutex, NULL);
+        pthread_cond_init(&capture.jobQueued, NULL);
+        pthread_cond_init(&capture.jobDone, NULL);
+        capture.stop = false;
+
+        if (pthread_create(&capture.thread, NULL, CaptureWorker, NULL) != 0)
+        {
+            TRACELOG(LOG_WARNING, "SYSTEM: Failed to start capture worker thread");
+            return;
+        }
+
+        capture.running = true;
+    }
+
+    pthread_mutex_lock(&capture.mutex);
+
+    while (capture.count == MAX_CAPTURE_QUEUE)
+    {
+        if (!wait)
+        {
+            capture.dropped++;
+            pthread_mutex_unlock(&capture.mutex);
+            return;
+        }
+
+        pthread_cond_wait(&capture.jobDone, &capture.mutex);
+    }
+
+    CaptureJob *slot = &capture.queue[(capture.head + capture.count)%MAX_CAPTURE_QUEUE];
+    pthread_mutex_unlock(&capture.mutex);
+
+    // NOTE: Only this thread queues jobs, the slot stays free while it is filled without the lock
+    slot->type = job.type;
+    slot->width = job.width;
+    slot->height = job.height;
+    slot->topDown = job.topDown;
+    strcpy(slot->path, job.path);
+
+    if (pixels != NULL)
+    {
+        int size = job.width*job.height*4;
+
+        if (slot->capacity < size)
+        {
+            RL_FREE(slot->pixels);
+            slot->pixels = (unsigned char *)RL_MALLOC(size);
+            slot->capacity = size;
+        }
+
+        memcpy(slot->pixels, pixels, size);
+    }
+
+    pthread_mutex_lock(&capture.mutex);
+    capture.count++;
+    pthread_cond_signal(&capture.jobQueued);
+    pthread_mutex_unlock(&capture.mutex);
+}
+
+// Queue capture job without pixels
+static void QueueCaptureJob(CaptureJob job, bool wait)
+{
+    QueueCaptureJobPixels(job, NULL, wait);
+}
+
+// Queue the readback of a pixel pack buffer, stalls if it is not complete yet
+static void QueueCaptureReadback(int index)
+{
+    CaptureJob *job = &capture.pboJob[index];
+    unsigned char *pixels = rlMapPixelPackBuffer(capture.pbo[index], capture.pboSize);
+
+    // NOTE: Only gif frames can be dropped, screenshots wait for the worker
+    if (pixels != NULL) QueueCaptureJobPixels(*job, pixels, job->type != CAPTURE_GIF_FRAME);
+
+    rlUnmapPixelPackBuffer(capture.pbo[index]);
+    capture.pboPending[index] = false;
+}
+
+// Start reading the screen back for a capture job
+// NOTE: Pixels are queued on a later frame, by then the GPU is done with the readback
+static void CaptureScreenAsync(int type, const char *path)
+{
+    Vector2 scale = GetWindowScaleDPI();
+
+    CaptureJob job = { 0 };
+    job.type = type;
+    job.width = (int)((float)CORE.Window.render.width*scale.x);
+    job.height = (int)((float)CORE.Window.render.height*scale.y);
+    if (path != NULL) strcpy(job.path, path);
+
+    int size = job.width*job.height*4;
+
+    if (size != capture.pboSize)
+    {
+        UpdateCapture(true);
+
+        rlUnloadPixelPackBuffer(capture.pbo[0]);
+        rlUnloadPixelPackBuffer(capture.pbo[1]);
+        capture.pbo[0] = rlLoadPixelPackBuffer(size);
+        capture.pbo[1] = rlLoadPixelPackBuffer(size);
+        capture.pboSize = size;
+    }
+
+    if (capture.pbo[0] == 0)
+    {
+        // No pixel pack buffers, read back synchronously but still encode on the worker
+        unsigned char *pixels = rlReadScreenPixels(job.width, job.height);
+        job.topDown = true;
+        QueueCaptureJobPixels(job, pixels, type != CAPTURE_GIF_FRAME);
+        RL_FREE(pixels);
+        return;
+    }
+
+    int index = capture.pboIndex;
+    if (capture.pboPending[index]) QueueCaptureReadback(index);
+
+    rlReadScreenPixelsAsync(capture.pbo[index], job.width, job.height);
+    capture.pboJob[index] = job;
+    capture.pboFrame[index] = CORE.Time.frameCounter;
+    capture.pboPending[index] = true;
+    capture.pboIndex = index^1;
 }
 
+// Queue completed readbacks, oldest first
+static void UpdateCapture(bool flush)
+{
+    for (int i = 0; i < 2; i++)
+    {
+        int index = capture.pboIndex^i;
+
+        if (capture.pboPending[index] && (flush || (capture.pboFrame[index] != CORE.Time.frameCounter))) QueueCaptureReadback(index);
+    }
+}
+
+// Finish queued captures and stop capture worker
+static void CloseCapture(void)
+{
+    UpdateCapture(true);
+
+    if (capture.running)
+    {
+        pthread_mutex_lock(&capture.mutex);
+        capture.stop = true;
+        pthread_cond_signal(&capture.jobQueued);
+        pthread_mutex_unlock(&capture.mutex);
+
+        pthread_join(capture.thread, NULL);
+        pthread_cond_destroy(&capture.jobDone);
+        pthread_cond_destroy(&capture.jobQueued);
+        pthread_mutex_destroy(&capture.mutex);
+
+        if (capture.dropped > 0) TRACELOG(LOG_WARNING, "SYSTEM: %u gif frames were dropped by the capture worker", capture.dropped);
+    }
+
+    for (int i = 0; i < MAX_CAPTURE_QUEUE; i++) RL_FREE(capture.queue[i].pixels);
+
+    rlUnloadPixelPackBuffer(capture.pbo[0]);
+    rlUnloadPixelPackBuffer(capture.pbo[1]);
+
+    memset(&capture, 0, sizeof(capture));
+}
+#endif  // SUPPORT_ASYNC_CAPTURE
+
+
 //----------------------------------------------------------------------------------
 // Module Functions Definition: Misc
 //----------------------------------------------------------------------------------
@@ -1774,6 +2275,15 @@ void TakeScreenshot(const char *fileName)
     // Security check to (partially) avoid malicious code
     if (strchr(fileName, '\'') != NULL) { TRACELOG(LOG_WARNING, "SYSTEM: Provided fileName could be potentially malicious, avoid [\'] character"); return; }
 
+#if defined(SUPPORT_ASYNC_CAPTURE)
+    // NOTE: Png images are exported by the capture worker, it reports the result,
+    // other formats are saved right away below
+    if (IsFileExtension(fileName, ".png"))
+    {
+        CaptureScreenAsync(CAPTURE_SCREENSHOT, TextFormat("%s/%s", CORE.Storage.basePath, GetFileName(fileName)));
+        return;
+    }
+#endif
     Vector2 scale = GetWindowScaleDPI();
     unsigned char *imgData = rlReadScreenPixels((int)((float)CORE.Window.render.width*scale.x), (int)((float)CORE.Window.render.height*scale.y));
     Image image = { imgData, (int)((float)CORE.Window.render.width*scale.x), (int)((float)CORE.Window.render.height*scale.y), 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
@@ -1791,6 +2301,23 @@ void TakeScreenshot(const char *fileName)
 #endif
 }
 
+// Get number of gif frames dropped because the capture worker fell behind
+unsigned int GetCaptureFramesDropped(void)
+{
+    unsigned int dropped = 0;
+
+#if defined(SUPPORT_ASYNC_CAPTURE)
+    if (capture.running)
+    {
+        pthread_mutex_lock(&capture.mutex);
+        dropped = capture.dropped;
+        pthread_mutex_unlock(&capture.mutex);
+    }
+#endif
+
+    return dropped;
+}
+
 // Setup window configuration flags (view FLAGS)
 // NOTE: This function is expected to be called before window creation,
 // because it sets up some flags for the window creation process.
@@ -2758,6 +3285,27 @@ int GetCharPressed(void)
     return value;
 }
 
+// Get oldest queued input event
+// NOTE: Unlike the key/char queues, events are kept across frames and in the order they arrived,
+// so a key pressed and released within one frame or keys mixed with chars are not lost or reordered
+bool GetInputEvent(InputEvent *event)
+{
+    unsigned int tail = CORE.Input.Keyboard.eventQueueTail;
+
+    if (tail == CORE.Input.Keyboard.eventQueueHead) return false;
+
+    *event = CORE.Input.Keyboard.eventQueue[tail & (MAX_INPUT_EVENT_QUEUE - 1)];
+    CORE.Input.Keyboard.eventQueueTail = tail + 1;  // Publish the slot back to the producer
+
+    return true;
+}
+
+// Get number of input events dropped because the queue was full
+unsigned int GetInputEventsDropped(void)
+{
+    return CORE.Input.Keyboard.eventQueueDropped;
+}
+
 // Set a custom key to exit program
 // NOTE: default exitKey is set to ESCAPE
 void SetExitKey(int key)
@@ -709,6 +709,11 @@ RLAPI void rlUnloadTexture(unsigned int id);                              // Unl
 RLAPI void rlGenTextureMipmaps(unsigned int id, int width, int height, int format, int *mipmaps); // Generate mipmap data for selected texture
 RLAPI void *rlReadTexturePixels(unsigned int id, int width, int height, int format);              // Read texture pixel data
 RLAPI unsigned char *rlReadScreenPixels(int width, int height);           // Read screen pixel data (color buffer)
+RLAPI unsigned int rlLoadPixelPackBuffer(int size);                       // Load a pixel pack buffer for asynchronous readbacks, 0 if not supported
+RLAPI void rlUnloadPixelPackBuffer(unsigned int id);                      // Unload pixel pack buffer
+RLAPI void rlReadScreenPixelsAsync(unsigned int id, int width, int height);  // Start reading screen pixel data (RGBA, bottom-up) into a pixel pack buffer
+RLAPI unsigned char *rlMapPixelPackBuffer(unsigned int id, int size);     // Map pixel pack buffer for reading, waits for its readback to complete
+RLAPI void rlUnmapPixelPackBuffer(unsigned int id);                       // Unmap pixel pack buffer
 
 // Framebuffer management (fbo)
 RLAPI unsigned int rlLoadFramebuffer(int width, int height);              // Load an empty framebuffer
@@ -755,6 +760,14 @@ RLAPI void rlSetMatrixModelview(Matrix view);                             // Set
 RLAPI void rlSetMatrixProjectionStereo(Matrix right, Matrix left);        // Set eyes projection matrices for stereo rendering
 RLAPI void rlSetMatrixViewOffsetStereo(Matrix right, Matrix left);        // Set eyes view offsets matrices for stereo rendering
 
+// GPU timestamp queries management
+// NOTE: Only available on OpenGL 3.3+, query ids are 0 otherwise
+RLAPI unsigned int rlLoadTimestampQuery(void);                            // Load a timestamp query object
+RLAPI void rlUnloadTimestampQuery(unsigned int id);                       // Unload timestamp query object
+RLAPI void rlTimestampQuery(unsigned int id);                             // Record GPU time once all previous commands have completed
+RLAPI bool rlGetTimestampQueryResult(unsigned int id, double *time);      // Get recorded GPU time in seconds without blocking, false if not available yet
+RLAPI double rlGetGpuTimestamp(void);                                     // Get current GPU time in seconds, same clock as timestamp queries
+
 // Quick and dirty cube/quad buffers load->draw->unload
 RLAPI void rlLoadDrawCube(void);     // Load and draw a cube
 RLAPI void rlLoadDrawQuad(void);     // Load and draw a quad
@@ -3472,6 +3485,66 @@ unsigned char *rlReadScreenPixels(int width, int height)
     return imgData;     // NOTE: image data should be freed
 }
 
+// Load a pixel pack buffer for asynchronous readbacks
+// NOTE: Only available on OpenGL 3.3+, returns 0 otherwise
+unsigned int rlLoadPixelPackBuffer(int size)
+{
+    unsigned int id = 0;
+
+#if defined(GRAPHICS_API_OPENGL_33)
+    glGenBuffers(1, &id);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, id);
+    glBufferData(GL_PIXEL_PACK_BUFFER, size, NULL, GL_STREAM_READ);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+#endif
+
+    return id;
+}
+
+// Unload pixel pack buffer
+void rlUnloadPixelPackBuffer(unsigned int id)
+{
+#if defined(GRAPHICS_API_OPENGL_33)
+    if (id > 0) glDeleteBuffers(1, &id);
+#endif
+}
+
+// Start reading screen pixel data into a pixel pack buffer
+// NOTE: Returns immediately, data is bottom-up and alpha is not forced to 255 like rlReadScreenPixels()
+void rlReadScreenPixelsAsync(unsigned int id, int width, int height)
+{
+#if defined(GRAPHICS_API_OPENGL_33)
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, id);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+#endif
+}
+
+// Map pixel pack buffer for reading
+// NOTE: Only stalls if the readback did not complete yet, map it a frame after rlReadScreenPixelsAsync()
+unsigned char *rlMapPixelPackBuffer(unsigned int id, int size)
+{
+    unsigned char *data = NULL;
+
+#if defined(GRAPHICS_API_OPENGL_33)
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, id);
+    data = (unsigned char *)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+#endif
+
+    return data;
+}
+
+// Unmap pixel pack buffer
+void rlUnmapPixelPackBuffer(unsigned int id)
+{
+#if defined(GRAPHICS_API_OPENGL_33)
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, id);
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+#endif
+}
+
 // Framebuffer management (fbo)
 //-----------------------------------------------------------------------------------------
 // Load a framebuffer to be used for rendering
@@ -4406,6 +4479,74 @@ void rlSetMatrixViewOffsetStereo(Matrix right, Matrix left)
 #endif
 }
 
+// Load a timestamp query object
+unsigned int rlLoadTimestampQuery(void)
+{
+    unsigned int id = 0;
+
+#if defined(GRAPHICS_API_OPENGL_33)
+    glGenQueries(1, &id);
+#endif
+
+    return id;
+}
+
+// Unload timestamp query object
+void rlUnloadTimestampQuery(unsigned int id)
+{
+#if defined(GRAPHICS_API_OPENGL_33)
+    if (id > 0) glDeleteQueries(1, &id);
+#endif
+}
+
+// Record GPU time once all previous commands have completed
+// NOTE: Commands still in the internal render batch are not included, draw it first
+void rlTimestampQuery(unsigned int id)
+{
+#if defined(GRAPHICS_API_OPENGL_33)
+    if (id > 0) glQueryCounter(id, GL_TIMESTAMP);
+#endif
+}
+
+// Get recorded GPU time in seconds, returns false if the GPU did not get there yet
+bool rlGetTimestampQueryResult(unsigned int id, double *time)
+{
+    bool available = false;
+
+#if defined(GRAPHICS_API_OPENGL_33)
+    if (id > 0)
+    {
+        int ready = 0;
+        glGetQueryObjectiv(id, GL_QUERY_RESULT_AVAILABLE, &ready);
+
+        if (ready)
+        {
+            GLuint64 result = 0;
+            glGetQueryObjectui64v(id, GL_QUERY_RESULT, &result);
+            *time = (double)result*1e-9;
+            available = true;
+        }
+    }
+#endif
+
+    return available;
+}
+
+// Get current GPU time in seconds
+// NOTE: Useful to map timestamp query results to CPU time, returns 0 if not supported
+double rlGetGpuTimestamp(void)
+{
+    double time = 0.0;
+
+#if defined(GRAPHICS_API_OPENGL_33)
+    GLint64 now = 0;
+    glGetInteger64v(GL_TIMESTAMP, &now);
+    time = (double)now*1e-9;
+#endif
+
+    return time;
+}
+
 // Load and draw a quad in NDC
 void rlLoadDrawQuad(void)
 {
@@ -79,6 +79,9 @@
     #define STB_RECT_PACK_IMPLEMENTATION
     #include "external/stb_rect_pack.h"     // Required for: ttf font rectangles packaging
 
+    #define STBTT_malloc(size,u) ((void)(u), RL_MALLOC(size))
+    #define STBTT_free(ptr,u) ((void)(u), RL_FREE(ptr))
+
     #define STBTT_STATIC
     #define STB_TRUETYPE_IMPLEMENTATION
     #include "external/stb_truetype.h"      // Required for: ttf font data reading
@@ -34,6 +34,10 @@
 *       #define SUPPORT_IMAGE_GENERATION
 *           Support procedural image generation functionality (gradient, spot, perlin-noise, cellular)
 *
+*       #define SUPPORT_IMAGE_SIMD
+*           Use SSE2/AVX2/NEON kernels for RGBA8 fills and alpha blending when the compiler targets them,
+*           results are the same as the scalar ColorAlphaBlend()
+*
 *   DEPENDENCIES:
 *       stb_image        - Multiple image formats loading (JPEG, PNG, BMP, TGA, PSD, GIF, PIC)
 *                          NOTE: stb_image has been slightly modified to support Android platform.
@@ -78,6 +82,21 @@
 #include <math.h>               // Required for: fabsf() [Used in DrawTextureRec()]
 #include <stdio.h>              // Required for: sprintf() [Used in ExportImageAsCode()]
 
+// Vector kernels for RGBA8 fills and blending, selected by what the compiler targets
+#if defined(SUPPORT_IMAGE_SIMD)
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+        #include <emmintrin.h>  // Required for: SSE2 intrinsics [Used in ImageFillRGBA8(), ImageBlendRGBA8()]
+        #define IMAGE_SIMD_SSE2
+        #if defined(__AVX2__)
+            #include <immintrin.h>  // Required for: AVX2 intrinsics [Used in ImageFillRGBA8()]
+            #define IMAGE_SIMD_AVX2
+        #endif
+    #elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+        #include <arm_neon.h>   // Required for: NEON intrinsics [Used in ImageFillRGBA8(), ImageBlendRGBA8()]
+        #define IMAGE_SIMD_NEON
+    #endif
+#endif
+
 // Support only desired texture formats on stb_image
 #if !defined(SUPPORT_FILEFORMAT_BMP)
     #define STBI_NO_BMP
@@ -255,6 +274,8 @@ extern void LoadFontDefault(void);          // [Module: text] Loads default font
 static float HalfToFloat(unsigned short x);
 static unsigned short FloatToHalf(float x);
 static Vector4 *LoadImageDataNormalized(Image image);       // Load pixel data from image as Vector4 array (float normalized)
+static void ImageFillRGBA8(unsigned char *dst, Color color, int count);                        // Fill RGBA8 pixels with color
+static void ImageBlendRGBA8(unsigned char *dst, const unsigned char *src, int count, Color tint);  // Blend RGBA8 pixels over RGBA8 pixels
 
 //----------------------------------------------------------------------------------
 // Module Functions Definition
@@ -3058,6 +3079,12 @@ void ImageClearBackground(Image *dst, Color color)
     // Security check to avoid program crash
     if ((dst->data == NULL) || (dst->width == 0) || (dst->height == 0)) return;
 
+    if (dst->format == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8)
+    {
+        ImageFillRGBA8((unsigned char *)dst->data, color, dst->width*dst->height);
+        return;
+    }
+
     // Fill in first pixel based on image format
     ImageDrawPixel(dst, 0, 0, color);
 
@@ -3414,6 +3441,15 @@ void ImageDrawRectangleRec(Image *dst, Rectangle rec, Color color)
     int sy = (int)rec.y;
     int sx = (int)rec.x;
 
+    if (dst->format == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8)
+    {
+        for (int y = 0; y < (int)rec.height; y++)
+        {
+            ImageFillRGBA8((unsigned char *)dst->data + ((sy + y)*dst->width + sx)*4, color, (int)rec.width);
+        }
+        return;
+    }
+
     int bytesPerPixel = GetPixelDataSize(1, 1, dst->format);
 
     // Fill in the first pixel of the first row based on image format
@@ -3535,6 +3571,23 @@ void ImageDraw(Image *dst, Image src, Rectangle srcRec, Rectangle dstRec, Color
 
             // Fast path: Avoid moving pixel by pixel if no blend required and same format
             if (!blendRequired && (srcPtr->format == dst->format)) memcpy(pDst, pSrc, (int)(srcRec.width)*bytesPerPixelSrc);
+            else if (blendRequired && (dst->format == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8))
+            {
+                // Fast path: Blend whole rows, other source formats are converted in chunks first
+                if (srcPtr->format == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8) ImageBlendRGBA8(pDst, pSrc, (int)srcRec.width, tint);
+                else
+                {
+                    Color chunk[64] = { 0 };
+                    int chunkSize = sizeof(chunk)/sizeof(chunk[0]);
+
+                    for (int x = 0; x < (int)srcRec.width; x += chunkSize)
+                    {
+                        int count = (((int)srcRec.width - x) < chunkSize)? ((int)srcRec.width - x) : chunkSize;
+                        for (int k = 0; k < count; k++) chunk[k] = GetPixelColor(pSrc + (x + k)*bytesPerPixelSrc, srcPtr->format);
+                        ImageBlendRGBA8(pDst + x*4, (unsigned char *)chunk, count, tint);
+                    }
+                }
+            }
             else
             {
                 for (int x = 0; x < (int)srcRec.width; x++)
@@ -4967,4 +5020,203 @@ static Vector4 *LoadImageDataNormalized(Image image)
     return pixels;
 }
 
+// Blend one RGBA8 src pixel over dst pixel
+static inline void ImageBlendPixelRGBA8(unsigned char *dst, const unsigned char *src, Color tint)
+{
+    Color colDst = { dst[0], dst[1], dst[2], dst[3] };
+    Color colSrc = { src[0], src[1], src[2], src[3] };
+    Color blend = ColorAlphaBlend(colDst, colSrc, tint);
+    memcpy(dst, &blend, sizeof(blend));
+}
+
+// Fill count RGBA8 pixels with color
+static void ImageFillRGBA8(unsigned char *dst, Color color, int count)
+{
+    unsigned int pixel = 0;
+    memcpy(&pixel, &color, sizeof(pixel));
+
+    int i = 0;
+#if defined(IMAGE_SIMD_AVX2)
+    __m256i pixels8 = _mm256_set1_epi32((int)pixel);
+    for (; (i + 8) <= count; i += 8) _mm256_storeu_si256((__m256i *)(dst + i*4), pixels8);
+#endif
+#if defined(IMAGE_SIMD_SSE2)
+    __m128i pixels4 = _mm_set1_epi32((int)pixel);
+    for (; (i + 4) <= count; i += 4) _mm_storeu_si128((__m128i *)(dst + i*4), pixels4);
+#elif defined(IMAGE_SIMD_NEON)
+    uint8x16_t pixels4 = vreinterpretq_u8_u32(vdupq_n_u32(pixel));
+    for (; (i + 4) <= count; i += 4) vst1q_u8(dst + i*4, pixels4);
+#endif
+    for (; i < count; i++) memcpy(dst + i*4, &pixel, sizeof(pixel));
+}
+
+// Blend count RGBA8 src pixels over dst pixels, same result as ColorAlphaBlend(dst, src, tint) per pixel
+// NOTE: Vectors only take destinations that are fully opaque or fully transparent, like framebuffers
+// and text images, ColorAlphaBlend() divides by the result alpha otherwise and is called per pixel
+static void ImageBlendRGBA8(unsigned char *dst, const unsigned char *src, int count, Color tint)
+{
+    int i = 0;
+#if defined(IMAGE_SIMD_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alphaMask = _mm_set1_epi32((int)0xff000000);
+    const __m128i tint16 = _mm_setr_epi16(tint.r + 1, tint.g + 1, tint.b + 1, tint.a + 1, tint.r + 1, tint.g + 1, tint.b + 1, tint.a + 1);
+    const __m128i full16 = _mm_set1_epi16(256);
+    const __m128i one16 = _mm_set1_epi16(1);
+    const __m128 invDivisor = _mm_set1_ps(1.0f/65280.0f);
+    const __m128i divisorMinusOne = _mm_set1_epi32(65279);
+
+    for (; (i + 4) <= count; i += 4)
+    {
+        __m128i d = _mm_loadu_si128((const __m128i *)(dst + i*4));
+        __m128i s = _mm_loadu_si128((const __m128i *)(src + i*4));
+
+        // Tint: s*(tint + 1) >> 8
+        __m128i sLo = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), tint16), 8);
+        __m128i sHi = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), tint16), 8);
+        s = _mm_packus_epi16(sLo, sHi);
+
+        __m128i srcAlpha = _mm_srli_epi32(s, 24);
+        __m128i srcClear = _mm_cmpeq_epi32(srcAlpha, zero);
+        __m128i srcOpaque = _mm_cmpeq_epi32(srcAlpha, _mm_set1_epi32(255));
+
+        // Fast path: Nothing to blend, common around glyphs and on solid shapes
+        if (_mm_movemask_epi8(srcClear) == 0xffff) continue;
+        if (_mm_movemask_epi8(srcOpaque) == 0xffff)
+        {
+            _mm_storeu_si128((__m128i *)(dst + i*4), s);
+            continue;
+        }
+
+        __m128i dstAlpha = _mm_and_si128(d, alphaMask);
+        __m128i dstOpaque = _mm_cmpeq_epi32(dstAlpha, alphaMask);
+        __m128i dstClear = _mm_cmpeq_epi32(dstAlpha, zero);
+        if (_mm_movemask_epi8(_mm_or_si128(dstOpaque, dstClear)) != 0xffff)
+        {
+            for (int k = 0; k < 4; k++) ImageBlendPixelRGBA8(dst + (i + k)*4, src + (i + k)*4, tint);
+            continue;
+        }
+
+        // alpha = src.a + 1, on every channel
+        __m128i alpha = _mm_or_si128(_mm_or_si128(srcAlpha, _mm_slli_epi32(srcAlpha, 8)), _mm_or_si128(_mm_slli_epi32(srcAlpha, 16), _mm_slli_epi32(srcAlpha, 24)));
+        __m128i alphaLo = _mm_add_epi16(_mm_unpacklo_epi8(alpha, zero), one16);
+        __m128i alphaHi = _mm_add_epi16(_mm_unpackhi_epi8(alpha, zero), one16);
+
+        // Opaque destination: (src*alpha*256 + dst*255*(256 - alpha))/255 >> 8, split as 256*a + 255*b over 255*256
+        __m128i aLo = _mm_mullo_epi16(sLo, alphaLo);
+        __m128i aHi = _mm_mullo_epi16(sHi, alphaHi);
+        __m128i bLo = _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), _mm_sub_epi16(full16, alphaLo));
+        __m128i bHi = _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), _mm_sub_epi16(full16, alphaHi));
+
+        __m128i a32[4] = { _mm_unpacklo_epi16(aLo, zero), _mm_unpackhi_epi16(aLo, zero), _mm_unpacklo_epi16(aHi, zero), _mm_unpackhi_epi16(aHi, zero) };
+        __m128i b32[4] = { _mm_unpacklo_epi16(bLo, zero), _mm_unpackhi_epi16(bLo, zero), _mm_unpacklo_epi16(bHi, zero), _mm_unpackhi_epi16(bHi, zero) };
+        __m128i q32[4] = { 0 };
+
+        for (int k = 0; k < 4; k++)
+        {
+            __m128i n = _mm_sub_epi32(_mm_add_epi32(_mm_slli_epi32(a32[k], 8), _mm_slli_epi32(b32[k], 8)), b32[k]);
+
+            // n < 2^25, so the float quotient is off by one at most, fixed with the remainder
+            __m128i q = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(n), invDivisor));
+            __m128i r = _mm_sub_epi32(n, _mm_sub_epi32(_mm_slli_epi32(q, 16), _mm_slli_epi32(q, 8)));
+            q = _mm_sub_epi32(q, _mm_cmpgt_epi32(r, divisorMinusOne));
+            q = _mm_add_epi32(q, _mm_cmplt_epi32(r, zero));
+            q32[k] = q;
+        }
+
+        __m128i blended = _mm_or_si128(_mm_packus_epi16(_mm_packs_epi32(q32[0], q32[1]), _mm_packs_epi32(q32[2], q32[3])), alphaMask);
+
+        // Transparent destination: src color with alpha + 1
+        __m128i over = _mm_add_epi32(s, _mm_set1_epi32(1 << 24));
+
+        __m128i out = _mm_or_si128(_mm_and_si128(dstOpaque, blended), _mm_andnot_si128(dstOpaque, over));
+        out = _mm_or_si128(_mm_and_si128(srcClear, d), _mm_andnot_si128(srcClear, out));
+        out = _mm_or_si128(_mm_and_si128(srcOpaque, s), _mm_andnot_si128(srcOpaque, out));
+
+        _mm_storeu_si128((__m128i *)(dst + i*4), out);
+    }
+#elif defined(IMAGE_SIMD_NEON)
+    const uint16x8_t tint16 = vcombine_u16(vcreate_u16(((uint64_t)(tint.a + 1) << 48) | ((uint64_t)(tint.b + 1) << 32) | ((uint64_t)(tint.g + 1) << 16) | (uint64_t)(tint.r + 1)),
+                                           vcreate_u16(((uint64_t)(tint.a + 1) << 48) | ((uint64_t)(tint.b + 1) << 32) | ((uint64_t)(tint.g + 1) << 16) | (uint64_t)(tint.r + 1)));
+    const uint32x4_t alphaMask = vdupq_n_u32(0xff000000);
+    const uint16x8_t full16 = vdupq_n_u16(256);
+    const float32x4_t invDivisor = vdupq_n_f32(1.0f/65280.0f);
+
+    for (; (i + 4) <= count; i += 4)
+    {
+        uint32x4_t d = vreinterpretq_u32_u8(vld1q_u8(dst + i*4));
+        uint8x16_t s8 = vld1q_u8(src + i*4);
+
+        // Tint: s*(tint + 1) >> 8
+        uint16x8_t sLo = vshrq_n_u16(vmulq_u16(vmovl_u8(vget_low_u8(s8)), tint16), 8);
+        uint16x8_t sHi = vshrq_n_u16(vmulq_u16(vmovl_u8(vget_high_u8(s8)), tint16), 8);
+        uint32x4_t s = vreinterpretq_u32_u8(vcombine_u8(vmovn_u16(sLo), vmovn_u16(sHi)));
+
+        uint32x4_t srcAlpha = vshrq_n_u32(s, 24);
+        uint32x4_t srcClear = vceqq_u32(srcAlpha, vdupq_n_u32(0));
+        uint32x4_t srcOpaque = vceqq_u32(srcAlpha, vdupq_n_u32(255));
+
+        // Fast path: Nothing to blend, common around glyphs and on solid shapes
+        uint32x2_t srcAlphaMax = vpmax_u32(vget_low_u32(srcAlpha), vget_high_u32(srcAlpha));
+        uint32x2_t srcAlphaMin = vpmin_u32(vget_low_u32(srcAlpha), vget_high_u32(srcAlpha));
+        if ((vget_lane_u32(srcAlphaMax, 0) | vget_lane_u32(srcAlphaMax, 1)) == 0) continue;
+        if ((vget_lane_u32(srcAlphaMin, 0) & vget_lane_u32(srcAlphaMin, 1)) == 255)
+        {
+            vst1q_u8(dst + i*4, vreinterpretq_u8_u32(s));
+            continue;
+        }
+
+        uint32x4_t dstAlpha = vandq_u32(d, alphaMask);
+        uint32x4_t dstOpaque = vceqq_u32(dstAlpha, alphaMask);
+        uint32x4_t dstClear = vceqq_u32(dstAlpha, vdupq_n_u32(0));
+        uint32x2_t valid = vand_u32(vget_low_u32(vorrq_u32(dstOpaque, dstClear)), vget_high_u32(vorrq_u32(dstOpaque, dstClear)));
+        if ((vget_lane_u32(valid, 0) & vget_lane_u32(valid, 1)) != 0xffffffff)
+        {
+            for (int k = 0; k < 4; k++) ImageBlendPixelRGBA8(dst + (i + k)*4, src + (i + k)*4, tint);
+            continue;
+        }
+
+        // alpha = src.a + 1, on every channel
+        uint8x16_t alpha = vreinterpretq_u8_u32(vmulq_n_u32(srcAlpha, 0x01010101));
+        uint16x8_t alphaLo = vaddq_u16(vmovl_u8(vget_low_u8(alpha)), vdupq_n_u16(1));
+        uint16x8_t alphaHi = vaddq_u16(vmovl_u8(vget_high_u8(alpha)), vdupq_n_u16(1));
+
+        // Opaque destination: (src*alpha*256 + dst*255*(256 - alpha))/255 >> 8, split as 256*a + 255*b over 255*256
+        uint8x16_t d8 = vreinterpretq_u8_u32(d);
+        uint16x8_t aLo = vmulq_u16(sLo, alphaLo);
+        uint16x8_t aHi = vmulq_u16(sHi, alphaHi);
+        uint16x8_t bLo = vmulq_u16(vmovl_u8(vget_low_u8(d8)), vsubq_u16(full16, alphaLo));
+        uint16x8_t bHi = vmulq_u16(vmovl_u8(vget_high_u8(d8)), vsubq_u16(full16, alphaHi));
+
+        uint32x4_t a32[4] = { vmovl_u16(vget_low_u16(aLo)), vmovl_u16(vget_high_u16(aLo)), vmovl_u16(vget_low_u16(aHi)), vmovl_u16(vget_high_u16(aHi)) };
+        uint32x4_t b32[4] = { vmovl_u16(vget_low_u16(bLo)), vmovl_u16(vget_high_u16(bLo)), vmovl_u16(vget_low_u16(bHi)), vmovl_u16(vget_high_u16(bHi)) };
+        uint16x4_t q16[4];
+
+        for (int k = 0; k < 4; k++)
+        {
+            int32x4_t n = vreinterpretq_s32_u32(vsubq_u32(vaddq_u32(vshlq_n_u32(a32[k], 8), vshlq_n_u32(b32[k], 8)), b32[k]));
+
+            // n < 2^25, so the float quotient is off by one at most, fixed with the remainder
+            int32x4_t q = vcvtq_s32_f32(vmulq_f32(vcvtq_f32_s32(n), invDivisor));
+            int32x4_t r = vsubq_s32(n, vsubq_s32(vshlq_n_s32(q, 16), vshlq_n_s32(q, 8)));
+            q = vsubq_s32(q, vreinterpretq_s32_u32(vcgtq_s32(r, vdupq_n_s32(65279))));
+            q = vaddq_s32(q, vreinterpretq_s32_u32(vcltq_s32(r, vdupq_n_s32(0))));
+            q16[k] = vqmovun_s32(q);
+        }
+
+        uint8x16_t blended8 = vcombine_u8(vqmovn_u16(vcombine_u16(q16[0], q16[1])), vqmovn_u16(vcombine_u16(q16[2], q16[3])));
+        uint32x4_t blended = vorrq_u32(vreinterpretq_u32_u8(blended8), alphaMask);
+
+        // Transparent destination: src color with alpha + 1
+        uint32x4_t over = vaddq_u32(s, vdupq_n_u32(1u << 24));
+
+        uint32x4_t out = vbslq_u32(dstOpaque, blended, over);
+        out = vbslq_u32(srcClear, d, out);
+        out = vbslq_u32(srcOpaque, s, out);
+
+        vst1q_u8(dst + i*4, vreinterpretq_u8_u32(out));
+    }
+#endif
+    for (; i < count; i++) ImageBlendPixelRGBA8(dst + i*4, src + i*4, tint);
+}
+
 #endif      // SUPPORT_MODULE_RTEXTURES
@@ -66,6 +66,9 @@ static LoadFileDataCallback loadFileData = NULL;    // LoadFileData callback fun
 static SaveFileDataCallback saveFileData = NULL;    // SaveFileText callback function pointer
 static LoadFileTextCallback loadFileText = NULL;    // LoadFileText callback function pointer
 static SaveFileTextCallback saveFileText = NULL;    // SaveFileText callback function pointer
+static MemAllocCallback memAlloc = NULL;            // MemAlloc callback function pointer
+static MemReallocCallback memRealloc = NULL;        // MemRealloc callback function pointer
+static MemFreeCallback memFree = NULL;              // MemFree callback function pointer
 
 //----------------------------------------------------------------------------------
 // Functions to set internal callbacks
@@ -76,6 +79,18 @@ void SetSaveFileDataCallback(SaveFileDataCallback callback) { saveFileData = cal
 void SetLoadFileTextCallback(LoadFileTextCallback callback) { loadFileText = callback; }  // Set custom file text loader
 void SetSaveFileTextCallback(SaveFileTextCallback callback) { saveFileText = callback; }  // Set custom file text saver
 
+// Set custom memory allocator
+// NOTE: Allocations made before this call are released with the new callbacks, set them up first
+void SetMemoryCallbacks(MemAllocCallback allocCallback, MemReallocCallback reallocCallback, MemFreeCallback freeCallback)
+{
+#if !defined(RL_MEMORY_CALLBACKS)
+    TRACELOG(LOG_WARNING, "SYSTEM: raylib compiled without RL_MEMORY_CALLBACKS, memory callbacks ignored");
+#endif
+    memAlloc = allocCallback;
+    memRealloc = reallocCallback;
+    memFree = freeCallback;
+}
+
 
 #if defined(PLATFORM_ANDROID)
 static AAssetManager *assetManager = NULL;          // Android assets manager pointer
@@ -179,6 +194,39 @@ void MemFree(void *ptr)
     RL_FREE(ptr);
 }
 
+#if defined(RL_MEMORY_CALLBACKS)
+// Internal allocation through memory callbacks, file and line identify the call site
+void *MemAllocAt(unsigned int size, const char *file, int line)
+{
+    if (memAlloc != NULL) return memAlloc(size, file, line);
+    return malloc(size);
+}
+
+// Internal zeroed allocation through memory callbacks
+void *MemCallocAt(unsigned int count, unsigned int size, const char *file, int line)
+{
+    if (memAlloc == NULL) return calloc(count, size);
+
+    void *ptr = memAlloc(count*size, file, line);
+    if (ptr != NULL) memset(ptr, 0, count*size);
+    return ptr;
+}
+
+// Internal reallocation through memory callbacks
+void *MemReallocAt(void *ptr, unsigned int size, const char *file, int line)
+{
+    if (memRealloc != NULL) return memRealloc(ptr, size, file, line);
+    return realloc(ptr, size);
+}
+
+// Internal free through memory callbacks
+void MemFreeAt(void *ptr, const char *file, int line)
+{
+    if (memFree != NULL) memFree(ptr, file, line);
+    else free(ptr);
+}
+#endif
+
 // Load data from file into a buffer
 unsigned char *LoadFileData(const char *fileName, int *dataSize)
 {
@@ -0,0 +1,229 @@
+// Word finder over words.c and any other word lists, `./comp find` builds and
+// runs it.
+//
+// A pattern like `a?e?s` fixes letters by position, and the letter sets on
+// top of it narrow it down the way a Wordle board does: letters the word has
+// somewhere, letters it has nowhere and letters it can't have at a position.
+// The lists are put into a Vocab_Columns once and a query is one pass of
+// vector compares over it, see vocab_columns_match().
+//
+// --from and --anagram look words up by their letters instead, through a
+// Vocab_Anagrams. Given along with a pattern only the words both find are
+// printed.
+
+// For clock_gettime() in time_now_ns()
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#define COMP_IMPLEMENTATION
+#include "./comp.h"
+
+#define VOCAB_IMPLEMENTATION
+#include "./vocab.h"
+
+#include "words.c"
+
+// Lowercases `text` into a letter set, false if it has anything but letters
+static bool parse_letters(Cstr text, uint32_t *set) {
+    for (Cstr it = text; *it != '\0'; ++it) {
+        char c = *it;
+        if (c >= 'A' && c <= 'Z') c = (char) (c - 'A' + 'a');
+        if (c < 'a' || c > 'z') return false;
+        *set |= 1u << (c - 'a');
+    }
+    return true;
+}
+
+// Adds the words of a list, one per line, to `list`. Lines that aren't
+// VOCAB_WORD_LENGTH letters are skipped and so are words already in `seen`
+static bool load_words(Cstr path, Da_Cstr *list, Hash_Set_Cstr *seen) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "Error: could not open word list '%s'\n", path);
+        return false;
+    }
+    static char line[256];
+    size_t skipped = 0;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        size_t length = strcspn(line, "\r\n");
+        line[length] = '\0';
+        if (length == 0) continue;
+        for (size_t j = 0; j < length; ++j) {
+            if (line[j] >= 'A' && line[j] <= 'Z') line[j] = (char) (line[j] - 'A' + 'a');
+        }
+        if (length != VOCAB_WORD_LENGTH || vocab_word_key(line) == 0) {
+            skipped += 1;
+            continue;
+        }
+        if (hash_set_cstr_contains(seen, line)) continue;
+        char *word = comp_realloc(NULL, VOCAB_WORD_LENGTH + 1);
+        assert(word != NULL && "Buy more RAM lol");
+        memcpy(word, line, VOCAB_WORD_LENGTH + 1);
+        hash_set_cstr_insert(seen, word);
+        da_append(list, word);
+    }
+    fclose(file);
+    if (skipped > 0) {
+        fprintf(stderr, "Warning: skipped %zu lines of '%s' that aren't %d letter words\n", skipped, path, VOCAB_WORD_LENGTH);
+    }
+    return true;
+}
+
+// Keeps the indices in both lists, both in list order
+static size_t intersect(size_t *a, size_t a_count, const size_t *b, size_t b_count) {
+    size_t count = 0;
+    size_t j = 0;
+    for (size_t i = 0; i < a_count; ++i) {
+        while (j < b_count && b[j] < a[i]) j += 1;
+        if (j < b_count && b[j] == a[i]) a[count++] = a[i];
+    }
+    return count;
+}
+
+static void usage(Cstr program) {
+    fprintf(stderr, "Usage: %s [options] [pattern]\n", program);
+    fprintf(stderr, "    pattern              a letter or '?' for each of the %d positions (default all '?')\n", VOCAB_WORD_LENGTH);
+    fprintf(stderr, "    --has <letters>      letters the word has somewhere\n");
+    fprintf(stderr, "    --not <letters>      letters the word has nowhere\n");
+    fprintf(stderr, "    --not-at <n:letters> letters the word can't have at position n, from 1\n");
+    fprintf(stderr, "    --from <letters>     only words spelled from these letters, each used once\n");
+    fprintf(stderr, "    --anagram <word>     only words with the same letters as this one\n");
+    fprintf(stderr, "    --words <file>       also look through this list, one word per line, can be repeated\n");
+    fprintf(stderr, "    --count              only print how many words match\n");
+    fprintf(stderr, "    --time               print how long the search took to stderr\n");
+}
+
+int main(int argc, const char **argv) {
+    Vocab_Pattern pattern = {0};
+    Da_Cstr paths = {0};
+    bool count_only = false;
+    bool timed = false;
+    Cstr from = NULL;
+    Cstr anagram = NULL;
+    char anagram_word[VOCAB_WORD_LENGTH + 1] = {0};
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--has") == 0 && i + 1 < argc) {
+            if (!parse_letters(argv[++i], &pattern.has)) {
+                fprintf(stderr, "Error: '%s' is not a list of letters\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--not") == 0 && i + 1 < argc) {
+            if (!parse_letters(argv[++i], &pattern.lacks)) {
+                fprintf(stderr, "Error: '%s' is not a list of letters\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--not-at") == 0 && i + 1 < argc) {
+            Cstr arg = argv[++i];
+            char *end = NULL;
+            unsigned long position = strtoul(arg, &end, 10);
+            if (position < 1 || position > VOCAB_WORD_LENGTH || *end != ':' || !parse_letters(end + 1, &pattern.not_at[position - 1])) {
+                fprintf(stderr, "Error: '%s' is not a position from 1 to %d, a ':' and letters\n", arg, VOCAB_WORD_LENGTH);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--from") == 0 && i + 1 < argc) {
+            from = argv[++i];
+        } else if (strcmp(argv[i], "--anagram") == 0 && i + 1 < argc) {
+            Cstr arg = argv[++i];
+            size_t length = strlen(arg);
+            for (size_t j = 0; j < length && j < VOCAB_WORD_LENGTH; ++j) {
+                char c = arg[j];
+                anagram_word[j] = c >= 'A' && c <= 'Z' ? (char) (c - 'A' + 'a') : c;
+            }
+            if (length != VOCAB_WORD_LENGTH || vocab_word_key(anagram_word) == 0) {
+                fprintf(stderr, "Error: '%s' is not %d letters\n", arg, VOCAB_WORD_LENGTH);
+                return 1;
+            }
+            anagram = anagram_word;
+        } else if (strcmp(argv[i], "--words") == 0 && i + 1 < argc) {
+            da_append(&paths, argv[++i]);
+        } else if (strcmp(argv[i], "--count") == 0) {
+            count_only = true;
+        } else if (strcmp(argv[i], "--time") == 0) {
+            timed = true;
+        } else if (argv[i][0] != '-') {
+            // The sets given so far stay, only the letters come from the pattern
+            Vocab_Pattern parsed;
+            if (!vocab_pattern_parse(&parsed, argv[i])) {
+                fprintf(stderr, "Error: '%s' is not %d letters or '?'\n", argv[i], VOCAB_WORD_LENGTH);
+                return 1;
+            }
+            memcpy(pattern.letters, parsed.letters, sizeof(pattern.letters));
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    Da_Cstr list = {0};
+    Hash_Set_Cstr seen = {0};
+    for (size_t i = 0; i < words_count; ++i) {
+        hash_set_cstr_insert(&seen, words[i]);
+        da_append(&list, words[i]);
+    }
+    for (size_t i = 0; i < paths.count; ++i) {
+        if (!load_words(paths.items[i], &list, &seen)) return 1;
+    }
+
+    Vocab_Columns columns;
+    vocab_columns_init(&columns, list.items, list.count);
+    size_t *matches = comp_realloc(NULL, (list.count + 1)*sizeof(size_t));
+    assert(matches != NULL && "Buy more RAM lol");
+
+    Vocab_Anagrams anagrams = {0};
+    size_t *others = NULL;
+    if (from != NULL || anagram != NULL) {
+        vocab_anagrams_init(&anagrams, list.items, list.count);
+        others = comp_realloc(NULL, (list.count + 1)*sizeof(size_t));
+        assert(others != NULL && "Buy more RAM lol");
+    }
+    // Without a pattern the letters alone pick the words
+    static const Vocab_Pattern any = {0};
+    bool patterned = from == NULL && anagram == NULL;
+    patterned = patterned || memcmp(&pattern, &any, sizeof(pattern)) != 0;
+
+    uint64_t start = time_now_ns();
+    size_t count = 0;
+    if (patterned) {
+        count = vocab_columns_match(&columns, &pattern, matches, list.count);
+    }
+    if (from != NULL) {
+        size_t others_count = vocab_anagrams_within(&anagrams, vocab_letters(from, strlen(from)), others, list.count);
+        if (patterned) {
+            count = intersect(matches, count, others, others_count);
+        } else {
+            memcpy(matches, others, others_count*sizeof(size_t));
+            count = others_count;
+        }
+        patterned = true;
+    }
+    if (anagram != NULL) {
+        // A group is in list order already, the index breaks ties in the sort
+        Vocab_Prefix_Range range = vocab_anagrams_find(&anagrams, anagram);
+        size_t others_count = range.end - range.begin;
+        for (size_t i = 0; i < others_count; ++i) {
+            others[i] = anagrams.order[range.begin + i];
+        }
+        if (patterned) {
+            count = intersect(matches, count, others, others_count);
+        } else {
+            memcpy(matches, others, others_count*sizeof(size_t));
+            count = others_count;
+        }
+    }
+    uint64_t elapsed = time_now_ns() - start;
+
+    if (count_only) {
+        printf("%zu\n", count);
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            printf("%s\n", list.items[matches[i]]);
+        }
+    }
+    if (timed) {
+        fprintf(stderr, "%zu of %zu words in %.1f us\n", count, list.count, (double) elapsed / 1000.0);
+    }
+    return 0;
+}
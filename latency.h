@@ -0,0 +1,167 @@
+#ifndef LATENCY_H_
+#define LATENCY_H_
+
+// Input-to-photon latency. Every input event accepted in a frame is followed
+// through the stages of that frame and recorded once the GPU is done with it.
+// No raylib or GL in here, the caller provides the times (seconds, one clock)
+// and the GPU completion time of each frame when it becomes known.
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Samples kept per stage, older ones are overwritten
+#define LATENCY_SAMPLES_CAP (16*1024)
+// Frames that can wait for the GPU at once, a frame that is still waiting
+// when its slot comes around again is not measured
+#define LATENCY_FRAMES_IN_FLIGHT 8
+// Events of one frame that are measured, the rest are only counted
+#define LATENCY_FRAME_EVENTS_CAP 32
+
+typedef enum {
+    LATENCY_LAYOUT = 0, // Layout and draw calls done
+    LATENCY_SUBMIT,     // Render batch handed to the GPU
+    LATENCY_SWAP,       // Swap buffers returned
+    LATENCY_GPU,        // GPU finished rendering the frame
+    LATENCY_STAGES_COUNT,
+} Latency_Stage;
+
+typedef struct {
+    double items[LATENCY_SAMPLES_CAP];
+    // Samples ever recorded, only the last LATENCY_SAMPLES_CAP are kept
+    size_t count;
+} Latency_Samples;
+
+typedef struct {
+    double input_times[LATENCY_FRAME_EVENTS_CAP];
+    size_t input_count;
+    double stage_times[LATENCY_STAGES_COUNT];
+    bool pending;
+} Latency_Frame;
+
+typedef struct {
+    Latency_Samples stages[LATENCY_STAGES_COUNT];
+    Latency_Frame frames[LATENCY_FRAMES_IN_FLIGHT];
+    size_t current;
+    size_t frames_count;
+    size_t unmeasured;
+} Latency;
+
+void latency_samples_push(Latency_Samples *samples, double sample);
+// `p` in [0, 1] over the kept samples, sorts them, at least one sample is needed
+double latency_samples_percentile(Latency_Samples *samples, double p);
+
+// Starts a frame, returns its slot in `frames` so per-slot GPU queries can be
+// matched up with latency_resolve() later
+size_t latency_frame_begin(Latency *latency);
+void latency_input(Latency *latency, double time);
+void latency_stage(Latency *latency, Latency_Stage stage, double time);
+// The frame waits for latency_resolve() if it had any input
+void latency_frame_end(Latency *latency);
+// `gpu_time` is when the GPU finished the frame, negative if it can't be known
+void latency_resolve(Latency *latency, size_t slot, double gpu_time);
+// Percentiles per stage, sorts the kept samples
+void latency_report(Latency *latency, FILE *stream);
+
+#endif // LATENCY_H_
+
+#ifdef LATENCY_IMPLEMENTATION
+#undef LATENCY_IMPLEMENTATION
+
+#include <stdlib.h>
+
+size_t latency_frame_begin(Latency *latency) {
+    latency->current = latency->frames_count % LATENCY_FRAMES_IN_FLIGHT;
+    latency->frames_count += 1;
+
+    Latency_Frame *frame = &latency->frames[latency->current];
+    if (frame->pending) {
+        latency->unmeasured += frame->input_count;
+    }
+    frame->input_count = 0;
+    frame->pending = false;
+    return latency->current;
+}
+
+void latency_input(Latency *latency, double time) {
+    Latency_Frame *frame = &latency->frames[latency->current];
+    if (frame->input_count < LATENCY_FRAME_EVENTS_CAP) {
+        frame->input_times[frame->input_count++] = time;
+    } else {
+        latency->unmeasured += 1;
+    }
+}
+
+void latency_stage(Latency *latency, Latency_Stage stage, double time) {
+    latency->frames[latency->current].stage_times[stage] = time;
+}
+
+void latency_frame_end(Latency *latency) {
+    Latency_Frame *frame = &latency->frames[latency->current];
+    frame->pending = frame->input_count > 0;
+}
+
+void latency_samples_push(Latency_Samples *samples, double sample) {
+    samples->items[samples->count % LATENCY_SAMPLES_CAP] = sample;
+    samples->count += 1;
+}
+
+void latency_resolve(Latency *latency, size_t slot, double gpu_time) {
+    Latency_Frame *frame = &latency->frames[slot];
+    if (!frame->pending) return;
+    frame->stage_times[LATENCY_GPU] = gpu_time;
+
+    for (size_t i = 0; i < frame->input_count; ++i) {
+        for (size_t stage = 0; stage < LATENCY_STAGES_COUNT; ++stage) {
+            if (stage == LATENCY_GPU && gpu_time < 0) continue;
+            latency_samples_push(&latency->stages[stage], frame->stage_times[stage] - frame->input_times[i]);
+        }
+    }
+    frame->pending = false;
+}
+
+static int latency_compare(const void *a, const void *b) {
+    double x = *(const double *) a;
+    double y = *(const double *) b;
+    return (x > y) - (x < y);
+}
+
+double latency_samples_percentile(Latency_Samples *samples, double p) {
+    size_t kept = samples->count < LATENCY_SAMPLES_CAP ? samples->count : LATENCY_SAMPLES_CAP;
+    qsort(samples->items, kept, sizeof(samples->items[0]), latency_compare);
+    size_t index = (size_t) (p * (double) (kept - 1) + 0.5);
+    return samples->items[index];
+}
+
+void latency_report(Latency *latency, FILE *stream) {
+    static const char *names[LATENCY_STAGES_COUNT] = {
+        [LATENCY_LAYOUT] = "layout",
+        [LATENCY_SUBMIT] = "submit",
+        [LATENCY_SWAP] = "swap",
+        [LATENCY_GPU] = "gpu",
+    };
+
+    fprintf(stream, "[LATENCY]: input to stage, milliseconds\n");
+    fprintf(stream, "[LATENCY]: %-8s %8s %8s %8s %8s %8s %8s\n",
+        "stage", "events", "p50", "p90", "p99", "p99.9", "max");
+    for (size_t stage = 0; stage < LATENCY_STAGES_COUNT; ++stage) {
+        Latency_Samples *samples = &latency->stages[stage];
+        if (samples->count == 0) {
+            fprintf(stream, "[LATENCY]: %-8s %8s\n", names[stage], "n/a");
+            continue;
+        }
+
+        fprintf(stream, "[LATENCY]: %-8s %8zu %8.2f %8.2f %8.2f %8.2f %8.2f\n",
+            names[stage], samples->count,
+            latency_samples_percentile(samples, 0.50) * 1e3,
+            latency_samples_percentile(samples, 0.90) * 1e3,
+            latency_samples_percentile(samples, 0.99) * 1e3,
+            latency_samples_percentile(samples, 0.999) * 1e3,
+            latency_samples_percentile(samples, 1.0) * 1e3);
+    }
+    if (latency->unmeasured > 0) {
+        fprintf(stream, "[LATENCY]: %zu events were not measured\n", latency->unmeasured);
+    }
+}
+
+#endif // LATENCY_IMPLEMENTATION
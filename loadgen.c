@@ -0,0 +1,1035 @@
+// Load generator and soak test for server.c, `./comp loadgen` builds and runs it.
+//
+// Opens many connections to a server on the same machine and plays games on
+// all of them, either as fast as the server answers or at a fixed total rate
+// of requests. Every connection has one request in flight at a time. Guesses
+// come from words.c at random, from a script or from a solver that only
+// guesses words still consistent with the colors it got so far.
+//
+// Every response is checked: the line has to parse, colors have to agree with
+// the answer revealed when a game is lost, a won game has to be all green and
+// the solver's candidates must never lose the answer. Anything else is
+// counted as a protocol error, the connection is dropped and made again.
+//
+// Latency goes into log-linear histograms (HDR style, under 1% error) per
+// worker thread, merged and printed every --report seconds along with the
+// throughput, and for the whole run at the end. With --rate the latency is
+// also measured from when a request was meant to be sent, so a stalled
+// server can't hide behind the requests it held back.
+
+// For SOCK_NONBLOCK and SOCK_CLOEXEC
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <signal.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#ifndef __linux__
+    #error "The load generator needs epoll, it only builds on Linux"
+#endif
+
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+#define COMP_IMPLEMENTATION
+#include "./comp.h"
+
+#define VOCAB_IMPLEMENTATION
+#include "./vocab.h"
+
+#include "words.c"
+
+#define LOAD_WORKERS_CAP 64
+#define LOAD_EVENTS_CAP 256
+#define LOAD_IN_CAP 64
+#define LOAD_RECONNECT_NS 100000000ULL
+// heap_index of a connection that is not in the heap
+#define LOAD_NOT_QUEUED SIZE_MAX
+// Protocol errors printed in full, the rest are only counted
+#define LOAD_ERRORS_SHOWN 10
+
+//------------------------------------------------------------------------------
+// Histogram
+//------------------------------------------------------------------------------
+
+// Values below 2^HIST_SUB_BITS are exact, above that every power of two is
+// split into 2^(HIST_SUB_BITS - 1) buckets, so a value is off by under 1%
+#define HIST_SUB_BITS 8
+#define HIST_HALF (1 << (HIST_SUB_BITS - 1))
+#define HIST_BUCKETS ((64 - HIST_SUB_BITS + 2) * HIST_HALF)
+
+typedef struct {
+    uint64_t counts[HIST_BUCKETS];
+    uint64_t total;
+    uint64_t max;
+} Histogram;
+
+static size_t hist_index(uint64_t value) {
+    if (value < (1 << HIST_SUB_BITS)) return (size_t) value;
+    int shift = 63 - __builtin_clzll(value) - (HIST_SUB_BITS - 1);
+    return (size_t) shift * HIST_HALF + (size_t) (value >> shift);
+}
+
+// Middle of the values that end up in bucket `index`
+static uint64_t hist_value(size_t index) {
+    if (index < (1 << HIST_SUB_BITS)) return index;
+    size_t shift = index / HIST_HALF - 1;
+    uint64_t low = (uint64_t) (index - shift * HIST_HALF) << shift;
+    return low + ((1ULL << shift) >> 1);
+}
+
+static void hist_record(Histogram *hist, uint64_t value) {
+    hist->counts[hist_index(value)] += 1;
+    hist->total += 1;
+    if (value > hist->max) hist->max = value;
+}
+
+static void hist_merge(Histogram *dst, const Histogram *src) {
+    for (size_t i = 0; i < HIST_BUCKETS; ++i) {
+        dst->counts[i] += src->counts[i];
+    }
+    dst->total += src->total;
+    if (src->max > dst->max) dst->max = src->max;
+}
+
+// `p` in [0, 1], the max for 1
+static uint64_t hist_percentile(const Histogram *hist, double p) {
+    if (hist->total == 0) return 0;
+    if (p >= 1.0) return hist->max;
+    uint64_t rank = (uint64_t) (p * (double) hist->total) + 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < HIST_BUCKETS; ++i) {
+        seen += hist->counts[i];
+        if (seen >= rank) {
+            uint64_t value = hist_value(i);
+            return value < hist->max ? value : hist->max;
+        }
+    }
+    return hist->max;
+}
+
+static void hist_print(FILE *stream, Cstr prefix, Cstr name, const Histogram *hist) {
+    fprintf(stream, "%s%s us: p50 %.1f, p90 %.1f, p99 %.1f, p99.9 %.1f, p99.99 %.1f, max %.1f\n",
+        prefix, name,
+        hist_percentile(hist, 0.50) * 1e-3,
+        hist_percentile(hist, 0.90) * 1e-3,
+        hist_percentile(hist, 0.99) * 1e-3,
+        hist_percentile(hist, 0.999) * 1e-3,
+        hist_percentile(hist, 0.9999) * 1e-3,
+        hist_percentile(hist, 1.0) * 1e-3);
+}
+
+//------------------------------------------------------------------------------
+// Connections
+//------------------------------------------------------------------------------
+
+typedef enum {
+    STRATEGY_RANDOM = 0,
+    STRATEGY_SOLVER,
+    STRATEGY_SCRIPT,
+} Strategy;
+
+typedef enum {
+    CONN_DOWN = 0,    // Waiting to connect
+    CONN_CONNECTING,
+    CONN_GREETING,    // Connected, the server did not say hello yet
+    CONN_IDLE,        // Waiting for its next send time
+    CONN_WAITING,     // Request in flight
+} Conn_State;
+
+typedef struct {
+    int fd;
+    Conn_State state;
+    // Send time of the next request, or of the reconnect, in the worker's heap
+    uint64_t due_ns;
+    size_t heap_index; // LOAD_NOT_QUEUED outside of the heap
+    // The request in flight, when it was meant to go out and when it did
+    uint64_t scheduled_ns;
+    uint64_t sent_ns;
+    char in[LOAD_IN_CAP];
+    size_t in_count;
+
+    bool sent_new;
+    bool game_over;
+    size_t attempt;
+    char guess[VOCAB_WORD_LENGTH + 1];
+    // Next line of the script
+    size_t script_index;
+    // Solver only, bit per word that is still a possible answer
+    uint64_t *candidates;
+} Conn;
+
+typedef struct {
+    size_t requests;
+    size_t games_won;
+    size_t games_lost;
+    size_t protocol_errors;
+    size_t disconnects;
+    size_t connect_errors;
+} Load_Counters;
+
+typedef struct {
+    size_t index;
+    pthread_t thread;
+    int epoll_fd;
+    int timer_fd;
+    uint64_t rng;
+
+    Conn *conns;
+    size_t conns_count;
+    // Min-heap on due_ns of the connections that wait for something
+    Conn **heap;
+    size_t heap_count;
+
+    // Taken once per batch of events by the worker and once per report by the
+    // main thread, which takes `interval` and leaves it empty
+    pthread_mutex_t mutex;
+    Histogram interval;
+    Histogram interval_corrected;
+    Load_Counters counters;
+} Worker;
+
+static struct {
+    Strategy strategy;
+    Cstr *script;
+    size_t script_count;
+    // Nanoseconds between two requests of one connection, 0 sends right away
+    uint64_t interval_ns;
+    struct sockaddr_storage addr;
+    socklen_t addr_len;
+    bool tcp;
+} config = {0};
+
+static Hash_Set_Cstr words_set = {0};
+static Worker workers[LOAD_WORKERS_CAP] = {0};
+static size_t workers_count = 0;
+static atomic_bool stopping = false;
+static atomic_size_t errors_shown = 0;
+
+static uint64_t worker_random(Worker *worker) {
+    // xorshift64*
+    worker->rng ^= worker->rng >> 12;
+    worker->rng ^= worker->rng << 25;
+    worker->rng ^= worker->rng >> 27;
+    return worker->rng * 0x2545F4914F6CDD1DULL;
+}
+
+//------------------------------------------------------------------------------
+// Heap of connections waiting for their time
+//------------------------------------------------------------------------------
+
+static void heap_swap(Worker *worker, size_t a, size_t b) {
+    Conn *tmp = worker->heap[a];
+    worker->heap[a] = worker->heap[b];
+    worker->heap[b] = tmp;
+    worker->heap[a]->heap_index = a;
+    worker->heap[b]->heap_index = b;
+}
+
+static void heap_sift_up(Worker *worker, size_t i) {
+    while (i > 0 && worker->heap[(i - 1) / 2]->due_ns > worker->heap[i]->due_ns) {
+        heap_swap(worker, i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+}
+
+static void heap_sift_down(Worker *worker, size_t i) {
+    for (;;) {
+        size_t smallest = i;
+        size_t l = 2*i + 1;
+        size_t r = 2*i + 2;
+        if (l < worker->heap_count && worker->heap[l]->due_ns < worker->heap[smallest]->due_ns) smallest = l;
+        if (r < worker->heap_count && worker->heap[r]->due_ns < worker->heap[smallest]->due_ns) smallest = r;
+        if (smallest == i) break;
+        heap_swap(worker, i, smallest);
+        i = smallest;
+    }
+}
+
+static void heap_remove(Worker *worker, Conn *conn) {
+    size_t i = conn->heap_index;
+    assert(i < worker->heap_count && worker->heap[i] == conn);
+    worker->heap_count -= 1;
+    if (i < worker->heap_count) {
+        // The last one takes its place and goes whichever way it has to
+        heap_swap(worker, i, worker->heap_count);
+        Conn *moved = worker->heap[i];
+        heap_sift_up(worker, i);
+        heap_sift_down(worker, moved->heap_index);
+    }
+    conn->heap_index = LOAD_NOT_QUEUED;
+}
+
+// A connection is in the heap once, pushing it again moves it to `due_ns`
+static void heap_push(Worker *worker, Conn *conn, uint64_t due_ns) {
+    if (conn->heap_index != LOAD_NOT_QUEUED) heap_remove(worker, conn);
+    conn->due_ns = due_ns;
+    size_t i = worker->heap_count++;
+    worker->heap[i] = conn;
+    conn->heap_index = i;
+    heap_sift_up(worker, i);
+}
+
+static Conn *heap_pop(Worker *worker) {
+    Conn *top = worker->heap[0];
+    heap_remove(worker, top);
+    return top;
+}
+
+static void worker_arm_timer(Worker *worker) {
+    struct itimerspec spec = {0};
+    if (worker->heap_count > 0) {
+        uint64_t due = worker->heap[0]->due_ns;
+        // A zero it_value disarms the timer, due times are never that early
+        spec.it_value.tv_sec = (time_t) (due / 1000000000);
+        spec.it_value.tv_nsec = (long) (due % 1000000000);
+    }
+    timerfd_settime(worker->timer_fd, TFD_TIMER_ABSTIME, &spec, NULL);
+}
+
+//------------------------------------------------------------------------------
+// Games
+//------------------------------------------------------------------------------
+
+static void conn_error(Worker *worker, Conn *conn, const char *line, const char *what) {
+    worker->counters.protocol_errors += 1;
+    if (atomic_fetch_add(&errors_shown, 1) < LOAD_ERRORS_SHOWN) {
+        fprintf(stderr, "Error: connection %zu: %s: '%s'\n", (size_t) (conn - worker->conns), what, line);
+    }
+}
+
+static void conn_new_game(Conn *conn) {
+    conn->game_over = false;
+    conn->attempt = 0;
+    if (conn->candidates != NULL) {
+        size_t words64 = (words_count + 63) / 64;
+        memset(conn->candidates, 0xFF, words64 * sizeof(uint64_t));
+        if (words_count % 64 != 0) conn->candidates[words64 - 1] = (1ULL << (words_count % 64)) - 1;
+    }
+}
+
+static Cstr conn_pick_guess(Worker *worker, Conn *conn) {
+    switch (config.strategy) {
+    case STRATEGY_SCRIPT:
+        return config.script[conn->script_index++ % config.script_count];
+    case STRATEGY_SOLVER: {
+        // A random word among the ones that could still be the answer
+        size_t words64 = (words_count + 63) / 64;
+        size_t left = 0;
+        for (size_t i = 0; i < words64; ++i) left += (size_t) __builtin_popcountll(conn->candidates[i]);
+        if (left == 0) break;
+        size_t pick = worker_random(worker) % left;
+        for (size_t i = 0; i < words64; ++i) {
+            size_t here = (size_t) __builtin_popcountll(conn->candidates[i]);
+            if (pick >= here) {
+                pick -= here;
+                continue;
+            }
+            uint64_t bits = conn->candidates[i];
+            while (pick-- > 0) bits &= bits - 1;
+            return words[i*64 + (size_t) __builtin_ctzll(bits)];
+        }
+    } break;
+    case STRATEGY_RANDOM:
+        break;
+    }
+    return words[worker_random(worker) % words_count];
+}
+
+static void conn_close(Worker *worker, Conn *conn, uint64_t now) {
+    if (conn->fd >= 0) close(conn->fd);
+    conn->fd = -1;
+    conn->state = CONN_DOWN;
+    heap_push(worker, conn, now + LOAD_RECONNECT_NS);
+}
+
+static void conn_connect(Worker *worker, Conn *conn, uint64_t now) {
+    conn->fd = socket(config.addr.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (conn->fd < 0) {
+        worker->counters.connect_errors += 1;
+        conn_close(worker, conn, now);
+        return;
+    }
+    if (config.tcp) {
+        int one = 1;
+        setsockopt(conn->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    if (connect(conn->fd, (struct sockaddr *) &config.addr, config.addr_len) < 0 && errno != EINPROGRESS) {
+        worker->counters.connect_errors += 1;
+        conn_close(worker, conn, now);
+        return;
+    }
+
+    conn->state = CONN_CONNECTING;
+    conn->in_count = 0;
+    struct epoll_event event = { .events = EPOLLOUT | EPOLLIN | EPOLLRDHUP, .data.ptr = conn };
+    if (epoll_ctl(worker->epoll_fd, EPOLL_CTL_ADD, conn->fd, &event) < 0) {
+        worker->counters.connect_errors += 1;
+        conn_close(worker, conn, now);
+    }
+}
+
+// Sends the next request of `conn` that was due at `scheduled`
+static void conn_send(Worker *worker, Conn *conn, uint64_t scheduled, uint64_t now) {
+    char request[16];
+    int length;
+    if (conn->game_over) {
+        conn->sent_new = true;
+        length = snprintf(request, sizeof(request), "new\n");
+    } else {
+        conn->sent_new = false;
+        memcpy(conn->guess, conn_pick_guess(worker, conn), VOCAB_WORD_LENGTH);
+        length = snprintf(request, sizeof(request), "guess %.*s\n", VOCAB_WORD_LENGTH, conn->guess);
+    }
+
+    // One short request in flight never fills a socket buffer, a partial send
+    // is as good as a dead connection
+    ssize_t n = send(conn->fd, request, (size_t) length, MSG_NOSIGNAL);
+    if (n != length) {
+        worker->counters.disconnects += 1;
+        conn_close(worker, conn, now);
+        return;
+    }
+    conn->scheduled_ns = scheduled;
+    conn->sent_ns = now;
+    conn->state = CONN_WAITING;
+}
+
+// Queues the next request, right away without a rate
+static void conn_schedule(Worker *worker, Conn *conn, uint64_t now) {
+    conn->state = CONN_IDLE;
+    if (config.interval_ns == 0) {
+        conn_send(worker, conn, now, now);
+        return;
+    }
+    // Keeps to the schedule even when late, the lateness shows up in the
+    // corrected latency instead of lowering the rate
+    heap_push(worker, conn, conn->scheduled_ns + config.interval_ns);
+}
+
+static bool parse_colors(const char *text, Vocab_Color colors[VOCAB_WORD_LENGTH]) {
+    for (size_t i = 0; i < VOCAB_WORD_LENGTH; ++i) {
+        switch (text[i]) {
+        case 'g': colors[i] = VOCAB_GREEN; break;
+        case 'y': colors[i] = VOCAB_YELLOW; break;
+        case '-': colors[i] = VOCAB_GRAY; break;
+        default: return false;
+        }
+    }
+    return true;
+}
+
+// Returns false if the connection has to go
+static bool conn_response(Worker *worker, Conn *conn, char *line, uint64_t now) {
+    if (conn->state == CONN_GREETING) {
+        char expected[32];
+        snprintf(expected, sizeof(expected), "vocab %d %d", VOCAB_ATTEMPTS_COUNT, VOCAB_WORD_LENGTH);
+        if (strcmp(line, expected) != 0) {
+            conn_error(worker, conn, line, "unexpected greeting");
+            return false;
+        }
+        conn_new_game(conn);
+        conn->scheduled_ns = now;
+        if (config.interval_ns > 0) {
+            // Spread the first requests over one interval
+            conn->scheduled_ns = now + worker_random(worker) % config.interval_ns - config.interval_ns;
+        }
+        conn_schedule(worker, conn, now);
+        return true;
+    }
+    if (conn->state != CONN_WAITING) {
+        conn_error(worker, conn, line, "response without a request");
+        return false;
+    }
+
+    worker->counters.requests += 1;
+    hist_record(&worker->interval, now - conn->sent_ns);
+    if (config.interval_ns > 0) hist_record(&worker->interval_corrected, now - conn->scheduled_ns);
+
+    if (conn->sent_new) {
+        if (strcmp(line, "ok") != 0) {
+            conn_error(worker, conn, line, "bad response to new");
+            return false;
+        }
+        conn_new_game(conn);
+        conn_schedule(worker, conn, now);
+        return true;
+    }
+
+    char guess[VOCAB_WORD_LENGTH + 1] = {0};
+    memcpy(guess, conn->guess, VOCAB_WORD_LENGTH);
+    bool is_word = hash_set_cstr_contains(&words_set, guess);
+    if (strcmp(line, "invalid") == 0) {
+        if (is_word) {
+            conn_error(worker, conn, line, "word rejected");
+            return false;
+        }
+        conn_schedule(worker, conn, now);
+        return true;
+    }
+
+    Vocab_Color colors[VOCAB_WORD_LENGTH];
+    const char *rest = NULL;
+    bool won = false;
+    bool lost = false;
+    if (strncmp(line, "ok ", 3) == 0) {
+        rest = line + 3;
+    } else if (strncmp(line, "won ", 4) == 0) {
+        rest = line + 4;
+        won = true;
+    } else if (strncmp(line, "lost ", 5) == 0) {
+        rest = line + 5;
+        lost = true;
+    }
+    if (rest == NULL || !is_word || !parse_colors(rest, colors)) {
+        conn_error(worker, conn, line, "bad response to guess");
+        return false;
+    }
+    rest += VOCAB_WORD_LENGTH;
+    conn->attempt += 1;
+
+    bool all_green = true;
+    for (size_t i = 0; i < VOCAB_WORD_LENGTH; ++i) all_green = all_green && colors[i] == VOCAB_GREEN;
+    bool over = conn->attempt >= VOCAB_ATTEMPTS_COUNT || all_green;
+    if (won != all_green || (lost != (over && !all_green)) || *rest != (lost ? ' ' : '\0')) {
+        conn_error(worker, conn, line, "wrong game state");
+        return false;
+    }
+
+    if (conn->candidates != NULL) {
+        for (size_t i = 0; i < words_count; ++i) {
+            uint64_t bit = 1ULL << (i % 64);
+            if ((conn->candidates[i / 64] & bit) && !vocab_candidate_matches(words[i], guess, colors)) {
+                conn->candidates[i / 64] &= ~bit;
+            }
+        }
+    }
+
+    if (lost) {
+        // The answer has to explain every color the game handed out
+        const char *answer = rest + 1;
+        Vocab_Color expected[VOCAB_WORD_LENGTH];
+        if (strlen(answer) != VOCAB_WORD_LENGTH || !hash_set_cstr_contains(&words_set, answer)) {
+            conn_error(worker, conn, line, "bad answer");
+            return false;
+        }
+        vocab5_score(answer, guess, expected);
+        if (memcmp(expected, colors, sizeof(colors)) != 0) {
+            conn_error(worker, conn, line, "colors don't match the answer");
+            return false;
+        }
+        if (conn->candidates != NULL) {
+            size_t i = 0;
+            while (i < words_count && strcmp(words[i], answer) != 0) i += 1;
+            if (i == words_count || !(conn->candidates[i / 64] & (1ULL << (i % 64)))) {
+                conn_error(worker, conn, line, "answer contradicts earlier colors");
+                return false;
+            }
+        }
+        worker->counters.games_lost += 1;
+    }
+    if (won) worker->counters.games_won += 1;
+
+    conn->game_over = over;
+    conn_schedule(worker, conn, now);
+    return true;
+}
+
+static void conn_readable(Worker *worker, Conn *conn, uint64_t now) {
+    ssize_t n = recv(conn->fd, conn->in + conn->in_count, LOAD_IN_CAP - conn->in_count, 0);
+    if (n <= 0) {
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) return;
+        worker->counters.disconnects += 1;
+        conn_close(worker, conn, now);
+        return;
+    }
+    conn->in_count += (size_t) n;
+
+    size_t start = 0;
+    for (;;) {
+        char *newline = memchr(conn->in + start, '\n', conn->in_count - start);
+        if (newline == NULL) break;
+        *newline = '\0';
+        if (!conn_response(worker, conn, conn->in + start, now)) {
+            conn_close(worker, conn, now);
+            return;
+        }
+        start = (size_t) (newline - conn->in) + 1;
+    }
+    memmove(conn->in, conn->in + start, conn->in_count - start);
+    conn->in_count -= start;
+    if (conn->in_count == LOAD_IN_CAP) {
+        conn->in[LOAD_IN_CAP - 1] = '\0';
+        conn_error(worker, conn, conn->in, "line too long");
+        conn_close(worker, conn, now);
+    }
+}
+
+static void conn_event(Worker *worker, Conn *conn, uint32_t events, uint64_t now) {
+    if (conn->state == CONN_CONNECTING) {
+        int error = 0;
+        socklen_t len = sizeof(error);
+        getsockopt(conn->fd, SOL_SOCKET, SO_ERROR, &error, &len);
+        if (error != 0 || (events & (EPOLLERR | EPOLLHUP))) {
+            worker->counters.connect_errors += 1;
+            conn_close(worker, conn, now);
+            return;
+        }
+        struct epoll_event event = { .events = EPOLLIN | EPOLLRDHUP, .data.ptr = conn };
+        epoll_ctl(worker->epoll_fd, EPOLL_CTL_MOD, conn->fd, &event);
+        conn->state = CONN_GREETING;
+        if (!(events & EPOLLIN)) return;
+    }
+    if (events & EPOLLIN) {
+        conn_readable(worker, conn, now);
+    } else if (events & (EPOLLERR | EPOLLHUP | EPOLLRDHUP)) {
+        worker->counters.disconnects += 1;
+        conn_close(worker, conn, now);
+    }
+}
+
+//------------------------------------------------------------------------------
+// Workers
+//------------------------------------------------------------------------------
+
+static void *worker_run(void *arg) {
+    Worker *worker = arg;
+    struct epoll_event events[LOAD_EVENTS_CAP];
+
+    pthread_mutex_lock(&worker->mutex);
+    uint64_t now = time_now_ns();
+    for (size_t i = 0; i < worker->conns_count; ++i) {
+        conn_connect(worker, &worker->conns[i], now);
+    }
+    worker_arm_timer(worker);
+    pthread_mutex_unlock(&worker->mutex);
+
+    while (!atomic_load(&stopping)) {
+        // Wakes up for the report at the latest, to see `stopping`
+        int n = epoll_wait(worker->epoll_fd, events, LOAD_EVENTS_CAP, 100);
+        if (n < 0 && errno != EINTR) {
+            fprintf(stderr, "Error: worker %zu: epoll_wait: %s\n", worker->index, strerror(errno));
+            break;
+        }
+
+        pthread_mutex_lock(&worker->mutex);
+        now = time_now_ns();
+        for (int i = 0; i < n; ++i) {
+            if (events[i].data.ptr == NULL) {
+                uint64_t expirations;
+                ssize_t r = read(worker->timer_fd, &expirations, sizeof(expirations));
+                (void) r;
+                continue;
+            }
+            conn_event(worker, events[i].data.ptr, events[i].events, now);
+        }
+
+        // Whatever is due by now, including what just got scheduled
+        now = time_now_ns();
+        while (worker->heap_count > 0 && worker->heap[0]->due_ns <= now) {
+            Conn *conn = heap_pop(worker);
+            if (conn->state == CONN_DOWN) {
+                conn_connect(worker, conn, now);
+            } else {
+                conn_send(worker, conn, conn->due_ns, now);
+            }
+        }
+        worker_arm_timer(worker);
+        pthread_mutex_unlock(&worker->mutex);
+    }
+
+    for (size_t i = 0; i < worker->conns_count; ++i) {
+        if (worker->conns[i].fd >= 0) close(worker->conns[i].fd);
+    }
+    return NULL;
+}
+
+static bool worker_start(Worker *worker, size_t index, size_t conns_count, uint64_t seed) {
+    worker->index = index;
+    worker->rng = (seed + index) * 0x9E3779B97F4A7C15ULL | 1;
+    worker->conns_count = conns_count;
+    worker->conns = comp_realloc(NULL, conns_count * sizeof(Conn));
+    worker->heap = comp_realloc(NULL, conns_count * sizeof(Conn *));
+    assert(worker->conns != NULL && worker->heap != NULL && "Buy more RAM lol");
+    memset(worker->conns, 0, conns_count * sizeof(Conn));
+
+    size_t words64 = (words_count + 63) / 64;
+    for (size_t i = 0; i < conns_count; ++i) {
+        Conn *conn = &worker->conns[i];
+        conn->fd = -1;
+        conn->heap_index = LOAD_NOT_QUEUED;
+        conn->script_index = index + i * 7;
+        if (config.strategy == STRATEGY_SOLVER) {
+            conn->candidates = comp_realloc(NULL, words64 * sizeof(uint64_t));
+            assert(conn->candidates != NULL && "Buy more RAM lol");
+        }
+    }
+    pthread_mutex_init(&worker->mutex, NULL);
+
+    worker->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    worker->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (worker->epoll_fd < 0 || worker->timer_fd < 0) {
+        fprintf(stderr, "Error: could not create epoll instance or timer: %s\n", strerror(errno));
+        return false;
+    }
+    struct epoll_event event = { .events = EPOLLIN, .data.ptr = NULL };
+    if (epoll_ctl(worker->epoll_fd, EPOLL_CTL_ADD, worker->timer_fd, &event) < 0) {
+        fprintf(stderr, "Error: could not watch timer: %s\n", strerror(errno));
+        return false;
+    }
+
+    if (pthread_create(&worker->thread, NULL, worker_run, worker) != 0) {
+        fprintf(stderr, "Error: could not start worker thread\n");
+        return false;
+    }
+    return true;
+}
+
+static void worker_free(Worker *worker) {
+    for (size_t i = 0; i < worker->conns_count; ++i) {
+        if (worker->conns[i].candidates != NULL) comp_free(worker->conns[i].candidates);
+    }
+    comp_free(worker->conns);
+    comp_free(worker->heap);
+    close(worker->timer_fd);
+    close(worker->epoll_fd);
+    pthread_mutex_destroy(&worker->mutex);
+}
+
+//------------------------------------------------------------------------------
+// Self test
+//------------------------------------------------------------------------------
+
+// Every connection in the heap once, at its index, and no parent due later
+// than its children
+static bool heap_valid(const Worker *worker) {
+    size_t queued = 0;
+    for (size_t i = 0; i < worker->conns_count; ++i) {
+        const Conn *conn = &worker->conns[i];
+        if (conn->heap_index == LOAD_NOT_QUEUED) continue;
+        if (conn->heap_index >= worker->heap_count || worker->heap[conn->heap_index] != conn) return false;
+        queued += 1;
+    }
+    for (size_t i = 1; i < worker->heap_count; ++i) {
+        if (worker->heap[(i - 1) / 2]->due_ns > worker->heap[i]->due_ns) return false;
+    }
+    return queued == worker->heap_count;
+}
+
+// Runs the scheduling of one worker without a server. With a rate idle
+// connections sit in the heap, the ones whose peer hangs up have to be taken
+// out before they are queued for the reconnect
+static bool self_test(void) {
+    Worker worker = {0};
+    worker.conns_count = 8;
+    worker.rng = 1;
+    worker.conns = comp_realloc(NULL, worker.conns_count * sizeof(Conn));
+    worker.heap = comp_realloc(NULL, worker.conns_count * sizeof(Conn *));
+    assert(worker.conns != NULL && worker.heap != NULL && "Buy more RAM lol");
+    memset(worker.conns, 0, worker.conns_count * sizeof(Conn));
+    config.interval_ns = 1000000;
+
+    bool ok = true;
+    int peers[8];
+    uint64_t now = time_now_ns();
+    for (size_t i = 0; i < worker.conns_count; ++i) {
+        Conn *conn = &worker.conns[i];
+        int pair[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, pair) < 0) {
+            fprintf(stderr, "Error: socketpair: %s\n", strerror(errno));
+            return false;
+        }
+        conn->fd = pair[0];
+        peers[i] = pair[1];
+        conn->heap_index = LOAD_NOT_QUEUED;
+        conn->scheduled_ns = now + i * 7919 % 13;
+        conn_schedule(&worker, conn, now);
+    }
+    ok = ok && worker.heap_count == worker.conns_count && heap_valid(&worker);
+
+    // The server goes away under every idle connection, twice for some
+    for (size_t i = 0; i < worker.conns_count; ++i) {
+        Conn *conn = &worker.conns[(i * 3) % worker.conns_count];
+        close(peers[(i * 3) % worker.conns_count]);
+        conn_event(&worker, conn, EPOLLIN | EPOLLRDHUP, now + i);
+        if (i % 2 == 0) conn_close(&worker, conn, now + 2*i);
+        ok = ok && worker.heap_count == worker.conns_count && heap_valid(&worker);
+    }
+    for (size_t i = 0; i < worker.conns_count; ++i) {
+        ok = ok && worker.conns[i].state == CONN_DOWN && worker.conns[i].fd < 0;
+    }
+    // And they come out in order
+    uint64_t last = 0;
+    while (ok && worker.heap_count > 0) {
+        Conn *conn = heap_pop(&worker);
+        ok = conn->due_ns >= last && conn->heap_index == LOAD_NOT_QUEUED && heap_valid(&worker);
+        last = conn->due_ns;
+    }
+
+    comp_free(worker.conns);
+    comp_free(worker.heap);
+    config.interval_ns = 0;
+    fprintf(stderr, "[LOAD]: self test %s\n", ok ? "passed" : "FAILED");
+    return ok;
+}
+
+//------------------------------------------------------------------------------
+// Main
+//------------------------------------------------------------------------------
+
+static void on_stop_signal(int sig) {
+    (void) sig;
+    atomic_store(&stopping, true);
+}
+
+static bool load_script(Cstr path) {
+    int size = 0;
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "Error: could not open script '%s'\n", path);
+        return false;
+    }
+    static char line[64];
+    Da_Cstr script = {0};
+    while (fgets(line, sizeof(line), file) != NULL) {
+        size_t length = strcspn(line, "\r\n");
+        if (length == 0) continue;
+        if (length != VOCAB_WORD_LENGTH) {
+            fprintf(stderr, "Error: %s:%d: guesses are %d letters\n", path, size + 1, VOCAB_WORD_LENGTH);
+            fclose(file);
+            return false;
+        }
+        char *guess = comp_realloc(NULL, VOCAB_WORD_LENGTH + 1);
+        memcpy(guess, line, VOCAB_WORD_LENGTH);
+        guess[VOCAB_WORD_LENGTH] = '\0';
+        da_append(&script, guess);
+        size += 1;
+    }
+    fclose(file);
+    if (script.count == 0) {
+        fprintf(stderr, "Error: script '%s' has no guesses\n", path);
+        return false;
+    }
+    config.script = script.items;
+    config.script_count = script.count;
+    return true;
+}
+
+static void usage(Cstr program) {
+    fprintf(stderr, "Usage: %s [options]\n", program);
+    fprintf(stderr, "    --host <ip>          server address (default 127.0.0.1)\n");
+    fprintf(stderr, "    --port <n>           server port (default 6000)\n");
+    fprintf(stderr, "    --unix <path>        connect to a Unix socket instead\n");
+    fprintf(stderr, "    --connections <n>    connections to keep open (default 1000)\n");
+    fprintf(stderr, "    --workers <n>        threads the connections are split over (default 1)\n");
+    fprintf(stderr, "    --rate <n>           requests per second over all connections, 0 for as fast as possible (default 0)\n");
+    fprintf(stderr, "    --duration <s>       seconds to run, 0 until interrupted (default 10)\n");
+    fprintf(stderr, "    --report <s>         seconds between reports (default 1)\n");
+    fprintf(stderr, "    --strategy <name>    random or solver (default random)\n");
+    fprintf(stderr, "    --script <file>      guesses to play, one per line, instead of a strategy\n");
+    fprintf(stderr, "    --seed <n>           seed for the guesses\n");
+    fprintf(stderr, "    --self-test          check the request scheduling without a server and exit\n");
+}
+
+int main(int argc, const char **argv) {
+    Cstr host = "127.0.0.1";
+    int port = 6000;
+    Cstr unix_path = NULL;
+    size_t connections = 1000;
+    size_t workers_wanted = 1;
+    double rate = 0.0;
+    double duration = 10.0;
+    double report = 1.0;
+    Cstr script_path = NULL;
+    uint64_t seed = (uint64_t) time(NULL);
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--host") == 0 && i + 1 < argc) {
+            host = argv[++i];
+        } else if (strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+            long number = 0;
+            if (!parse_flag_number("--port", argv[++i], 1, 65535, &number)) return 1;
+            port = (int) number;
+        } else if (strcmp(argv[i], "--unix") == 0 && i + 1 < argc) {
+            unix_path = argv[++i];
+        } else if (strcmp(argv[i], "--connections") == 0 && i + 1 < argc) {
+            long number = 0;
+            if (!parse_flag_number("--connections", argv[++i], 1, 1000000, &number)) return 1;
+            connections = (size_t) number;
+        } else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            long number = 0;
+            if (!parse_flag_number("--workers", argv[++i], 1, LOAD_WORKERS_CAP, &number)) return 1;
+            workers_wanted = (size_t) number;
+        } else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+            if (!parse_flag_real("--rate", argv[++i], 0.0, 1e9, &rate)) return 1;
+        } else if (strcmp(argv[i], "--duration") == 0 && i + 1 < argc) {
+            if (!parse_flag_real("--duration", argv[++i], 0.0, 1e6, &duration)) return 1;
+        } else if (strcmp(argv[i], "--report") == 0 && i + 1 < argc) {
+            if (!parse_flag_real("--report", argv[++i], 0.001, 3600.0, &report)) return 1;
+        } else if (strcmp(argv[i], "--strategy") == 0 && i + 1 < argc) {
+            Cstr name = argv[++i];
+            if (strcmp(name, "random") == 0) {
+                config.strategy = STRATEGY_RANDOM;
+            } else if (strcmp(name, "solver") == 0) {
+                config.strategy = STRATEGY_SOLVER;
+            } else {
+                fprintf(stderr, "Error: unknown strategy '%s'\n", name);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--script") == 0 && i + 1 < argc) {
+            script_path = argv[++i];
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            if (!parse_flag_seed("--seed", argv[++i], &seed)) return 1;
+        } else if (strcmp(argv[i], "--self-test") == 0) {
+            return self_test() ? 0 : 1;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (workers_wanted > connections) workers_wanted = connections;
+    if (rate > 0.0) {
+        config.interval_ns = (uint64_t) ((double) connections * 1e9 / rate);
+        if (config.interval_ns == 0) config.interval_ns = 1;
+    }
+
+    if (unix_path != NULL) {
+        struct sockaddr_un *addr = (struct sockaddr_un *) &config.addr;
+        if (strlen(unix_path) >= sizeof(addr->sun_path)) {
+            fprintf(stderr, "Error: socket path '%s' is too long\n", unix_path);
+            return 1;
+        }
+        addr->sun_family = AF_UNIX;
+        strcpy(addr->sun_path, unix_path);
+        config.addr_len = sizeof(*addr);
+    } else {
+        struct sockaddr_in *addr4 = (struct sockaddr_in *) &config.addr;
+        struct sockaddr_in6 *addr6 = (struct sockaddr_in6 *) &config.addr;
+        if (inet_pton(AF_INET, host, &addr4->sin_addr) == 1) {
+            addr4->sin_family = AF_INET;
+            addr4->sin_port = htons((uint16_t) port);
+            config.addr_len = sizeof(*addr4);
+        } else if (inet_pton(AF_INET6, host, &addr6->sin6_addr) == 1) {
+            addr6->sin6_family = AF_INET6;
+            addr6->sin6_port = htons((uint16_t) port);
+            config.addr_len = sizeof(*addr6);
+        } else {
+            fprintf(stderr, "Error: '%s' is not an IP address\n", host);
+            return 1;
+        }
+        config.tcp = true;
+    }
+
+    for (size_t i = 0; i < words_count; ++i) {
+        hash_set_cstr_insert(&words_set, words[i]);
+    }
+    if (script_path != NULL) {
+        if (!load_script(script_path)) return 1;
+        config.strategy = STRATEGY_SCRIPT;
+    }
+
+    // Every connection is a file descriptor
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+    signal(SIGINT, on_stop_signal);
+    signal(SIGTERM, on_stop_signal);
+    signal(SIGPIPE, SIG_IGN);
+
+    for (size_t i = 0; i < workers_wanted; ++i) {
+        size_t share = connections / workers_wanted + (i < connections % workers_wanted);
+        if (!worker_start(&workers[i], i, share, seed)) {
+            atomic_store(&stopping, true);
+            break;
+        }
+        workers_count += 1;
+    }
+
+    static Histogram total = {0};
+    static Histogram total_corrected = {0};
+    static Histogram interval = {0};
+    static Histogram interval_corrected = {0};
+    Load_Counters counters = {0};
+
+    uint64_t start = time_now_ns();
+    uint64_t last_report = start;
+    uint64_t report_ns = (uint64_t) (report * 1e9);
+    uint64_t end = duration > 0.0 ? start + (uint64_t) (duration * 1e9) : UINT64_MAX;
+    while (!atomic_load(&stopping)) {
+        uint64_t next = last_report + report_ns;
+        if (next > end) next = end;
+        uint64_t now = time_now_ns();
+        if (next > now) {
+            struct timespec wait = { (time_t) ((next - now) / 1000000000), (long) ((next - now) % 1000000000) };
+            nanosleep(&wait, NULL);
+            continue;
+        }
+
+        memset(&interval, 0, sizeof(interval));
+        memset(&interval_corrected, 0, sizeof(interval_corrected));
+        Load_Counters before = counters;
+        memset(&counters, 0, sizeof(counters));
+        for (size_t i = 0; i < workers_count; ++i) {
+            Worker *worker = &workers[i];
+            pthread_mutex_lock(&worker->mutex);
+            hist_merge(&interval, &worker->interval);
+            hist_merge(&interval_corrected, &worker->interval_corrected);
+            memset(&worker->interval, 0, sizeof(worker->interval));
+            memset(&worker->interval_corrected, 0, sizeof(worker->interval_corrected));
+            Load_Counters *c = &worker->counters;
+            counters.requests += c->requests;
+            counters.games_won += c->games_won;
+            counters.games_lost += c->games_lost;
+            counters.protocol_errors += c->protocol_errors;
+            counters.disconnects += c->disconnects;
+            counters.connect_errors += c->connect_errors;
+            pthread_mutex_unlock(&worker->mutex);
+        }
+        hist_merge(&total, &interval);
+        hist_merge(&total_corrected, &interval_corrected);
+
+        double seconds = (double) (now - last_report) * 1e-9;
+        fprintf(stderr, "[LOAD]: %7.1f s: %9.0f req/s, %6zu games, %zu errors, %zu disconnects, p50 %.1f us, p99 %.1f us, max %.1f us\n",
+            (double) (now - start) * 1e-9,
+            (double) (counters.requests - before.requests) / seconds,
+            (counters.games_won + counters.games_lost) - (before.games_won + before.games_lost),
+            counters.protocol_errors - before.protocol_errors,
+            counters.disconnects - before.disconnects,
+            hist_percentile(&interval, 0.50) * 1e-3,
+            hist_percentile(&interval, 0.99) * 1e-3,
+            hist_percentile(&interval, 1.0) * 1e-3);
+        last_report = now;
+        if (now >= end) break;
+    }
+    atomic_store(&stopping, true);
+
+    for (size_t i = 0; i < workers_count; ++i) {
+        pthread_join(workers[i].thread, NULL);
+        worker_free(&workers[i]);
+    }
+
+    double seconds = (double) (last_report - start) * 1e-9;
+    fprintf(stderr, "[LOAD]: %zu connections over %zu workers, %.1f s\n", connections, workers_count, seconds);
+    fprintf(stderr, "[LOAD]: %zu requests, %.0f req/s, %zu games won, %zu lost\n",
+        counters.requests, seconds > 0.0 ? (double) counters.requests / seconds : 0.0,
+        counters.games_won, counters.games_lost);
+    fprintf(stderr, "[LOAD]: %zu protocol errors, %zu disconnects, %zu connect errors\n",
+        counters.protocol_errors, counters.disconnects, counters.connect_errors);
+    hist_print(stderr, "[LOAD]: ", "latency", &total);
+    if (config.interval_ns > 0) hist_print(stderr, "[LOAD]: ", "latency from schedule", &total_corrected);
+
+    return counters.protocol_errors > 0 ? 1 : 0;
+}
@@ -1,174 +1,907 @@
+// For clock_gettime() in comp.h
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdint.h>
 #include <string.h>
 #include <ctype.h>
 #include <raylib.h>
+#include <rlgl.h>
 
+// Because I want the da_* functions
+#define COMP_IMPLEMENTATION
+#include "./comp.h"
+
+// The UI stack allocates through comp.h too, so the tracker sees it
+#define SOMUI_REALLOC(ptr, size) comp_realloc((ptr), (size))
+#define SOMUI_FREE(ptr) comp_free(ptr)
+#define SOMUI_TRACE_BEGIN(name) trace_begin(name)
+#define SOMUI_TRACE_END(name) trace_end(name)
 #define SOMUI_IMPLEMENTATION
 #include "./somui.h"
 
-// Because I want the da_* functions
-#include "./comp.h"
+#define VOCAB_IMPLEMENTATION
+#include "./vocab.h"
+
+#define VOCAB_LENGTHS_IMPLEMENTATION
+#include "./vocab_lengths.h"
+
+// And the boards to go with them, vocab4_draw(), ...
+#define VOCAB_LENGTH_TEMPLATE_DRAW
+#define VOCAB_LENGTH 4
+#include "./vocab_length_template.h"
+#undef VOCAB_LENGTH
+#define VOCAB_LENGTH 5
+#include "./vocab_length_template.h"
+#undef VOCAB_LENGTH
+#define VOCAB_LENGTH 6
+#include "./vocab_length_template.h"
+#undef VOCAB_LENGTH
+#define VOCAB_LENGTH 7
+#include "./vocab_length_template.h"
+#undef VOCAB_LENGTH
+#undef VOCAB_LENGTH_TEMPLATE_DRAW
+
+#define LATENCY_IMPLEMENTATION
+#include "./latency.h"
+
+#define REPLAY_IMPLEMENTATION
+#include "./replay.h"
 
-#define VOCAB_ATTEMPTS_COUNT 6
-#define VOCAB_WORD_LENGTH 5
+#if REPLAY_BOARDS_CAP < VOCAB_BOARDS_CAP
+    #error "A replay has to fit the answers of every board"
+#endif
+
+#define ASSETS_IMPLEMENTATION
+#include "./assets.h"
+
+#define SIM_IMPLEMENTATION
+#include "./sim.h"
 
 // Put the words in a separate file
 #include "words.c"
 
-#define HASH_SET_CSTR_CAP 512
-
-typedef struct {
-    Da_Cstr buckets[HASH_SET_CSTR_CAP];
-} Hash_Set_Cstr;
+static Vocab_Dict words_dict = {0};
+static Latency latency = {0};
+static Replay_Writer recorder = {0};
+static Latency_Samples frame_times = {0};
+static Sim sim = {0};
+static Latency_Samples sim_step_times = {0};
+// With --boards the input goes here instead of the single game
+static Vocab_Boards boards = {0};
+// With --length the input goes here instead
+static Vocab_Game game = {0};
+// What the single board checks guesses against, the --length list if there is one
+static Vocab_Word_Set game_words = {0};
+// The dictionary again, for looking up words close to a rejected guess
+static Vocab_Columns words_columns = {0};
+// And once more by prefix, for following the row being typed
+static Vocab_Prefix words_prefix = {0};
+
+// Frames after this one are expected to not allocate at all
+#define VOCAB_ALLOC_WARMUP_FRAMES 60
+
+// How often the trace rings are written out to the file
+#define VOCAB_TRACE_FLUSH_FRAMES 60
+
+// Pixels moved to the GPU per frame while assets come in
+#define VOCAB_UPLOAD_BYTES_PER_FRAME (256*1024)
+
+// Words offered for a guess that is not a word, and how many letters off they may be
+#define VOCAB_SUGGESTIONS_COUNT 3
+#define VOCAB_SUGGESTIONS_DISTANCE 2
+// Words shown that start with what is typed so far
+#define VOCAB_COMPLETIONS_COUNT 5
+// Words listed by --helper that the answer can still be
+#define VOCAB_HELPER_COUNT 14
+// Bottom of the window kept free of the 5 letter board for the status line
+#define VOCAB_STATUS_LINE_HEIGHT 50
+
+void *rl_alloc(unsigned int size, const char *file, int line) {
+    return allocator_realloc(NULL, size, file, line);
+}
 
-size_t hash_cstr(Cstr cstr) {
-    size_t hash = 0;
-    while (*cstr++ != '\0') {
-        hash = hash * 13 + (size_t)*cstr;
-    }
-    return hash;
+void *rl_realloc(void *ptr, unsigned int size, const char *file, int line) {
+    return allocator_realloc(ptr, size, file, line);
 }
 
-void hash_set_cstr_insert(Hash_Set_Cstr *set, Cstr cstr) {
-    size_t index = hash_cstr(cstr) % HASH_SET_CSTR_CAP;
-    Da_Cstr *bucket = &set->buckets[index];
-    da_append(bucket, cstr);
+void rl_free(void *ptr, const char *file, int line) {
+    allocator_free(ptr, file, line);
 }
 
-bool hash_set_cstr_contains(Hash_Set_Cstr *set, Cstr cstr) {
-    size_t index = hash_cstr(cstr) % HASH_SET_CSTR_CAP;
-    Da_Cstr *bucket = &set->buckets[index];
-    for (size_t i = 0; i < bucket->count; ++i) {
-        if (strcmp(cstr, bucket->items[i]) == 0) {
+// Returns whether the game acted on the event
+bool apply_input_event(Vocab5 *vocab, const InputEvent *event) {
+    switch (event->type) {
+    case INPUT_EVENT_KEY_PRESSED:
+    case INPUT_EVENT_KEY_REPEAT:
+        if (event->value == KEY_BACKSPACE) {
+            if (boards.count > 0) vocab_boards_erase_letter(&boards);
+            else if (game.length > 0) vocab_game_erase_letter(&game);
+            else vocab5_erase_letter(vocab);
+            return true;
+        }
+        if (event->value == KEY_ENTER) {
+            if (boards.count > 0) vocab_boards_submit(&boards, &words_dict);
+            else if (game.length > 0) vocab_game_submit(&game, &game_words);
+            else vocab5_submit(vocab, &game_words);
+            return true;
+        }
+        break;
+    case INPUT_EVENT_CHAR:
+        if (event->value < 128 && isalpha(event->value)) {
+            char letter = (char) tolower(event->value);
+            if (boards.count > 0) vocab_boards_type_letter(&boards, letter);
+            else if (game.length > 0) vocab_game_type_letter(&game, letter);
+            else vocab5_type_letter(vocab, letter);
             return true;
         }
+        break;
     }
     return false;
 }
 
-static Hash_Set_Cstr words_set = {0};
+// Everything the game gets goes through here, so a recording has all of it
+bool handle_input_event(Vocab5 *vocab, const InputEvent *event, size_t frame_index) {
+    if (recorder.file != NULL) {
+        replay_write_event(&recorder, frame_index, event->type, event->value);
+    }
+    return apply_input_event(vocab, event);
+}
+
+// The rules with --sim-thread, applies whatever came in since the last step
+// and publishes the game for the render thread after every step
+void *sim_thread(void *arg) {
+    Vocab5 *vocab = arg;
+    while (sim_wait(&sim)) {
+        trace_begin("sim step");
+        uint64_t step_start = time_now_ns();
+        Sim_Event event;
+        while (sim_pop_event(&sim, &event)) {
+            InputEvent input = { event.kind, event.value, event.time };
+            if (handle_input_event(vocab, &input, event.frame)) sim_input(&sim, event.time);
+        }
+        sim_publish(&sim, vocab);
+        latency_samples_push(&sim_step_times, (double) (time_now_ns() - step_start) * 1e-9);
+        trace_end("sim step");
+    }
+    return NULL;
+}
 
-typedef enum {
-    VOCAB_BLACK = 0,
-    VOCAB_GRAY,
-    VOCAB_YELLOW,
-    VOCAB_GREEN,
-} Vocab_Color;
+bool is_submit_event(const InputEvent *event) {
+    return event->value == KEY_ENTER
+        && (event->type == INPUT_EVENT_KEY_PRESSED || event->type == INPUT_EVENT_KEY_REPEAT);
+}
 
+// With --late-latch, typing that came in since the top of the frame still
+// makes it into the live row. A submit scores the row and moves on to the
+// next one, so it waits for the top of the next frame
 typedef struct {
-    const char *word;
-    char grid[VOCAB_ATTEMPTS_COUNT][VOCAB_WORD_LENGTH];
-    Vocab_Color color_grid[VOCAB_ATTEMPTS_COUNT][VOCAB_WORD_LENGTH];
-    size_t current_attempt;
-    size_t cursor;
-} Vocab;
-
-int main(void) {
+    Vocab5 *vocab;
+    size_t frame_index;
+    bool measure_latency;
+    InputEvent deferred;
+    bool has_deferred;
+} Late_Latch;
+
+// Vocab_Draw_Hook for vocab5_draw()
+void late_latch_input(void *user) {
+    Late_Latch *latch = user;
+    trace_begin("late latch");
+    LatchInputEvents();
+    InputEvent event;
+    while (!latch->has_deferred && GetInputEvent(&event)) {
+        if (is_submit_event(&event)) {
+            latch->deferred = event;
+            latch->has_deferred = true;
+        } else if (handle_input_event(latch->vocab, &event, latch->frame_index) && latch->measure_latency) {
+            latency_input(&latency, event.time);
+        }
+    }
+    trace_end("late latch");
+}
+
+// Board `b` of `boards` in `rect`, only as many rows as `rows` are laid out
+void draw_board(UI_Stack *ui, const Vocab_Boards *boards, size_t b, UI_Rect rect, size_t rows, Font font, bool dead_end) {
+    bool solved = boards->solved_in[b] != 0;
+    size_t shown = solved ? boards->solved_in[b] : boards->current_attempt;
+    bool typing = !solved && !vocab_boards_is_over(boards);
+    if (typing) shown += 1;
+
+    DrawRectangleLines(rect.x - 1, rect.y - 1, rect.w + 2, rect.h + 2, solved ? GREEN : WHITE);
+
+    ui_layout_begin(ui, rect, UI_VERT, ui_marginv(0), 0, rows);
+    UI_Rect first = ui_layout_rect(ui);
+    int32_t square_size = first.h;
+    // Letters would be a smudge any smaller
+    bool letters = square_size >= 12;
+    float font_size = square_size * 0.48f;
+    Vector2 glyph_size = MeasureTextEx(font, "W", font_size, 0);
+
+    for (size_t i = 0; i < shown; ++i) {
+        UI_Rect row = i == 0 ? first : ui_layout_rect(ui);
+        bool live = typing && i == boards->current_attempt;
+        ui_layout_begin(ui, row, UI_HORI, ui_marginv(0), 0, VOCAB_WORD_LENGTH);
+        for (size_t j = 0; j < VOCAB_WORD_LENGTH; ++j) {
+            UI_Rect square = ui_layout_rect(ui);
+
+            // Empty squares are left out, the board outline stands in for them
+            Color background_color = BLACK;
+            switch (boards->color_grid[b][i][j]) {
+            case VOCAB_BLACK: background_color = BLACK; break;
+            case VOCAB_GRAY: background_color = GRAY; break;
+            case VOCAB_YELLOW: background_color = YELLOW; break;
+            case VOCAB_GREEN: background_color = GREEN; break;
+            }
+            if (live) {
+                // Letters that no word starts with
+                if (dead_end && j < boards->cursor) {
+                    DrawRectangle(square.x + 1, square.y + 1, square.w - 2, square.h - 2, MAROON);
+                }
+                DrawRectangleLines(square.x, square.y, square.w, square.h, WHITE);
+            } else {
+                DrawRectangle(square.x + 1, square.y + 1, square.w - 2, square.h - 2, background_color);
+            }
+
+            char letter = boards->grid[i][j];
+            if (letters && letter != '\0') {
+                Vector2 text_pos = {
+                    square.x + (square.w - glyph_size.x) / 2,
+                    square.y + (square.h - glyph_size.y) / 2,
+                };
+                DrawTextCodepoint(font, toupper(letter), text_pos, font_size, WHITE);
+            }
+        }
+        ui_layout_end(ui);
+    }
+    ui_layout_end(ui);
+}
+
+// Tiles the boards in whatever grid makes the squares biggest. Squares shrink
+// as rows fill up, and a board costs as much as the rows it shows, so drawing
+// every board stays cheap early on and at most a few thousand rectangles late
+void draw_boards(UI_Stack *ui, const Vocab_Boards *boards, Font font, int32_t window_width, int32_t window_height, bool dead_end) {
+    size_t rows = VOCAB_ATTEMPTS_COUNT;
+    if (boards->current_attempt + 1 > rows) rows = boards->current_attempt + 1;
+    if (rows > boards->attempts_count) rows = boards->attempts_count;
+
+    int32_t gap = 8;
+    size_t columns = 1;
+    int32_t square_size = 0;
+    for (size_t c = 1; c <= boards->count; ++c) {
+        size_t r = (boards->count + c - 1) / c;
+        int32_t fit_w = (window_width - gap * (int32_t) (c + 1)) / (int32_t) (c * VOCAB_WORD_LENGTH);
+        int32_t fit_h = (window_height - gap * (int32_t) (r + 1)) / (int32_t) (r * rows);
+        int32_t fit = fit_w < fit_h ? fit_w : fit_h;
+        if (fit > square_size) {
+            square_size = fit;
+            columns = c;
+        }
+    }
+    if (square_size < 1) square_size = 1;
+    if (square_size > 100) square_size = 100;
+    size_t grid_rows = (boards->count + columns - 1) / columns;
+
+    int32_t board_width = square_size * VOCAB_WORD_LENGTH;
+    int32_t board_height = square_size * (int32_t) rows;
+    int32_t grid_width = board_width * (int32_t) columns + gap * (int32_t) (columns + 1);
+    int32_t grid_height = board_height * (int32_t) grid_rows + gap * (int32_t) (grid_rows + 1);
+    UI_Rect rect = {
+        (window_width - grid_width) / 2,
+        (window_height - grid_height) / 2,
+        grid_width,
+        grid_height,
+    };
+
+    ui_layout_begin(ui, rect, UI_VERT, ui_marginv(gap), gap, grid_rows);
+    for (size_t r = 0; r < grid_rows; ++r) {
+        UI_Rect grid_row = ui_layout_rect(ui);
+        ui_layout_begin(ui, grid_row, UI_HORI, ui_marginv(0), gap, columns);
+        for (size_t c = 0; c < columns && r * columns + c < boards->count; ++c) {
+            draw_board(ui, boards, r * columns + c, ui_layout_rect(ui), rows, font, dead_end);
+        }
+        ui_layout_end(ui);
+    }
+    ui_layout_end(ui);
+}
+
+// The --length game, drawn by the code for its length so the squares don't
+// go through Vocab_Game one by one
+void draw_game(UI_Stack *ui, const Vocab_Game *game, Font font, int32_t window_width, int32_t window_height) {
+    switch (game->length) {
+#define X(n) case n: vocab##n##_draw(ui, &game->as.v##n, font, window_width, window_height, false, NULL, NULL); break;
+        VOCAB_LENGTHS(X)
+#undef X
+    default: break;
+    }
+}
+
+// Words of `length` letters from a list, one per line, lowercased. Other lines
+// are skipped. The words go back to back into `letters` with their '\0's and
+// `list` points into it, so the whole list is two allocations
+bool load_words(Cstr path, size_t length, String *letters, Da_Cstr *list) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "Error: could not open word list '%s'\n", path);
+        return false;
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), file) != NULL) {
+        line[strcspn(line, "\r\n")] = '\0';
+        for (char *c = line; *c != '\0'; ++c) *c = (char) tolower(*c);
+        if (vocab_word_key64(line, length) == 0) continue;
+        da_append_many(letters, line, length + 1);
+    }
+    fclose(file);
+
+    // Only now, `letters` moves while it grows
+    size_t count = letters->count / (length + 1);
+    da_reserve(list, list->count + count);
+    for (size_t i = 0; i < count; ++i) {
+        list->items[list->count++] = letters->items + i*(length + 1);
+    }
+    return true;
+}
+
+// One line of text at the bottom of the window, over whatever is there
+void draw_status_line(const char *text, Font font, int32_t window_width, int32_t window_height) {
+    char upper[128];
+    size_t length = 0;
+    for (; text[length] != '\0' && length + 1 < sizeof(upper); ++length) {
+        upper[length] = (char) toupper(text[length]);
+    }
+    upper[length] = '\0';
+
+    float font_size = 28.0f;
+    int spacing = 2;
+    Vector2 text_size = MeasureTextEx(font, upper, font_size, spacing);
+    Vector2 text_pos = { (window_width - text_size.x) / 2, window_height - text_size.y - 14 };
+    DrawRectangle(text_pos.x - 8, text_pos.y - 4, text_size.x + 16, text_size.y + 8, BLACK);
+    DrawTextEx(font, upper, text_pos, font_size, spacing, WHITE);
+}
+
+// "Did you mean" line under the boards for the `row` the game turned down.
+// The lookup only runs when the rejected row changes, which is the frame the
+// guess was submitted
+void draw_suggestions(const char *row, Font font, int32_t window_width, int32_t window_height) {
+    static char looked_up[VOCAB_WORD_LENGTH] = {0};
+    static size_t suggestions[VOCAB_SUGGESTIONS_COUNT] = {0};
+    static size_t suggestions_count = 0;
+    if (memcmp(looked_up, row, VOCAB_WORD_LENGTH) != 0) {
+        trace_begin("suggestions");
+        memcpy(looked_up, row, VOCAB_WORD_LENGTH);
+        suggestions_count = vocab_columns_nearest(&words_columns, row, VOCAB_SUGGESTIONS_DISTANCE, suggestions, VOCAB_SUGGESTIONS_COUNT);
+        trace_end("suggestions");
+    }
+
+    char text[128];
+    int length = snprintf(text, sizeof(text), "%.*s is not a word", VOCAB_WORD_LENGTH, row);
+    for (size_t i = 0; i < suggestions_count; ++i) {
+        length += snprintf(text + length, sizeof(text) - length, "%s%s", i == 0 ? ", did you mean " : ", ", words[suggestions[i]]);
+    }
+    if (suggestions_count > 0) snprintf(text + length, sizeof(text) - length, "?");
+    draw_status_line(text, font, window_width, window_height);
+}
+
+// How many words the `length` letters typed so far can still become, and the
+// first few of them alphabetically
+void draw_completions(const char *row, size_t length, Vocab_Prefix_Range range, Font font, int32_t window_width, int32_t window_height) {
+    char text[128];
+    size_t count = range.end - range.begin;
+    if (count == 0) {
+        snprintf(text, sizeof(text), "no words start with %.*s", (int) length, row);
+    } else {
+        int written = snprintf(text, sizeof(text), "%.*s: %zu word%s", (int) length, row, count, count == 1 ? "" : "s");
+        for (size_t i = 0; i < count && i < VOCAB_COMPLETIONS_COUNT; ++i) {
+            written += snprintf(text + written, sizeof(text) - written, "%s%s", i == 0 ? ", " : " ", words[words_prefix.order[range.begin + i]]);
+        }
+        if (count > VOCAB_COMPLETIONS_COUNT) snprintf(text + written, sizeof(text) - written, "...");
+    }
+    draw_status_line(text, font, window_width, window_height);
+}
+
+// Column of the words the answer can still be, left of the board, going by
+// the colors of the rows played so far. Looked up again only when a row gets
+// scored, the rest of the frames draw what was found then
+void draw_helper(const Vocab5 *view, UI_Rect board, Font font) {
+    static char learned[VOCAB_ATTEMPTS_COUNT][VOCAB_WORD_LENGTH] = {0};
+    static size_t learned_count = (size_t) -1;
+    static size_t matches[VOCAB_HELPER_COUNT] = {0};
+    static size_t matches_count = 0;
+    size_t scored = view->current_attempt;
+    if (scored != learned_count || memcmp(learned, view->grid, scored*VOCAB_WORD_LENGTH) != 0) {
+        trace_begin("helper");
+        Vocab_Pattern pattern = {0};
+        for (size_t i = 0; i < scored; ++i) {
+            vocab_pattern_learn(&pattern, view->grid[i], view->color_grid[i]);
+        }
+        memcpy(learned, view->grid, scored*VOCAB_WORD_LENGTH);
+        learned_count = scored;
+        matches_count = vocab_columns_match(&words_columns, &pattern, matches, VOCAB_HELPER_COUNT);
+        trace_end("helper");
+    }
+
+    float font_size = 28.0f;
+    int spacing = 2;
+    float line_height = font_size + 4;
+    Vector2 pos = { 40, board.y + 10 };
+    DrawTextEx(font, TextFormat("%zu POSSIBLE", matches_count), pos, font_size, spacing, WHITE);
+    for (size_t i = 0; i < matches_count && i < VOCAB_HELPER_COUNT; ++i) {
+        char upper[VOCAB_WORD_LENGTH + 1];
+        for (size_t j = 0; j < VOCAB_WORD_LENGTH; ++j) {
+            upper[j] = (char) toupper(words[matches[i]][j]);
+        }
+        upper[VOCAB_WORD_LENGTH] = '\0';
+        pos.y += line_height;
+        DrawTextEx(font, upper, pos, font_size, spacing, LIGHTGRAY);
+    }
+    if (matches_count > VOCAB_HELPER_COUNT) {
+        pos.y += line_height;
+        DrawTextEx(font, "...", pos, font_size, spacing, LIGHTGRAY);
+    }
+}
+
+int main(int argc, const char **argv) {
+    bool track_allocs = false;
+    bool measure_latency = false;
+    bool late_latch = false;
+    bool threaded = false;
+    Cstr trace_path = NULL;
+    Cstr record_path = NULL;
+    Cstr replay_path = NULL;
+    Cstr screenshot_path = NULL;
+    size_t max_frames = 0;
+    size_t boards_count = 1;
+    size_t length = 0;
+    Cstr words_path = NULL;
+    bool helper = false;
+    int target_fps = -1;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--track-allocs") == 0) {
+            track_allocs = true;
+        } else if (strcmp(argv[i], "--latency") == 0) {
+            measure_latency = true;
+        } else if (strcmp(argv[i], "--late-latch") == 0) {
+            late_latch = true;
+        } else if (strcmp(argv[i], "--sim-thread") == 0) {
+            threaded = true;
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            record_path = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replay_path = argv[++i];
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace_path = argv[++i];
+        } else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            long fps = 0;
+            if (!parse_flag_number("--fps", argv[++i], 0, 1000, &fps)) return 1;
+            target_fps = (int) fps;
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            long frames = 0;
+            if (!parse_flag_number("--frames", argv[++i], 1, 1000000000, &frames)) return 1;
+            max_frames = (size_t) frames;
+        } else if (strcmp(argv[i], "--screenshot") == 0 && i + 1 < argc) {
+            screenshot_path = argv[++i];
+        } else if (strcmp(argv[i], "--helper") == 0) {
+            helper = true;
+        } else if (strcmp(argv[i], "--boards") == 0 && i + 1 < argc) {
+            long count = 0;
+            if (!parse_flag_number("--boards", argv[++i], 1, VOCAB_BOARDS_CAP, &count)) return 1;
+            boards_count = (size_t) count;
+        } else if (strcmp(argv[i], "--length") == 0 && i + 1 < argc) {
+            long letters = 0;
+            if (!parse_flag_number("--length", argv[++i], VOCAB_LENGTH_MIN, VOCAB_LENGTH_MAX, &letters)) return 1;
+            length = (size_t) letters;
+        } else if (strcmp(argv[i], "--words") == 0 && i + 1 < argc) {
+            words_path = argv[++i];
+        } else {
+            fprintf(stderr, "Error: unknown flag '%s'\n", argv[i]);
+            return 1;
+        }
+    }
+
+    if (length > 0 && boards_count > 1) {
+        fprintf(stderr, "Error: --length is a single board\n");
+        return 1;
+    }
+    if (words_path != NULL && length == 0) {
+        fprintf(stderr, "Error: --words goes with --length\n");
+        return 1;
+    }
+    if (length > 0 && length != VOCAB_WORD_LENGTH && words_path == NULL) {
+        fprintf(stderr, "Error: --length %zu needs a list of words with --words\n", length);
+        return 1;
+    }
+
     SetTraceLogLevel(LOG_WARNING);
+
+    // Must happen before anything allocates, blocks can't change allocators
+    if (track_allocs) {
+        allocator_set(alloc_tracker());
+        SetMemoryCallbacks(rl_alloc, rl_realloc, rl_free);
+    }
+
+    if (trace_path != NULL && !trace_start(trace_path)) {
+        return 1;
+    }
+
+    // Replays run unattended as fast as they can, with the answers of the recording
+    Replay_Reader player = {0};
+    uint64_t seed = (uint64_t) time(NULL);
+    if (replay_path != NULL) {
+        if (!replay_reader_open(&player, replay_path)) return 1;
+        size_t game_length = length > 0 ? length : VOCAB_WORD_LENGTH;
+        if (player.header.length != game_length || player.header.boards_count != boards_count) {
+            fprintf(stderr, "Error: '%s' was recorded with %zu boards of %zu letter words, replay it with the same --boards and --length\n",
+                replay_path, player.header.boards_count, player.header.length);
+            return 1;
+        }
+        seed = player.header.seed;
+        target_fps = 0;
+        late_latch = false;
+        threaded = false;
+    }
+    // The render thread never touches the game, there is nothing to latch
+    if (threaded) late_latch = false;
+    // Only the single board runs on the simulation thread and latches late
+    if (boards_count > 1 || length > 0) {
+        threaded = false;
+        late_latch = false;
+    }
+    trace_begin("InitWindow");
     InitWindow(1280, 720, "Vocab");
+    trace_end("InitWindow");
+
+    // Pace to the display unless told otherwise, 0 means uncapped
+    if (target_fps < 0) {
+        target_fps = GetMonitorRefreshRate(GetCurrentMonitor());
+    }
+    SetTargetFPS(target_fps);
+
+    // One GPU timestamp per frame in flight, ids are 0 if the GL can't do it
+    unsigned int latency_queries[LATENCY_FRAMES_IN_FLIGHT] = {0};
+    double latency_gpu_offsets[LATENCY_FRAMES_IN_FLIGHT] = {0};
+    if (measure_latency) {
+        for (size_t i = 0; i < LATENCY_FRAMES_IN_FLIGHT; ++i) {
+            latency_queries[i] = rlLoadTimestampQuery();
+        }
+    }
 
     // Preparing the words set
+    trace_begin("dictionary setup");
     for (size_t i = 0; i < words_count; ++i) {
-        hash_set_cstr_insert(&words_set, words[i]);
+        vocab_dict_insert(&words_dict, words[i]);
     }
+    vocab_columns_init(&words_columns, (const Cstr *) words, words_count);
+    vocab_prefix_init(&words_prefix, (const Cstr *) words, words_count);
+    // The answers and the valid guesses of the --length game
+    Da_Cstr length_words = {0};
+    String length_letters = {0};
+    if (length > 0) {
+        if (words_path == NULL) {
+            da_append_many(&length_words, (const Cstr *) words, words_count);
+        } else if (!load_words(words_path, length, &length_letters, &length_words)) {
+            return 1;
+        }
+        if (length_words.count == 0) {
+            fprintf(stderr, "Error: '%s' has no %zu letter words\n", words_path, length);
+            return 1;
+        }
+        vocab_word_set_init(&game_words, length, length_words.items, length_words.count);
+    } else {
+        vocab_word_set_init(&game_words, VOCAB_WORD_LENGTH, (const Cstr *) words, words_count);
+    }
+    trace_end("dictionary setup");
 
-    Vocab vocab = {0};
+    Vocab5 vocab = {0};
     UI_Stack ui = {0};
 
     // Choose random world
     {
-        srand(time(NULL));
-        size_t random_index = rand() % words_count;
-        vocab.word = words[random_index];
+        // Answers are indices into the list of the game, a replay has them already
+        const Cstr *list = length > 0 ? length_words.items : (const Cstr *) words;
+        size_t list_count = length > 0 ? length_words.count : words_count;
+        Replay_Header header = { .seed = seed, .length = length > 0 ? length : VOCAB_WORD_LENGTH, .boards_count = boards_count };
+        if (replay_path != NULL) {
+            for (size_t b = 0; b < boards_count; ++b) {
+                if (player.header.answers[b] >= list_count) {
+                    fprintf(stderr, "Error: '%s' has answers past the end of the word list, replay it with the same --words\n", replay_path);
+                    return 1;
+                }
+                header.answers[b] = player.header.answers[b];
+            }
+        } else {
+            srand((unsigned int) seed);
+            for (size_t b = 0; b < boards_count; ++b) {
+                // Every board gets a different answer
+                bool taken = true;
+                while (taken) {
+                    header.answers[b] = rand() % list_count;
+                    taken = false;
+                    for (size_t k = 0; k < b; ++k) taken = taken || header.answers[k] == header.answers[b];
+                }
+            }
+        }
+
+        if (length > 0) {
+            vocab_game_init(&game, length, list[header.answers[0]]);
+        } else {
+            vocab.word = list[header.answers[0]];
+        }
+        if (boards_count > 1) {
+            Cstr answers[VOCAB_BOARDS_CAP];
+            for (size_t b = 0; b < boards_count; ++b) answers[b] = list[header.answers[b]];
+            vocab_boards_init(&boards, answers, boards_count);
+        }
+
+        if (record_path != NULL && !replay_writer_open(&recorder, record_path, &header)) {
+            return 1;
+        }
+    }
+
+    pthread_t sim_thread_id;
+    if (threaded) {
+        sim_init(&sim, &vocab);
+        if (pthread_create(&sim_thread_id, NULL, sim_thread, &vocab) != 0) {
+            fprintf(stderr, "Error: could not start simulation thread\n");
+            return 1;
+        }
+    }
+
+    // Decoded in the background, the first frames draw with the default font
+    Assets assets = {0};
+    if (!assets_start(&assets, 1)) return 1;
+    Asset_Id font_id = assets_load_font(&assets, "./resources/ComicMono.ttf", 32, TEXTURE_FILTER_BILINEAR);
+    if (replay_path != NULL || screenshot_path != NULL || max_frames > 0) {
+        // Replays and golden image runs have to draw the same frames every time
+        trace_begin("assets finish");
+        assets_finish(&assets);
+        trace_end("assets finish");
     }
 
-    Font font = LoadFont("./resources/ComicMono.ttf");
-    SetTextureFilter(font.texture, TEXTURE_FILTER_BILINEAR);
+    size_t frame_index = 0;
+    size_t steady_allocs = 0;
+
+    // A submit that arrived while latching waits for the next frame, the rows
+    // above the active one are already drawn by then
+    Late_Latch latch = { .vocab = &vocab, .measure_latency = measure_latency };
+
+    uint64_t frame_start = time_now_ns();
+    uint64_t session_start = frame_start;
 
     while (!WindowShouldClose()) {
+        if (replay_path != NULL && replay_finished(&player, frame_index)) break;
+        if (max_frames > 0 && frame_index >= max_frames) break;
+
+        trace_begin("frame");
+        size_t latency_slot = 0;
+        if (measure_latency) {
+            latency_slot = latency_frame_begin(&latency);
+        }
+        assets_upload(&assets, VOCAB_UPLOAD_BYTES_PER_FRAME);
+        Font font = assets_font(&assets, font_id, GetFontDefault());
+
         BeginDrawing();
         ClearBackground(BLACK);
 
-        if (vocab.current_attempt < VOCAB_ATTEMPTS_COUNT) {
-            // Erase letter
-            if (vocab.cursor > 0 && IsKeyPressed(KEY_BACKSPACE)) {
-                vocab.grid[vocab.current_attempt][vocab.cursor - 1] = '\0';
-                vocab.cursor -= 1;
+        trace_begin("input");
+        // Events come in the order they were typed, so a fast "abc<Backspace>d<Enter>"
+        // inside one frame plays out the same as it would when typed slowly
+        InputEvent event;
+        if (threaded) {
+            // Handed over as they are, the simulation thread applies and records them
+            while (GetInputEvent(&event)) {
+                sim_push_event(&sim, (Sim_Event) { frame_index, event.type, event.value, event.time });
             }
-
-            // Attempt word
-            if (vocab.cursor >= VOCAB_WORD_LENGTH && IsKeyPressed(KEY_ENTER)) {
-                char word[VOCAB_WORD_LENGTH + 1] = {0};
-                strncpy(word, vocab.grid[vocab.current_attempt], VOCAB_WORD_LENGTH);
-
-                bool contains = hash_set_cstr_contains(&words_set, word);
-                if (contains) {
-                    vocab.current_attempt += 1;
-                    vocab.cursor = 0;
-                }
+        }
+        if (replay_path != NULL) {
+            // The log drives the game, live input is thrown away
+            while (GetInputEvent(&event)) {}
+            int kind = 0;
+            int value = 0;
+            while (replay_next_event(&player, frame_index, &kind, &value)) {
+                InputEvent replayed = { kind, value, GetTime() };
+                if (handle_input_event(&vocab, &replayed, frame_index) && measure_latency) latency_input(&latency, replayed.time);
             }
-
-            // Type letter
-            for (int ch = GetCharPressed(); ch != 0; ch = GetCharPressed()) {
-                if (vocab.cursor < VOCAB_WORD_LENGTH && isalpha(ch)) {
-                    vocab.grid[vocab.current_attempt][vocab.cursor] = (char) ch;
-                    vocab.cursor += 1;
+        }
+        if (latch.has_deferred) {
+            if (handle_input_event(&vocab, &latch.deferred, frame_index) && measure_latency) latency_input(&latency, latch.deferred.time);
+            latch.has_deferred = false;
+        }
+        while (GetInputEvent(&event)) {
+            if (handle_input_event(&vocab, &event, frame_index) && measure_latency) latency_input(&latency, event.time);
+        }
+        trace_counter("input events dropped", GetInputEventsDropped());
+        trace_end("input");
+
+        // What gets drawn, with --sim-thread the newest game the simulation published
+        const Vocab5 *view = &vocab;
+        if (threaded) {
+            bool fresh = false;
+            const Sim_Snapshot *snapshot = sim_latest(&sim, &fresh);
+            view = &snapshot->vocab;
+            if (fresh && measure_latency) {
+                const double *input_times = NULL;
+                size_t input_count = sim_new_inputs(&sim, snapshot, &input_times);
+                for (size_t i = 0; i < input_count; ++i) {
+                    latency_input(&latency, input_times[i]);
                 }
             }
+            trace_counter("sim events dropped", sim.events_dropped);
         }
 
-        int32_t square_size = 100;
-        int32_t vocab_width = square_size * VOCAB_WORD_LENGTH;
-        int32_t vocab_height = square_size * VOCAB_ATTEMPTS_COUNT;
+        // Where the row being typed can still go, a few steps per letter so
+        // it is looked up again every frame
+        const char *live_row = NULL;
+        size_t live_length = 0;
+        bool rejected = false;
+        if (boards.count > 0) {
+            if (!vocab_boards_is_over(&boards)) {
+                live_row = boards.grid[boards.current_attempt];
+                live_length = boards.cursor;
+                rejected = boards.rejected;
+            }
+        } else if (game.length > 0) {
+            // Completions and suggestions only know the 5 letter words
+        } else if (!vocab5_is_over(view)) {
+            live_row = view->grid[view->current_attempt];
+            live_length = view->cursor;
+            rejected = view->rejected;
+        }
+        Vocab_Prefix_Range live_range = vocab_prefix_find(&words_prefix, live_row, live_length);
+        bool dead_end = live_length > 0 && live_range.begin == live_range.end;
 
         int32_t window_width = GetScreenWidth();
         int32_t window_height = GetScreenHeight();
 
-        UI_Rect rect = {
-            (window_width - vocab_width) / 2,
-            (window_height - vocab_height) / 2,
-            vocab_width,
-            vocab_height,
-        };
-
-        int32_t gap = 10;
-        float font_size = 48.0f;
-
-        ui_layout_begin(&ui, rect, UI_VERT, ui_marginv(gap), gap, VOCAB_ATTEMPTS_COUNT);
-        for (size_t i = 0; i < VOCAB_ATTEMPTS_COUNT; ++i) {
-            UI_Rect row = ui_layout_rect(&ui);
-            ui_layout_begin(&ui, row, UI_HORI, ui_marginv(0), gap, VOCAB_WORD_LENGTH);
-            for (size_t j = 0; j < VOCAB_WORD_LENGTH; ++j) {
-                UI_Rect square = ui_layout_rect(&ui);
-
-                Color background_color;
-                switch (vocab.color_grid[i][j]) {
-                case VOCAB_BLACK: background_color = BLACK; break;
-                case VOCAB_GRAY: background_color = GRAY; break;
-                case VOCAB_YELLOW: background_color = YELLOW; break;
-                case VOCAB_GREEN: background_color = GREEN; break;
-                }
+        trace_begin("draw");
+        if (boards.count > 0) {
+            draw_boards(&ui, &boards, font, window_width, window_height, dead_end);
+        } else if (game.length > 0) {
+            draw_game(&ui, &game, font, window_width, window_height);
+        } else {
+            latch.frame_index = frame_index;
+            Vocab_Draw_Hook hook = late_latch ? late_latch_input : NULL;
+            UI_Rect board = vocab5_draw(&ui, view, font, window_width, window_height - VOCAB_STATUS_LINE_HEIGHT, dead_end, hook, &latch);
+            if (helper) draw_helper(view, board, font);
+        }
+        if (rejected) {
+            draw_suggestions(live_row, font, window_width, window_height);
+        } else if (live_length > 0 && live_length < VOCAB_WORD_LENGTH) {
+            draw_completions(live_row, live_length, live_range, font, window_width, window_height);
+        }
+        trace_end("draw");
+
+        // Only frames that took input are followed to the GPU
+        bool latency_frame = measure_latency && latency.frames[latency_slot].input_count > 0;
+        if (latency_frame) {
+            latency_stage(&latency, LATENCY_LAYOUT, GetTime());
+            rlDrawRenderBatchActive();
+            latency_stage(&latency, LATENCY_SUBMIT, GetTime());
+            rlTimestampQuery(latency_queries[latency_slot]);
+            latency_gpu_offsets[latency_slot] = GetTime() - rlGetGpuTimestamp();
+        }
 
-                DrawRectangle(square.x, square.y, square.w, square.h, background_color);
-                DrawRectangleLines(square.x, square.y, square.w, square.h, WHITE);
+        trace_begin("EndDrawing");
+        EndDrawing();
+        trace_end("EndDrawing");
+        trace_counter("pacing error us", (int64_t) (GetFramePacingError() * 1e6));
+
+        if (latency_frame) {
+            latency_stage(&latency, LATENCY_SWAP, GetFrameSwapTime());
+            latency_frame_end(&latency);
+        }
+        if (measure_latency) {
+            // Never blocks on the GPU, frames are picked up once their timestamp is ready
+            for (size_t i = 0; i < LATENCY_FRAMES_IN_FLIGHT; ++i) {
+                if (!latency.frames[i].pending) continue;
+                double gpu_time = 0.0;
+                if (latency_queries[i] == 0) {
+                    latency_resolve(&latency, i, -1.0);
+                } else if (rlGetTimestampQueryResult(latency_queries[i], &gpu_time)) {
+                    latency_resolve(&latency, i, gpu_time + latency_gpu_offsets[i]);
+                }
+            }
+        }
 
-                int spacing = 6;
-                const char *text = TextFormat("%c", toupper(vocab.grid[i][j]));
-                Vector2 text_pos = { square.x + square.w / 2, square.y + square.h / 2 };
-                Vector2 text_size = MeasureTextEx(font, text, font_size, spacing);
-                Vector2 origin = { text_size.x / 2, text_size.y / 2 };
-                DrawTextPro(font, text, text_pos, origin, 0.0f, font_size, spacing, WHITE);
+        if (track_allocs) {
+            Alloc_Stats frame = alloc_frame_end();
+            if (frame_index >= VOCAB_ALLOC_WARMUP_FRAMES && frame.frame_count > 0) {
+                fprintf(stderr, "[ALLOC]: frame %zu: %zu allocations, %zu bytes\n",
+                    frame_index, frame.frame_count, frame.frame_bytes);
+                steady_allocs += frame.frame_count;
             }
-            ui_layout_end(&ui);
+            trace_counter("frame allocations", frame.frame_count);
         }
-        ui_layout_end(&ui);
+        trace_end("frame");
 
-        EndDrawing();
+        uint64_t frame_end = time_now_ns();
+        latency_samples_push(&frame_times, (double) (frame_end - frame_start) * 1e-9);
+        frame_start = frame_end;
+
+        frame_index += 1;
+        if (frame_index % VOCAB_TRACE_FLUSH_FRAMES == 0) {
+            trace_begin("trace flush");
+            trace_flush();
+            trace_end("trace flush");
+        }
+    }
+
+    // The last frame, for diffing against a golden image. Only the headless
+    // backend keeps the framebuffer around after the swap, a window may not
+    int result = 0;
+    if (screenshot_path != NULL) {
+        Image screen = LoadImageFromScreen();
+        if (!ExportImage(screen, screenshot_path)) {
+            fprintf(stderr, "Error: could not write screenshot '%s'\n", screenshot_path);
+            result = 1;
+        }
+        UnloadImage(screen);
     }
 
     ui_stack_free(&ui);
-    UnloadFont(font);
+    vocab_columns_free(&words_columns);
+    vocab_word_set_free(&game_words);
+    da_free(&length_words);
+    da_free(&length_letters);
+    vocab_prefix_free(&words_prefix);
+    vocab_dict_free(&words_dict);
+    assets_stop(&assets);
+    for (size_t i = 0; i < LATENCY_FRAMES_IN_FLIGHT; ++i) {
+        rlUnloadTimestampQuery(latency_queries[i]);
+    }
     CloseWindow();
-    return 0;
+    if (threaded) {
+        sim_stop(&sim);
+        pthread_join(sim_thread_id, NULL);
+        sim_free(&sim);
+    }
+    trace_stop();
+    replay_writer_close(&recorder, frame_index);
+
+    if (replay_path != NULL) {
+        replay_reader_close(&player);
+        if (boards.count > 0) {
+            fprintf(stderr, "[REPLAY]: %zu attempts used, %zu of %zu boards solved\n",
+                boards.current_attempt, boards.solved_count, boards.count);
+        } else if (game.length > 0) {
+            fprintf(stderr, "[REPLAY]: %zu attempts used, %zu letters\n", vocab_game_current_attempt(&game), game.length);
+        } else {
+            fprintf(stderr, "[REPLAY]: %zu attempts used\n", vocab.current_attempt);
+        }
+    }
+
+    // Runs with a known end are benchmarks, interactive ones are not worth timing
+    if ((replay_path != NULL || max_frames > 0 || threaded) && frame_times.count > 0) {
+        double seconds = (double) (time_now_ns() - session_start) * 1e-9;
+        fprintf(stderr, "[FRAMES]: %zu frames in %.3f s\n", frame_index, seconds);
+        fprintf(stderr, "[FRAMES]: frame time ms: p50 %.3f, p90 %.3f, p99 %.3f, p99.9 %.3f, max %.3f\n",
+            latency_samples_percentile(&frame_times, 0.50) * 1e3,
+            latency_samples_percentile(&frame_times, 0.90) * 1e3,
+            latency_samples_percentile(&frame_times, 0.99) * 1e3,
+            latency_samples_percentile(&frame_times, 0.999) * 1e3,
+            latency_samples_percentile(&frame_times, 1.0) * 1e3);
+    }
+
+    if (threaded && sim_step_times.count > 0) {
+        fprintf(stderr, "[SIM]: %zu steps, %zu events dropped\n", sim_step_times.count, sim.events_dropped);
+        fprintf(stderr, "[SIM]: step time us: p50 %.3f, p90 %.3f, p99 %.3f, max %.3f\n",
+            latency_samples_percentile(&sim_step_times, 0.50) * 1e6,
+            latency_samples_percentile(&sim_step_times, 0.90) * 1e6,
+            latency_samples_percentile(&sim_step_times, 0.99) * 1e6,
+            latency_samples_percentile(&sim_step_times, 1.0) * 1e6);
+    }
+
+    if (measure_latency) {
+        latency_report(&latency, stderr);
+    }
+
+    if (track_allocs) {
+        alloc_report(stderr);
+        if (steady_allocs > 0) {
+            fprintf(stderr, "Error: %zu allocations after the first %d frames\n",
+                steady_allocs, VOCAB_ALLOC_WARMUP_FRAMES);
+            return 1;
+        }
+    }
+
+    return result;
 }
@@ -0,0 +1,136 @@
+// Letter rack puzzles out of words.c, `./comp puzzle` builds and runs it.
+//
+// A rack is a word from the list with a few more letters drawn the way they
+// show up in the list, and the puzzle is every word that can be spelled from
+// it. Racks are drawn until one has a number of answers within the bounds.
+// Answers are printed a line per set of letters, anagrams of each other
+// together, so the puzzle can say how many words hide behind each one.
+
+// For clock_gettime() in time_now_ns()
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#define COMP_IMPLEMENTATION
+#include "./comp.h"
+
+#define VOCAB_IMPLEMENTATION
+#include "./vocab.h"
+
+#include "words.c"
+
+#define PUZZLE_RACK_CAP 16
+// Racks drawn for one puzzle before giving up on the bounds
+#define PUZZLE_ATTEMPTS 100000
+
+static uint64_t rng = 0;
+
+static uint64_t rng_next(void) {
+    // xorshift64*
+    rng ^= rng >> 12;
+    rng ^= rng << 25;
+    rng ^= rng >> 27;
+    return rng * 0x2545F4914F6CDD1DULL;
+}
+
+static void usage(Cstr program) {
+    fprintf(stderr, "Usage: %s [options]\n", program);
+    fprintf(stderr, "    --rack <n>           letters in a rack, %d to %d (default 7)\n", VOCAB_WORD_LENGTH, PUZZLE_RACK_CAP);
+    fprintf(stderr, "    --min <n>            fewest answers a puzzle may have (default 10)\n");
+    fprintf(stderr, "    --max <n>            most answers a puzzle may have (default 40)\n");
+    fprintf(stderr, "    --count <n>          puzzles to make (default 1)\n");
+    fprintf(stderr, "    --seed <n>           seed for the racks\n");
+}
+
+int main(int argc, const char **argv) {
+    size_t rack_length = 7;
+    size_t min_answers = 10;
+    size_t max_answers = 40;
+    size_t puzzles = 1;
+    uint64_t seed = time_now_ns();
+    for (int i = 1; i < argc; ++i) {
+        long number = 0;
+        if (strcmp(argv[i], "--rack") == 0 && i + 1 < argc) {
+            if (!parse_flag_number("--rack", argv[++i], VOCAB_WORD_LENGTH, PUZZLE_RACK_CAP, &number)) return 1;
+            rack_length = (size_t) number;
+        } else if (strcmp(argv[i], "--min") == 0 && i + 1 < argc) {
+            if (!parse_flag_number("--min", argv[++i], 1, (long) words_count, &number)) return 1;
+            min_answers = (size_t) number;
+        } else if (strcmp(argv[i], "--max") == 0 && i + 1 < argc) {
+            if (!parse_flag_number("--max", argv[++i], 1, (long) words_count, &number)) return 1;
+            max_answers = (size_t) number;
+        } else if (strcmp(argv[i], "--count") == 0 && i + 1 < argc) {
+            if (!parse_flag_number("--count", argv[++i], 1, 1000000, &number)) return 1;
+            puzzles = (size_t) number;
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            if (!parse_flag_seed("--seed", argv[++i], &seed)) return 1;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (min_answers > max_answers) {
+        fprintf(stderr, "Error: --min %zu is more than --max %zu\n", min_answers, max_answers);
+        return 1;
+    }
+    rng = seed | 1;
+
+    Vocab_Anagrams anagrams;
+    vocab_anagrams_init(&anagrams, (const Cstr *) words, words_count);
+    size_t *answers = comp_realloc(NULL, words_count*sizeof(size_t));
+    bool *printed = comp_realloc(NULL, words_count*sizeof(bool));
+    assert(answers != NULL && printed != NULL && "Buy more RAM lol");
+
+    for (size_t p = 0; p < puzzles; ++p) {
+        char rack[PUZZLE_RACK_CAP + 1];
+        size_t answers_count = 0;
+        size_t attempt = 0;
+        for (; attempt < PUZZLE_ATTEMPTS; ++attempt) {
+            memcpy(rack, words[rng_next() % words_count], VOCAB_WORD_LENGTH);
+            for (size_t i = VOCAB_WORD_LENGTH; i < rack_length; ++i) {
+                rack[i] = words[rng_next() % words_count][rng_next() % VOCAB_WORD_LENGTH];
+            }
+            rack[rack_length] = '\0';
+            answers_count = vocab_anagrams_within(&anagrams, vocab_letters(rack, rack_length), answers, words_count);
+            if (answers_count >= min_answers && answers_count <= max_answers) break;
+        }
+        if (attempt == PUZZLE_ATTEMPTS) {
+            fprintf(stderr, "Error: no rack of %zu letters in %d tries has %zu to %zu answers\n", rack_length, PUZZLE_ATTEMPTS, min_answers, max_answers);
+            return 1;
+        }
+
+        // Shuffled so the rack doesn't start with a word
+        for (size_t i = rack_length - 1; i > 0; --i) {
+            size_t j = rng_next() % (i + 1);
+            char c = rack[i];
+            rack[i] = rack[j];
+            rack[j] = c;
+        }
+        for (size_t i = 0; i < rack_length; ++i) {
+            rack[i] = (char) (rack[i] - 'a' + 'A');
+        }
+
+        // Anagrams of an answer are answers too, they use the same letters
+        size_t groups = 0;
+        for (size_t i = 0; i < answers_count; ++i) {
+            Vocab_Prefix_Range range = vocab_anagrams_find(&anagrams, words[answers[i]]);
+            groups += anagrams.order[range.begin] == answers[i];
+        }
+        printf("%sRack: %s\n", p == 0 ? "" : "\n", rack);
+        printf("%zu words, %zu sets of letters\n", answers_count, groups);
+        memset(printed, 0, words_count*sizeof(bool));
+        for (size_t i = 0; i < answers_count; ++i) {
+            if (printed[answers[i]]) continue;
+            Vocab_Prefix_Range range = vocab_anagrams_find(&anagrams, words[answers[i]]);
+            printf("   ");
+            for (size_t j = range.begin; j < range.end; ++j) {
+                printed[anagrams.order[j]] = true;
+                printf(" %s", words[anagrams.order[j]]);
+            }
+            printf("\n");
+        }
+    }
+    return 0;
+}
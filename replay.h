@@ -0,0 +1,223 @@
+#ifndef REPLAY_H_
+#define REPLAY_H_
+
+// Session logs for deterministic replays. A log is the game that was played,
+// its word length, boards and the answers, and every input event the game
+// got, tagged with the frame it was applied on, so feeding it back frame by
+// frame rebuilds the same game. Answers are stored as indices into the word
+// list and not as the seed they were drawn with, rand() is not the same
+// sequence on every C library.
+//
+// Layout, integers are little endian and varints are LEB128:
+//     "VOCB" u8 version u64 seed u8 length u8 boards { varint answer } ...
+//     { varint frame delta, u8 kind, varint value } ...
+// The last record has kind REPLAY_END and the delta to the frame count.
+// Kinds below REPLAY_END are raylib InputEventType values, no raylib in here.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "./comp.h"
+
+#define REPLAY_VERSION 2
+#define REPLAY_END 0xFF
+// Same as VOCAB_BOARDS_CAP
+#define REPLAY_BOARDS_CAP 64
+
+typedef struct {
+    uint64_t seed;
+    size_t length;       // Letters in a word
+    size_t boards_count;
+    // Index of the answer of every board in the word list of the game
+    size_t answers[REPLAY_BOARDS_CAP];
+} Replay_Header;
+
+typedef struct {
+    FILE *file;
+    uint64_t last_frame;
+} Replay_Writer;
+
+typedef struct {
+    unsigned char *data;
+    size_t size;
+    size_t pos;
+    Replay_Header header;
+    // Next record, already decoded
+    uint64_t frame;
+    int kind;
+    int value;
+} Replay_Reader;
+
+bool replay_writer_open(Replay_Writer *writer, Cstr path, const Replay_Header *header);
+// Events must come in order, `frame` never goes back
+void replay_write_event(Replay_Writer *writer, uint64_t frame, int kind, int value);
+void replay_writer_close(Replay_Writer *writer, uint64_t frames_count);
+
+bool replay_reader_open(Replay_Reader *reader, Cstr path);
+// Pops the next event applied on `frame`, returns false once there are none left
+bool replay_next_event(Replay_Reader *reader, uint64_t frame, int *kind, int *value);
+// Whether the session being replayed was over by `frame`
+bool replay_finished(Replay_Reader *reader, uint64_t frame);
+void replay_reader_close(Replay_Reader *reader);
+
+#endif // REPLAY_H_
+
+#ifdef REPLAY_IMPLEMENTATION
+#undef REPLAY_IMPLEMENTATION
+
+static const char replay_magic[4] = {'V', 'O', 'C', 'B'};
+
+static void replay_put_varint(FILE *file, uint64_t value) {
+    while (value >= 0x80) {
+        fputc((int) (value & 0x7F) | 0x80, file);
+        value >>= 7;
+    }
+    fputc((int) value, file);
+}
+
+static bool replay_get_varint(Replay_Reader *reader, uint64_t *value) {
+    *value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (reader->pos >= reader->size) return false;
+        unsigned char byte = reader->data[reader->pos++];
+        *value |= (uint64_t) (byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+bool replay_writer_open(Replay_Writer *writer, Cstr path, const Replay_Header *header) {
+    assert(header->length <= 0xFF && header->boards_count >= 1 && header->boards_count <= REPLAY_BOARDS_CAP);
+    writer->file = fopen(path, "wb");
+    if (writer->file == NULL) {
+        fprintf(stderr, "Error: could not open replay file '%s'\n", path);
+        return false;
+    }
+    writer->last_frame = 0;
+
+    fwrite(replay_magic, 1, sizeof(replay_magic), writer->file);
+    fputc(REPLAY_VERSION, writer->file);
+    for (int i = 0; i < 8; ++i) {
+        fputc((int) ((header->seed >> (i * 8)) & 0xFF), writer->file);
+    }
+    fputc((int) header->length, writer->file);
+    fputc((int) header->boards_count, writer->file);
+    for (size_t i = 0; i < header->boards_count; ++i) {
+        replay_put_varint(writer->file, header->answers[i]);
+    }
+    return true;
+}
+
+void replay_write_event(Replay_Writer *writer, uint64_t frame, int kind, int value) {
+    assert(frame >= writer->last_frame);
+    replay_put_varint(writer->file, frame - writer->last_frame);
+    fputc(kind, writer->file);
+    replay_put_varint(writer->file, (uint64_t) (unsigned int) value);
+    writer->last_frame = frame;
+}
+
+void replay_writer_close(Replay_Writer *writer, uint64_t frames_count) {
+    if (writer->file == NULL) return;
+    replay_write_event(writer, frames_count, REPLAY_END, 0);
+    fclose(writer->file);
+    writer->file = NULL;
+}
+
+// Decodes the record at `pos`, a broken log ends the replay right there
+static void replay_read_record(Replay_Reader *reader) {
+    uint64_t delta = 0;
+    uint64_t value = 0;
+    if (!replay_get_varint(reader, &delta) || reader->pos >= reader->size) {
+        fprintf(stderr, "Error: replay log is truncated\n");
+        reader->kind = REPLAY_END;
+        return;
+    }
+    reader->frame += delta;
+    reader->kind = reader->data[reader->pos++];
+    if (!replay_get_varint(reader, &value)) {
+        fprintf(stderr, "Error: replay log is truncated\n");
+        reader->kind = REPLAY_END;
+        return;
+    }
+    reader->value = (int) (unsigned int) value;
+}
+
+bool replay_reader_open(Replay_Reader *reader, Cstr path) {
+    *reader = (Replay_Reader) {0};
+
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "Error: could not open replay file '%s'\n", path);
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (size < 0) {
+        fprintf(stderr, "Error: could not read replay file '%s'\n", path);
+        fclose(file);
+        return false;
+    }
+
+    reader->size = (size_t) size;
+    reader->data = comp_realloc(NULL, reader->size + 1);
+    assert(reader->data != NULL && "Error: not enough RAM");
+    size_t read = fread(reader->data, 1, reader->size, file);
+    fclose(file);
+
+    size_t header_size = sizeof(replay_magic) + 1 + 8 + 2;
+    if (read != reader->size || reader->size < header_size
+        || memcmp(reader->data, replay_magic, sizeof(replay_magic)) != 0) {
+        fprintf(stderr, "Error: '%s' is not a replay file\n", path);
+        replay_reader_close(reader);
+        return false;
+    }
+    if (reader->data[sizeof(replay_magic)] != REPLAY_VERSION) {
+        fprintf(stderr, "Error: '%s' has replay version %d, expected %d\n",
+            path, reader->data[sizeof(replay_magic)], REPLAY_VERSION);
+        replay_reader_close(reader);
+        return false;
+    }
+    Replay_Header *header = &reader->header;
+    for (int i = 0; i < 8; ++i) {
+        header->seed |= (uint64_t) reader->data[sizeof(replay_magic) + 1 + i] << (i * 8);
+    }
+    header->length = reader->data[header_size - 2];
+    header->boards_count = reader->data[header_size - 1];
+    reader->pos = header_size;
+    bool answers_read = header->boards_count >= 1 && header->boards_count <= REPLAY_BOARDS_CAP;
+    for (size_t i = 0; answers_read && i < header->boards_count; ++i) {
+        uint64_t answer = 0;
+        answers_read = replay_get_varint(reader, &answer);
+        header->answers[i] = (size_t) answer;
+    }
+    if (!answers_read) {
+        fprintf(stderr, "Error: '%s' has a broken replay header\n", path);
+        replay_reader_close(reader);
+        return false;
+    }
+
+    replay_read_record(reader);
+    return true;
+}
+
+bool replay_next_event(Replay_Reader *reader, uint64_t frame, int *kind, int *value) {
+    if (reader->kind == REPLAY_END || reader->frame > frame) return false;
+    *kind = reader->kind;
+    *value = reader->value;
+    replay_read_record(reader);
+    return true;
+}
+
+bool replay_finished(Replay_Reader *reader, uint64_t frame) {
+    return reader->kind == REPLAY_END && frame >= reader->frame;
+}
+
+void replay_reader_close(Replay_Reader *reader) {
+    comp_free(reader->data);
+    *reader = (Replay_Reader) {0};
+}
+
+#endif // REPLAY_IMPLEMENTATION
@@ -0,0 +1,573 @@
+// Vocab over the network, `./comp server` builds and runs it. No raylib in here.
+//
+// Sessions are spread over a fixed set of worker threads, every worker runs its
+// own epoll loop over the listening sockets and the connections it accepted,
+// so a session is only ever touched by one thread and nothing is shared but
+// the dictionary. Sockets are non-blocking and level triggered.
+//
+// Protocol, one request per line and one response line per request:
+//     guess <word>   ok <colors> | won <colors> | lost <colors> <answer> | invalid | over
+//     new            ok
+//     quit           the server closes the connection
+//     anything else  error <reason>
+// Colors are a character per letter, 'g' green, 'y' yellow and '-' gray. On
+// connect the server sends "vocab <attempts> <word length>".
+
+// For accept4()
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdarg.h>
+#include <ctype.h>
+#include <errno.h>
+#include <signal.h>
+#include <pthread.h>
+
+#ifndef __linux__
+    #error "The server needs epoll, it only builds on Linux"
+#endif
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#define COMP_IMPLEMENTATION
+#include "./comp.h"
+
+#define VOCAB_IMPLEMENTATION
+#include "./vocab.h"
+
+#define LATENCY_IMPLEMENTATION
+#include "./latency.h"
+
+#include "words.c"
+
+#define SERVER_DEFAULT_PORT 6000
+#define SERVER_WORKERS_CAP 64
+#define SERVER_LISTENERS_CAP 2
+#define SERVER_EVENTS_CAP 256
+// Sessions are allocated this many at a time and never given back, closed
+// ones are reused
+#define SERVER_SESSIONS_PER_CHUNK 1024
+// Longest request line, newline included
+#define SERVER_IN_CAP 32
+#define SERVER_OUT_CAP 64
+// Longest response line, "error request too long\n"
+#define SERVER_RESPONSE_MAX 24
+
+typedef enum {
+    CONN_LISTENER = 0,
+    CONN_SESSION,
+    CONN_STOP,
+} Conn_Kind;
+
+// What epoll hands back, every connection type starts with it
+typedef struct {
+    Conn_Kind kind;
+    int fd;
+} Conn;
+
+typedef struct Session {
+    Conn conn;
+    Vocab_Packed vocab;
+    char in[SERVER_IN_CAP];
+    size_t in_count;
+    char out[SERVER_OUT_CAP];
+    size_t out_count;
+    // EPOLLOUT is armed, the socket did not take the whole response
+    bool writing;
+    struct Session *next_free;
+} Session;
+
+typedef struct {
+    Session **items;
+    size_t count;
+    size_t capacity;
+} Session_Chunks;
+
+typedef struct {
+    size_t index;
+    pthread_t thread;
+    int epoll_fd;
+    uint64_t rng;
+    Session_Chunks chunks;
+    Session *free_list;
+
+    size_t sessions_live;
+    size_t sessions_peak;
+    size_t sessions_total;
+    size_t guesses;
+    size_t accept_errors;
+    // Time from a request line being read to its response being queued
+    Latency_Samples request_times;
+} Worker;
+
+static Vocab_Dict words_dict = {0};
+static Conn listeners[SERVER_LISTENERS_CAP] = {0};
+static size_t listeners_count = 0;
+// Written once by the signal handler, every worker sees it and leaves
+static Conn stop_conn = { CONN_STOP, -1 };
+static Worker workers[SERVER_WORKERS_CAP] = {0};
+static size_t workers_count = 0;
+
+static uint64_t worker_random(Worker *worker) {
+    // xorshift64*
+    worker->rng ^= worker->rng >> 12;
+    worker->rng ^= worker->rng << 25;
+    worker->rng ^= worker->rng >> 27;
+    return worker->rng * 0x2545F4914F6CDD1DULL;
+}
+
+static void session_new_game(Worker *worker, Session *session) {
+    session->vocab = vocab_packed_new(worker_random(worker) % words_count);
+}
+
+static Session *session_alloc(Worker *worker) {
+    if (worker->free_list == NULL) {
+        Session *chunk = comp_realloc(NULL, SERVER_SESSIONS_PER_CHUNK * sizeof(Session));
+        assert(chunk != NULL && "Buy more RAM lol");
+        da_append(&worker->chunks, chunk);
+        for (size_t i = SERVER_SESSIONS_PER_CHUNK; i > 0; --i) {
+            chunk[i - 1].next_free = worker->free_list;
+            worker->free_list = &chunk[i - 1];
+        }
+    }
+    Session *session = worker->free_list;
+    worker->free_list = session->next_free;
+    memset(session, 0, sizeof(*session));
+    return session;
+}
+
+static void session_close(Worker *worker, Session *session) {
+    // Closing the last reference to the socket takes it out of the epoll set too
+    close(session->conn.fd);
+    session->next_free = worker->free_list;
+    worker->free_list = session;
+    worker->sessions_live -= 1;
+}
+
+static void session_reply(Session *session, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(session->out + session->out_count, SERVER_OUT_CAP - session->out_count, fmt, args);
+    va_end(args);
+    assert(n > 0 && session->out_count + (size_t) n < SERVER_OUT_CAP);
+    session->out_count += (size_t) n;
+}
+
+static void session_guess(Session *session, const char *word, size_t length) {
+    Vocab_Packed *vocab = &session->vocab;
+    if (vocab_packed_is_over(vocab)) {
+        session_reply(session, "over\n");
+        return;
+    }
+    if (length != VOCAB_WORD_LENGTH) {
+        session_reply(session, "invalid\n");
+        return;
+    }
+
+    for (size_t i = 0; i < length; ++i) {
+        if (!isalpha((unsigned char) word[i])) {
+            session_reply(session, "invalid\n");
+            return;
+        }
+    }
+    for (size_t i = 0; i < length; ++i) {
+        vocab_packed_type_letter(vocab, (char) tolower((unsigned char) word[i]));
+    }
+    if (!vocab_packed_submit(vocab, (const Cstr *) words, &words_dict)) {
+        while (vocab_packed_cursor(vocab) > 0) vocab_packed_erase_letter(vocab);
+        session_reply(session, "invalid\n");
+        return;
+    }
+
+    char colors[VOCAB_WORD_LENGTH + 1] = {0};
+    for (size_t i = 0; i < VOCAB_WORD_LENGTH; ++i) {
+        switch (vocab_packed_color(vocab, vocab_packed_attempt(vocab) - 1, i)) {
+        case VOCAB_GREEN: colors[i] = 'g'; break;
+        case VOCAB_YELLOW: colors[i] = 'y'; break;
+        default: colors[i] = '-'; break;
+        }
+    }
+
+    if (!vocab_packed_is_over(vocab)) {
+        session_reply(session, "ok %s\n", colors);
+    } else if (strcmp(colors, "ggggg") == 0) {
+        session_reply(session, "won %s\n", colors);
+    } else {
+        session_reply(session, "lost %s %s\n", colors, words[vocab_packed_answer(vocab)]);
+    }
+}
+
+// Returns false if the connection has to be closed
+static bool session_request(Worker *worker, Session *session, char *line, size_t length) {
+    if (length > 0 && line[length - 1] == '\r') length -= 1;
+
+    if (length > 6 && memcmp(line, "guess ", 6) == 0) {
+        worker->guesses += 1;
+        session_guess(session, line + 6, length - 6);
+    } else if (length == 3 && memcmp(line, "new", 3) == 0) {
+        session_new_game(worker, session);
+        session_reply(session, "ok\n");
+    } else if (length == 4 && memcmp(line, "quit", 4) == 0) {
+        return false;
+    } else {
+        session_reply(session, "error unknown request\n");
+    }
+    return true;
+}
+
+// Sends what it can, arms EPOLLOUT for the rest. Returns false on a dead socket
+static bool session_flush(Worker *worker, Session *session) {
+    size_t sent = 0;
+    while (sent < session->out_count) {
+        ssize_t n = send(session->conn.fd, session->out + sent, session->out_count - sent, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return false;
+        }
+        sent += (size_t) n;
+    }
+    memmove(session->out, session->out + sent, session->out_count - sent);
+    session->out_count -= sent;
+
+    // Stop reading while the client doesn't take its responses, the kernel
+    // buffers push back on it from there
+    bool writing = session->out_count > 0;
+    if (writing != session->writing) {
+        struct epoll_event event = {
+            .events = writing ? EPOLLOUT : EPOLLIN | EPOLLRDHUP,
+            .data.ptr = session,
+        };
+        if (epoll_ctl(worker->epoll_fd, EPOLL_CTL_MOD, session->conn.fd, &event) < 0) return false;
+        session->writing = writing;
+    }
+    return true;
+}
+
+// Handles the complete lines in the input buffer while there is room for their
+// responses. Returns false if the connection has to be closed
+static bool session_process(Worker *worker, Session *session) {
+    size_t start = 0;
+    while (session->out_count + SERVER_RESPONSE_MAX < SERVER_OUT_CAP) {
+        char *newline = memchr(session->in + start, '\n', session->in_count - start);
+        if (newline == NULL) break;
+
+        uint64_t request_start = time_now_ns();
+        size_t length = (size_t) (newline - (session->in + start));
+        bool keep = session_request(worker, session, session->in + start, length);
+        latency_samples_push(&worker->request_times, (double) (time_now_ns() - request_start) * 1e-9);
+        if (!keep) return false;
+        start += length + 1;
+    }
+    memmove(session->in, session->in + start, session->in_count - start);
+    session->in_count -= start;
+
+    if (session->in_count == SERVER_IN_CAP && memchr(session->in, '\n', session->in_count) == NULL) {
+        // A full buffer without a newline, no request is that long
+        session_reply(session, "error request too long\n");
+        session_flush(worker, session);
+        return false;
+    }
+    return true;
+}
+
+// Answers buffered requests until they run out or the socket is full.
+// Returns false if the connection has to be closed
+static bool session_pump(Worker *worker, Session *session) {
+    for (;;) {
+        if (!session_process(worker, session) || !session_flush(worker, session)) return false;
+        if (session->writing || memchr(session->in, '\n', session->in_count) == NULL) return true;
+    }
+}
+
+static void session_readable(Worker *worker, Session *session) {
+    // Never full here, session_pump() leaves no complete line behind unless
+    // the socket is full, and then the session waits for EPOLLOUT instead
+    ssize_t n = recv(session->conn.fd, session->in + session->in_count, SERVER_IN_CAP - session->in_count, 0);
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+        session_close(worker, session);
+        return;
+    }
+    if (n > 0) session->in_count += (size_t) n;
+
+    if (!session_pump(worker, session)) session_close(worker, session);
+}
+
+static void session_writable(Worker *worker, Session *session) {
+    // Lines that waited for room in the output buffer go out from here too
+    if (!session_pump(worker, session)) session_close(worker, session);
+}
+
+static void worker_accept(Worker *worker, Conn *listener) {
+    for (;;) {
+        int fd = accept4(listener->fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            // EAGAIN when another worker took it, EMFILE and friends are
+            // counted and retried on the next wakeup
+            if (errno != EAGAIN && errno != EWOULDBLOCK) worker->accept_errors += 1;
+            return;
+        }
+
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        Session *session = session_alloc(worker);
+        session->conn = (Conn) { CONN_SESSION, fd };
+        session_new_game(worker, session);
+
+        struct epoll_event event = { .events = EPOLLIN | EPOLLRDHUP, .data.ptr = session };
+        worker->sessions_live += 1;
+        if (epoll_ctl(worker->epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0) {
+            worker->accept_errors += 1;
+            session_close(worker, session);
+            continue;
+        }
+        worker->sessions_total += 1;
+        if (worker->sessions_live > worker->sessions_peak) worker->sessions_peak = worker->sessions_live;
+
+        session_reply(session, "vocab %d %d\n", VOCAB_ATTEMPTS_COUNT, VOCAB_WORD_LENGTH);
+        if (!session_flush(worker, session)) session_close(worker, session);
+    }
+}
+
+static void *worker_run(void *arg) {
+    Worker *worker = arg;
+    struct epoll_event events[SERVER_EVENTS_CAP];
+
+    for (;;) {
+        int n = epoll_wait(worker->epoll_fd, events, SERVER_EVENTS_CAP, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            fprintf(stderr, "Error: worker %zu: epoll_wait: %s\n", worker->index, strerror(errno));
+            return NULL;
+        }
+
+        for (int i = 0; i < n; ++i) {
+            Conn *conn = events[i].data.ptr;
+            switch (conn->kind) {
+            case CONN_STOP:
+                return NULL;
+            case CONN_LISTENER:
+                worker_accept(worker, conn);
+                break;
+            case CONN_SESSION: {
+                Session *session = (Session *) conn;
+                if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                    session_close(worker, session);
+                } else if (session->writing) {
+                    session_writable(worker, session);
+                } else {
+                    // EPOLLRDHUP still has data to read before the recv() that returns 0
+                    session_readable(worker, session);
+                }
+            } break;
+            }
+        }
+    }
+}
+
+static void on_stop_signal(int sig) {
+    (void) sig;
+    uint64_t one = 1;
+    // Nothing to do about a failed write in a signal handler
+    ssize_t n = write(stop_conn.fd, &one, sizeof(one));
+    (void) n;
+}
+
+static bool listen_tcp(int port) {
+    int fd = socket(AF_INET6, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        fprintf(stderr, "Error: could not create TCP socket: %s\n", strerror(errno));
+        return false;
+    }
+    int one = 1;
+    int zero = 0;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    // IPv4 clients too
+    setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &zero, sizeof(zero));
+
+    struct sockaddr_in6 addr = {0};
+    addr.sin6_family = AF_INET6;
+    addr.sin6_addr = in6addr_any;
+    addr.sin6_port = htons((uint16_t) port);
+    if (bind(fd, (struct sockaddr *) &addr, sizeof(addr)) < 0 || listen(fd, SOMAXCONN) < 0) {
+        fprintf(stderr, "Error: could not listen on port %d: %s\n", port, strerror(errno));
+        close(fd);
+        return false;
+    }
+    listeners[listeners_count++] = (Conn) { CONN_LISTENER, fd };
+    return true;
+}
+
+static bool listen_unix(Cstr path) {
+    struct sockaddr_un addr = {0};
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Error: socket path '%s' is too long\n", path);
+        return false;
+    }
+    strcpy(addr.sun_path, path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        fprintf(stderr, "Error: could not create Unix socket: %s\n", strerror(errno));
+        return false;
+    }
+    unlink(path);
+    if (bind(fd, (struct sockaddr *) &addr, sizeof(addr)) < 0 || listen(fd, SOMAXCONN) < 0) {
+        fprintf(stderr, "Error: could not listen on '%s': %s\n", path, strerror(errno));
+        close(fd);
+        return false;
+    }
+    listeners[listeners_count++] = (Conn) { CONN_LISTENER, fd };
+    return true;
+}
+
+static bool worker_start(Worker *worker, size_t index, uint64_t seed) {
+    worker->index = index;
+    // Never zero, xorshift would get stuck
+    worker->rng = (seed + index) * 0x9E3779B97F4A7C15ULL | 1;
+    worker->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (worker->epoll_fd < 0) {
+        fprintf(stderr, "Error: could not create epoll instance: %s\n", strerror(errno));
+        return false;
+    }
+
+    // Only one worker wakes up per incoming connection
+    for (size_t i = 0; i < listeners_count; ++i) {
+        struct epoll_event event = { .events = EPOLLIN | EPOLLEXCLUSIVE, .data.ptr = &listeners[i] };
+        if (epoll_ctl(worker->epoll_fd, EPOLL_CTL_ADD, listeners[i].fd, &event) < 0) {
+            fprintf(stderr, "Error: could not watch listener: %s\n", strerror(errno));
+            return false;
+        }
+    }
+    struct epoll_event event = { .events = EPOLLIN, .data.ptr = &stop_conn };
+    if (epoll_ctl(worker->epoll_fd, EPOLL_CTL_ADD, stop_conn.fd, &event) < 0) {
+        fprintf(stderr, "Error: could not watch stop event: %s\n", strerror(errno));
+        return false;
+    }
+
+    if (pthread_create(&worker->thread, NULL, worker_run, worker) != 0) {
+        fprintf(stderr, "Error: could not start worker thread\n");
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, const char **argv) {
+    int port = SERVER_DEFAULT_PORT;
+    Cstr unix_path = NULL;
+    long workers_wanted = sysconf(_SC_NPROCESSORS_ONLN);
+    uint64_t seed = (uint64_t) time(NULL);
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+            long number = 0;
+            if (!parse_flag_number("--port", argv[++i], 0, 65535, &number)) return 1;
+            port = (int) number;
+        } else if (strcmp(argv[i], "--unix") == 0 && i + 1 < argc) {
+            unix_path = argv[++i];
+        } else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            if (!parse_flag_number("--workers", argv[++i], 1, SERVER_WORKERS_CAP, &workers_wanted)) return 1;
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            if (!parse_flag_seed("--seed", argv[++i], &seed)) return 1;
+        } else {
+            fprintf(stderr, "Error: unknown flag '%s'\n", argv[i]);
+            fprintf(stderr, "Usage: %s [--port n, 0 for none] [--unix path] [--workers n] [--seed n]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (workers_wanted < 1) workers_wanted = 1;
+    if (workers_wanted > SERVER_WORKERS_CAP) workers_wanted = SERVER_WORKERS_CAP;
+
+    // Every session is a file descriptor, take all the kernel lets us have
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    for (size_t i = 0; i < words_count; ++i) {
+        vocab_dict_insert(&words_dict, words[i]);
+    }
+
+    if (port > 0 && !listen_tcp(port)) return 1;
+    if (unix_path != NULL && !listen_unix(unix_path)) return 1;
+    if (listeners_count == 0) {
+        fprintf(stderr, "Error: nothing to listen on\n");
+        return 1;
+    }
+
+    stop_conn.fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (stop_conn.fd < 0) {
+        fprintf(stderr, "Error: could not create stop event: %s\n", strerror(errno));
+        return 1;
+    }
+    signal(SIGINT, on_stop_signal);
+    signal(SIGTERM, on_stop_signal);
+    signal(SIGPIPE, SIG_IGN);
+
+    for (size_t i = 0; i < (size_t) workers_wanted; ++i) {
+        if (!worker_start(&workers[i], i, seed)) {
+            on_stop_signal(0);
+            break;
+        }
+        workers_count += 1;
+    }
+    fprintf(stderr, "[SERVER]: %zu workers", workers_count);
+    if (port > 0) fprintf(stderr, ", port %d", port);
+    if (unix_path != NULL) fprintf(stderr, ", socket '%s'", unix_path);
+    fprintf(stderr, "\n");
+
+    Latency_Samples *request_times = comp_realloc(NULL, sizeof(Latency_Samples));
+    memset(request_times, 0, sizeof(*request_times));
+    size_t sessions_total = 0;
+    size_t guesses = 0;
+    for (size_t i = 0; i < workers_count; ++i) {
+        Worker *worker = &workers[i];
+        pthread_join(worker->thread, NULL);
+        fprintf(stderr, "[SERVER]: worker %zu: %zu sessions, %zu at most at once, %zu guesses, %zu accept errors\n",
+            i, worker->sessions_total, worker->sessions_peak, worker->guesses, worker->accept_errors);
+        sessions_total += worker->sessions_total;
+        guesses += worker->guesses;
+
+        size_t kept = worker->request_times.count < LATENCY_SAMPLES_CAP ? worker->request_times.count : LATENCY_SAMPLES_CAP;
+        for (size_t j = 0; j < kept; ++j) {
+            latency_samples_push(request_times, worker->request_times.items[j]);
+        }
+
+        close(worker->epoll_fd);
+        for (size_t j = 0; j < worker->chunks.count; ++j) {
+            comp_free(worker->chunks.items[j]);
+        }
+        da_free(&worker->chunks);
+    }
+    fprintf(stderr, "[SERVER]: %zu sessions, %zu guesses\n", sessions_total, guesses);
+    if (request_times->count > 0) {
+        fprintf(stderr, "[SERVER]: request time us: p50 %.3f, p90 %.3f, p99 %.3f, p99.9 %.3f, max %.3f\n",
+            latency_samples_percentile(request_times, 0.50) * 1e6,
+            latency_samples_percentile(request_times, 0.90) * 1e6,
+            latency_samples_percentile(request_times, 0.99) * 1e6,
+            latency_samples_percentile(request_times, 0.999) * 1e6,
+            latency_samples_percentile(request_times, 1.0) * 1e6);
+    }
+    comp_free(request_times);
+
+    for (size_t i = 0; i < listeners_count; ++i) {
+        close(listeners[i].fd);
+    }
+    if (unix_path != NULL) unlink(unix_path);
+    close(stop_conn.fd);
+    vocab_dict_free(&words_dict);
+    return 0;
+}
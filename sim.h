@@ -0,0 +1,253 @@
+#ifndef SIM_H_
+#define SIM_H_
+
+// Game rules on their own thread. The render thread hands input over through
+// a lock-free event ring and draws the newest snapshot of the game the
+// simulation thread published through a lock-free triple buffer, so neither
+// side ever waits for the other. No raylib in here, events are raylib
+// InputEventType kinds and values like in replay.h.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "./vocab.h"
+
+// Events in flight from the render thread, more than this are dropped
+#define SIM_EVENTS_CAP 256
+// Input times carried by one snapshot, the rest are only counted
+#define SIM_SNAPSHOT_INPUTS_CAP 32
+
+typedef struct {
+    uint64_t frame; // Render frame the event was taken on
+    int kind;
+    int value;
+    double time;    // When the input was made, seconds
+} Sim_Event;
+
+typedef struct {
+    Vocab5 vocab;
+    // When the inputs the game acted on and the render thread may not have
+    // seen yet were made, for measuring input to display latency. Input
+    // `inputs_first + i` was made at `input_times[i]`
+    uint64_t inputs_first;
+    double input_times[SIM_SNAPSHOT_INPUTS_CAP];
+    size_t input_count;
+    // Inputs that did not fit, over the whole game
+    uint64_t inputs_dropped;
+    // Simulation steps up to this snapshot
+    uint64_t step;
+} Sim_Snapshot;
+
+typedef struct {
+    // Render thread to simulation thread, single producer single consumer
+    Sim_Event events[SIM_EVENTS_CAP];
+    atomic_size_t events_head; // Only moved by the render thread
+    atomic_size_t events_tail; // Only moved by the simulation thread
+    size_t events_dropped;     // Render thread only
+
+    // Simulation thread to render thread. Every slot belongs to one side at a
+    // time, `shared` is the one in the middle with SIM_SNAPSHOT_FRESH set when
+    // the simulation put a snapshot there the render thread did not take yet
+    Sim_Snapshot snapshots[3];
+    atomic_uint shared;
+    unsigned int back;  // Simulation thread only
+    unsigned int front; // Render thread only
+
+    // Simulation thread only, inputs not known to be seen by the render thread
+    uint64_t unseen_first;
+    double unseen_times[SIM_SNAPSHOT_INPUTS_CAP];
+    size_t unseen_count;
+    uint64_t unseen_dropped;
+    // Inputs in the snapshot published before the current one
+    uint64_t published_inputs_end;
+    uint64_t steps;
+
+    // Render thread only, inputs of snapshots already taken
+    uint64_t inputs_seen;
+
+    // Only for waking the simulation thread up, never taken by the snapshot path.
+    // `sleeping` is set by sim_wait() before it looks at the ring one last time,
+    // so the render thread only takes the mutex when there may be a sleeper
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    atomic_bool sleeping;
+    bool stopping;
+} Sim;
+
+#define SIM_SNAPSHOT_INDEX 0x3u
+#define SIM_SNAPSHOT_FRESH 0x4u
+
+// Every snapshot starts out as `vocab`
+void sim_init(Sim *sim, const Vocab5 *vocab);
+void sim_free(Sim *sim);
+
+// Render thread. Queues `event` and wakes the simulation thread up if it is
+// asleep, returns false if the ring is full and the event was dropped
+bool sim_push_event(Sim *sim, Sim_Event event);
+// Render thread. The newest snapshot, stays valid until the next call.
+// `fresh` tells whether it is a new one since the last call
+const Sim_Snapshot *sim_latest(Sim *sim, bool *fresh);
+// Render thread. Inputs of `snapshot` that no snapshot taken before had,
+// call once per fresh snapshot
+size_t sim_new_inputs(Sim *sim, const Sim_Snapshot *snapshot, const double **times);
+// Render thread. Makes sim_wait() return false once the events are drained
+void sim_stop(Sim *sim);
+
+// Simulation thread. Blocks until there are events, false once stopped
+bool sim_wait(Sim *sim);
+bool sim_pop_event(Sim *sim, Sim_Event *event);
+// Simulation thread. The game acted on an input made at `time`
+void sim_input(Sim *sim, double time);
+// Simulation thread. Publishes `vocab` as the newest snapshot
+void sim_publish(Sim *sim, const Vocab5 *vocab);
+
+#endif // SIM_H_
+
+#ifdef SIM_IMPLEMENTATION
+#undef SIM_IMPLEMENTATION
+
+void sim_init(Sim *sim, const Vocab5 *vocab) {
+    memset(sim, 0, sizeof(*sim));
+    for (size_t i = 0; i < 3; ++i) {
+        sim->snapshots[i].vocab = *vocab;
+    }
+    sim->front = 0;
+    atomic_init(&sim->shared, 1);
+    sim->back = 2;
+    atomic_init(&sim->events_head, 0);
+    atomic_init(&sim->events_tail, 0);
+    atomic_init(&sim->sleeping, false);
+    pthread_mutex_init(&sim->mutex, NULL);
+    pthread_cond_init(&sim->cond, NULL);
+}
+
+void sim_free(Sim *sim) {
+    pthread_cond_destroy(&sim->cond);
+    pthread_mutex_destroy(&sim->mutex);
+}
+
+static void sim_wake(Sim *sim) {
+    // Under the mutex so the wakeup can't land between sim_wait() checking
+    // the ring and going to sleep
+    pthread_mutex_lock(&sim->mutex);
+    pthread_cond_signal(&sim->cond);
+    pthread_mutex_unlock(&sim->mutex);
+}
+
+bool sim_push_event(Sim *sim, Sim_Event event) {
+    size_t head = atomic_load_explicit(&sim->events_head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&sim->events_tail, memory_order_acquire);
+    if (head - tail >= SIM_EVENTS_CAP) {
+        sim->events_dropped += 1;
+        return false;
+    }
+    sim->events[head % SIM_EVENTS_CAP] = event;
+    // Sequentially consistent with the `sleeping` store and the head load in
+    // sim_wait(): either it sees this event or this sees it going to sleep
+    atomic_store_explicit(&sim->events_head, head + 1, memory_order_seq_cst);
+    if (atomic_load_explicit(&sim->sleeping, memory_order_seq_cst)) sim_wake(sim);
+    return true;
+}
+
+const Sim_Snapshot *sim_latest(Sim *sim, bool *fresh) {
+    *fresh = false;
+    if (atomic_load_explicit(&sim->shared, memory_order_relaxed) & SIM_SNAPSHOT_FRESH) {
+        unsigned int taken = atomic_exchange_explicit(&sim->shared, sim->front, memory_order_acq_rel);
+        sim->front = taken & SIM_SNAPSHOT_INDEX;
+        *fresh = true;
+    }
+    return &sim->snapshots[sim->front];
+}
+
+size_t sim_new_inputs(Sim *sim, const Sim_Snapshot *snapshot, const double **times) {
+    uint64_t end = snapshot->inputs_first + snapshot->input_count;
+    size_t skip = 0;
+    if (sim->inputs_seen > snapshot->inputs_first) {
+        skip = (size_t) (sim->inputs_seen - snapshot->inputs_first);
+    }
+    if (skip > snapshot->input_count) skip = snapshot->input_count;
+    if (end > sim->inputs_seen) sim->inputs_seen = end;
+    *times = snapshot->input_times + skip;
+    return snapshot->input_count - skip;
+}
+
+void sim_stop(Sim *sim) {
+    pthread_mutex_lock(&sim->mutex);
+    sim->stopping = true;
+    pthread_cond_signal(&sim->cond);
+    pthread_mutex_unlock(&sim->mutex);
+}
+
+bool sim_wait(Sim *sim) {
+    // Events that are already there don't need the mutex
+    size_t tail = atomic_load_explicit(&sim->events_tail, memory_order_relaxed);
+    if (atomic_load_explicit(&sim->events_head, memory_order_acquire) != tail) return true;
+
+    bool running = true;
+    pthread_mutex_lock(&sim->mutex);
+    atomic_store_explicit(&sim->sleeping, true, memory_order_seq_cst);
+    for (;;) {
+        if (atomic_load_explicit(&sim->events_head, memory_order_seq_cst) != tail) break;
+        if (sim->stopping) {
+            running = false;
+            break;
+        }
+        pthread_cond_wait(&sim->cond, &sim->mutex);
+    }
+    atomic_store_explicit(&sim->sleeping, false, memory_order_relaxed);
+    pthread_mutex_unlock(&sim->mutex);
+    return running;
+}
+
+bool sim_pop_event(Sim *sim, Sim_Event *event) {
+    size_t tail = atomic_load_explicit(&sim->events_tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&sim->events_head, memory_order_acquire);
+    if (tail == head) return false;
+    *event = sim->events[tail % SIM_EVENTS_CAP];
+    atomic_store_explicit(&sim->events_tail, tail + 1, memory_order_release);
+    return true;
+}
+
+void sim_input(Sim *sim, double time) {
+    if (sim->unseen_count == SIM_SNAPSHOT_INPUTS_CAP) {
+        // The render thread is far behind, the oldest input goes unmeasured
+        memmove(sim->unseen_times, sim->unseen_times + 1, (SIM_SNAPSHOT_INPUTS_CAP - 1) * sizeof(sim->unseen_times[0]));
+        sim->unseen_first += 1;
+        sim->unseen_count -= 1;
+        sim->unseen_dropped += 1;
+    }
+    sim->unseen_times[sim->unseen_count++] = time;
+}
+
+void sim_publish(Sim *sim, const Vocab5 *vocab) {
+    Sim_Snapshot *back = &sim->snapshots[sim->back];
+    back->vocab = *vocab;
+    back->inputs_first = sim->unseen_first;
+    memcpy(back->input_times, sim->unseen_times, sim->unseen_count * sizeof(sim->unseen_times[0]));
+    back->input_count = sim->unseen_count;
+    back->inputs_dropped = sim->unseen_dropped;
+    sim->steps += 1;
+    back->step = sim->steps;
+
+    unsigned int swapped = atomic_exchange_explicit(&sim->shared, sim->back | SIM_SNAPSHOT_FRESH, memory_order_acq_rel);
+    sim->back = swapped & SIM_SNAPSHOT_INDEX;
+
+    if (!(swapped & SIM_SNAPSHOT_FRESH)) {
+        // The render thread took the snapshot published before this one, so
+        // it saw every input up to there
+        size_t seen = 0;
+        if (sim->published_inputs_end > sim->unseen_first) {
+            seen = (size_t) (sim->published_inputs_end - sim->unseen_first);
+        }
+        if (seen > sim->unseen_count) seen = sim->unseen_count;
+        memmove(sim->unseen_times, sim->unseen_times + seen, (sim->unseen_count - seen) * sizeof(sim->unseen_times[0]));
+        sim->unseen_first += seen;
+        sim->unseen_count -= seen;
+    }
+    sim->published_inputs_end = back->inputs_first + back->input_count;
+}
+
+#endif // SIM_IMPLEMENTATION
@@ -2,14 +2,46 @@
 #define SOMEUI_H_
 
 #include <stdlib.h>
+#include <string.h>
+
+// Define these before including somui.h to use your own allocator
+#ifndef SOMUI_REALLOC
+#define SOMUI_REALLOC(ptr, size) realloc((ptr), (size))
+#endif
+#ifndef SOMUI_FREE
+#define SOMUI_FREE(ptr) free(ptr)
+#endif
+
+// Define these to get a span around every layout, e.g. with comp.h's tracing
+#ifndef SOMUI_TRACE_BEGIN
+#define SOMUI_TRACE_BEGIN(name)
+#endif
+#ifndef SOMUI_TRACE_END
+#define SOMUI_TRACE_END(name)
+#endif
+
+// The layout stack lives inside UI_Stack until it gets deeper than this,
+// so regular nesting never touches the heap
+#ifndef SOMUI_STACK_INLINE_CAP
+#define SOMUI_STACK_INLINE_CAP 4
+#endif
 
-#define DA_INIT_CAP 16
 #define somui_da_append(da, item)                                       \
     do {                                                                \
+        if ((da)->items == NULL) {                                      \
+            (da)->items = (da)->inline_items;                           \
+            (da)->capacity = SOMUI_STACK_INLINE_CAP;                    \
+        }                                                               \
         if ((da)->count >= (da)->capacity) {                            \
-            (da)->capacity = (da)->capacity == 0 ? DA_INIT_CAP : (da)->capacity * 2; \
-            (da)->items = realloc((da)->items, (da)->capacity * sizeof(*(da)->items)); \
-            assert((da)->items != NULL && "Error: not enough RAM");     \
+            (da)->capacity *= 2;                                        \
+            if ((da)->items == (da)->inline_items) {                    \
+                (da)->items = SOMUI_REALLOC(NULL, (da)->capacity * sizeof(*(da)->items)); \
+                assert((da)->items != NULL && "Error: not enough RAM"); \
+                memcpy((da)->items, (da)->inline_items, (da)->count * sizeof(*(da)->items)); \
+            } else {                                                    \
+                (da)->items = SOMUI_REALLOC((da)->items, (da)->capacity * sizeof(*(da)->items)); \
+                assert((da)->items != NULL && "Error: not enough RAM"); \
+            }                                                           \
         }                                                               \
         (da)->items[(da)->count++] = (item);                            \
     } while (0)
@@ -42,10 +74,12 @@ typedef struct {
     size_t count;
 } UI_Layout;
 
+// NOTE: items may point at inline_items, don't copy a stack that is in use
 typedef struct {
     UI_Layout *items;
     size_t capacity;
     size_t count;
+    UI_Layout inline_items[SOMUI_STACK_INLINE_CAP];
 } UI_Stack;
 
 UI_Stack ui_stack_new(void);
@@ -79,10 +113,16 @@ UI_Stack ui_stack_new(void) {
 }
 
 void ui_stack_free(UI_Stack *stack) {
-    free(stack->items);
+    if (stack->items != stack->inline_items) {
+        SOMUI_FREE(stack->items);
+    }
+    stack->items = NULL;
+    stack->capacity = 0;
+    stack->count = 0;
 }
 
 void ui_layout_begin(UI_Stack *stack, UI_Rect rect, UI_Orientation ori, UI_Margin margin, int gap, size_t cap) {
+    SOMUI_TRACE_BEGIN("ui_layout");
     UI_Layout layout = { 0 };
     layout.rect = rect;
     layout.ori = ori;
@@ -95,6 +135,7 @@ void ui_layout_begin(UI_Stack *stack, UI_Rect rect, UI_Orientation ori, UI_Margi
 void ui_layout_end(UI_Stack *stack) {
     assert(stack->count > 0);
     stack->count -= 1;
+    SOMUI_TRACE_END("ui_layout");
 }
 
 UI_Rect ui_layout_rect(UI_Stack *stack) {
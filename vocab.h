@@ -0,0 +1,1245 @@
+#ifndef VOCAB_H_
+#define VOCAB_H_
+
+// The rules of the game, no raylib in here so tools can use them too
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "./comp.h"
+
+#define VOCAB_ATTEMPTS_COUNT 6
+#define VOCAB_WORD_LENGTH 5
+
+#define HASH_SET_CSTR_CAP 512
+
+typedef struct {
+    Da_Cstr buckets[HASH_SET_CSTR_CAP];
+} Hash_Set_Cstr;
+
+size_t hash_cstr(Cstr cstr);
+void hash_set_cstr_insert(Hash_Set_Cstr *set, Cstr cstr);
+bool hash_set_cstr_contains(Hash_Set_Cstr *set, Cstr cstr);
+
+// Dictionary for checking a lot of guesses at once. Words are stored as keys,
+// 5 bits per letter, in buckets of VOCAB_DICT_BUCKET_SLOTS keys that are
+// compared in one go. The batch functions work through the guesses in groups,
+// hashing and prefetching the whole group before looking any of it up, so
+// the cache misses of a group overlap.
+#define VOCAB_DICT_BUCKET_SLOTS 8
+#define VOCAB_DICT_BATCH 16
+
+#if VOCAB_WORD_LENGTH*5 > 32
+    #error "Vocab_Dict keys only fit words of up to 6 letters"
+#endif
+
+typedef struct {
+    uint32_t *slots; // buckets_count*VOCAB_DICT_BUCKET_SLOTS keys, 0 is an empty slot
+    size_t buckets_count;
+    int bucket_bits;
+    size_t count;
+    void *memory;    // What `slots` was aligned from
+} Vocab_Dict;
+
+// 0 if `word` has something other than VOCAB_WORD_LENGTH lowercase ASCII letters
+uint32_t vocab_word_key(const char *word);
+void vocab_dict_insert(Vocab_Dict *dict, const char *word);
+bool vocab_dict_contains(const Vocab_Dict *dict, const char *word);
+// Bit `i % 64` of `valid[i / 64]` tells whether guess `i` is a word, every
+// guess is VOCAB_WORD_LENGTH characters without a terminator. `valid` has
+// room for (count + 63)/64 words
+void vocab_dict_contains_batch(const Vocab_Dict *dict, const char (*guesses)[VOCAB_WORD_LENGTH], size_t count, uint64_t *valid);
+// Same for guesses already turned into keys by vocab_word_key()
+void vocab_dict_contains_keys(const Vocab_Dict *dict, const uint32_t *keys, size_t count, uint64_t *valid);
+void vocab_dict_free(Vocab_Dict *dict);
+
+// Word list laid out a column per letter, for going through all of it a
+// vector of words at a time. Letter j of word i is letters[j*stride + i], the
+// rows past `count` are zeros and never match a letter
+#define VOCAB_COLUMNS_BLOCK 64
+// Most words vocab_columns_nearest() looks for at once
+#define VOCAB_NEAREST_CAP 16
+
+typedef struct {
+    unsigned char *letters;
+    uint32_t *masks; // Bit c of masks[i] is set if word i has 'a' + c anywhere
+    size_t count;
+    size_t stride;   // `count` rounded up to VOCAB_COLUMNS_BLOCK
+    void *memory;    // What `letters` and `masks` were aligned from
+} Vocab_Columns;
+
+// What a word has to look like for vocab_columns_match(), every part of it
+// has to hold. Letter sets have bit c for 'a' + c
+typedef struct {
+    char letters[VOCAB_WORD_LENGTH];    // Letter at each position, 0 for any
+    uint32_t not_at[VOCAB_WORD_LENGTH]; // Letters that can't be at each position
+    uint32_t has;                       // Letters somewhere in the word
+    uint32_t lacks;                     // Letters nowhere in the word
+} Vocab_Pattern;
+
+// Every word must be VOCAB_WORD_LENGTH lowercase letters
+void vocab_columns_init(Vocab_Columns *columns, const Cstr *words, size_t count);
+void vocab_columns_free(Vocab_Columns *columns);
+// The up to `k` words with the fewest letters different from `word`, and no
+// more than `max_distance`, closest first and ties in list order. Their
+// indices go to `nearest`, returns how many were found
+size_t vocab_columns_nearest(const Vocab_Columns *columns, const char *word, size_t max_distance, size_t *nearest, size_t k);
+// Indices of the words matching `pattern` in list order, the first `cap` of
+// them go to `matches`. Returns how many there are in total
+size_t vocab_columns_match(const Vocab_Columns *columns, const Vocab_Pattern *pattern, size_t *matches, size_t cap);
+
+// Every prefix of the dictionary as a trie over the words sorted
+// alphabetically, so the words starting with a prefix are one range of
+// `order`. Children of a node are next to each other and found by counting the
+// letters below in `children`, a lookup is a step per letter of the prefix
+typedef struct {
+    uint32_t children;    // Bit c is set if a word goes on with 'a' + c
+    uint32_t first_child; // Node of the lowest letter that goes on
+    uint32_t begin;       // The words with this prefix are order[begin..end)
+    uint32_t end;
+} Vocab_Prefix_Node;
+
+typedef struct {
+    Vocab_Prefix_Node *nodes; // nodes[0] is the empty prefix
+    size_t nodes_count;
+    uint32_t *order;          // Indices of the words, alphabetically
+    size_t count;
+} Vocab_Prefix;
+
+typedef struct {
+    size_t begin;
+    size_t end;
+} Vocab_Prefix_Range;
+
+// Every word must be VOCAB_WORD_LENGTH lowercase letters, duplicates are kept
+void vocab_prefix_init(Vocab_Prefix *prefix, const Cstr *words, size_t count);
+void vocab_prefix_free(Vocab_Prefix *prefix);
+// Words starting with the first `length` letters of `letters`, as a range of
+// `prefix->order`. Empty when no word does, the prefix is a dead end
+Vocab_Prefix_Range vocab_prefix_find(const Vocab_Prefix *prefix, const char *letters, size_t length);
+
+// How many of each letter a word has, four bits per letter so the 26 counts
+// fit in a pair of 64 bit integers. Counts stop at 7, the top bit of every
+// field is kept clear so a subtraction can't borrow across letters
+typedef struct {
+    uint64_t low;  // 'a' to 'p'
+    uint64_t high; // 'q' to 'z'
+} Vocab_Letters;
+
+typedef struct {
+    uint32_t key;   // vocab_word_key() of the letters sorted, 0 if the slot is empty
+    uint32_t begin; // Words with these letters are order[begin..end)
+    uint32_t end;
+} Vocab_Anagram_Slot;
+
+// The dictionary by the letters in a word. Exact anagrams share a key and sit
+// next to each other in `order`, found with one probe of `slots`. Words that
+// can be spelled from some letters are a scan, which letters a word has
+// rules out most of them and the counts are a subtraction and a compare for
+// the rest. The counts are split in two arrays, so a vector covers the same
+// half of several words
+typedef struct {
+    uint32_t *masks;          // Bit c is set if the word has 'a' + c
+    uint64_t *low;            // Vocab_Letters of every word in list order, and
+    uint64_t *high;           // past `count` up to a multiple of 64 none fit
+    size_t count;
+    uint32_t *order;          // Indices of the words grouped by their letters
+    Vocab_Anagram_Slot *slots;
+    int slot_bits;            // 2^slot_bits slots, at least twice the groups
+} Vocab_Anagrams;
+
+// Counts of the letters in the first `length` characters of `text`, anything
+// but a letter is left out
+Vocab_Letters vocab_letters(const char *text, size_t length);
+// Every word must be VOCAB_WORD_LENGTH lowercase letters
+void vocab_anagrams_init(Vocab_Anagrams *anagrams, const Cstr *words, size_t count);
+void vocab_anagrams_free(Vocab_Anagrams *anagrams);
+// Words with the same letters as `word`, in any order and including `word`
+// itself when it is in the list, as a range of `anagrams->order`
+Vocab_Prefix_Range vocab_anagrams_find(const Vocab_Anagrams *anagrams, const char *word);
+// Indices of the words that can be spelled from `available`, none of their
+// letters more times than it is there. The first `cap` go to `matches` in
+// list order, returns how many there are in total
+size_t vocab_anagrams_within(const Vocab_Anagrams *anagrams, Vocab_Letters available, size_t *matches, size_t cap);
+
+typedef enum {
+    VOCAB_BLACK = 0,
+    VOCAB_GRAY,
+    VOCAB_YELLOW,
+    VOCAB_GREEN,
+} Vocab_Color;
+
+// Loops over the letters of a word are short and their length is known, but
+// the compiler won't unroll them all at -O2 unless asked to
+#if defined(__GNUC__)
+    #define VOCAB_UNROLL _Pragma("GCC unroll 16")
+#else
+    #define VOCAB_UNROLL
+#endif
+
+// Words of one length as keys, open addressing
+typedef struct {
+    uint64_t *slots; // 0 is an empty slot
+    int slot_bits;   // 2^slot_bits slots, at least twice the words
+    size_t count;
+    size_t length;
+} Vocab_Word_Set;
+
+// Like vocab_word_key() for `length` letters, 0 if `word` has something
+// other than `length` lowercase ASCII letters
+uint64_t vocab_word_key64(const char *word, size_t length);
+// Words that aren't `length` letters are left out
+void vocab_word_set_init(Vocab_Word_Set *set, size_t length, const Cstr *words, size_t count);
+bool vocab_word_set_contains(const Vocab_Word_Set *set, uint64_t key);
+void vocab_word_set_free(Vocab_Word_Set *set);
+
+// The game itself comes out of vocab_length_template.h like the other lengths
+// in vocab_lengths.h do: Vocab5, vocab5_score(), vocab5_submit(), ...
+#define VOCAB_LENGTH VOCAB_WORD_LENGTH
+#include "./vocab_length_template.h"
+#undef VOCAB_LENGTH
+
+// Whether `word` could still be the answer after `guess` was colored `colors`
+bool vocab_candidate_matches(const char *word, const char *guess, const Vocab_Color colors[VOCAB_WORD_LENGTH]);
+
+// "a?e?s" style, a letter or '?' for each position and nothing else. Returns
+// false if `text` is not that
+bool vocab_pattern_parse(Vocab_Pattern *pattern, const char *text);
+// Narrows `pattern` down to the words that would color `guess` like `colors`.
+// How many times a letter repeats isn't kept, so a few words that
+// vocab_candidate_matches() turns down can still get through
+void vocab_pattern_learn(Vocab_Pattern *pattern, const char *guess, const Vocab_Color colors[VOCAB_WORD_LENGTH]);
+
+// The same game in 32 bytes, for keeping a lot of them around. The answer is
+// an index into a word list the caller keeps, letters are 5 bits (0 is an
+// empty square, 1 is 'a') and colors 2 bits:
+//     rows[r / 2]     bits 25*(r % 2) + 5*j    letter j of row r
+//     rows[0]         bits 50..63              answer index
+//     rows[1]         bits 50..52, 53..55      current attempt, cursor
+//     colors          bits 2*(5*r + j)         color j of row r
+typedef struct {
+    uint64_t rows[3];
+    uint64_t colors;
+} Vocab_Packed;
+
+#define VOCAB_PACKED_ANSWERS_CAP (1 << 14)
+
+// `answer` is the index of `vocab->word` in the caller's word list
+Vocab_Packed vocab_pack(const Vocab5 *vocab, size_t answer);
+Vocab5 vocab_unpack(const Vocab_Packed *packed, const Cstr *answers);
+Vocab_Packed vocab_packed_new(size_t answer);
+
+size_t vocab_packed_answer(const Vocab_Packed *packed);
+size_t vocab_packed_attempt(const Vocab_Packed *packed);
+size_t vocab_packed_cursor(const Vocab_Packed *packed);
+// '\0' for an empty square
+char vocab_packed_letter(const Vocab_Packed *packed, size_t row, size_t col);
+Vocab_Color vocab_packed_color(const Vocab_Packed *packed, size_t row, size_t col);
+
+// Same as the Vocab5 functions, updating the packed game in place
+bool vocab_packed_is_over(const Vocab_Packed *packed);
+void vocab_packed_type_letter(Vocab_Packed *packed, char letter);
+void vocab_packed_erase_letter(Vocab_Packed *packed);
+bool vocab_packed_submit(Vocab_Packed *packed, const Cstr *answers, const Vocab_Dict *dict);
+
+// Several games played with the same guesses, like Quordle. Every board has
+// its own answer, the game gets one more attempt per extra board and a board
+// stops taking guesses once it is solved
+#define VOCAB_BOARDS_CAP 64
+#define VOCAB_BOARDS_ATTEMPTS_CAP (VOCAB_BOARDS_CAP + VOCAB_ATTEMPTS_COUNT - 1)
+
+typedef struct {
+    size_t count;
+    size_t attempts_count;
+    Cstr words[VOCAB_BOARDS_CAP];
+    // answers[j][b] is letter j of the answer of board b, for vocab_score_many()
+    char answers[VOCAB_WORD_LENGTH][VOCAB_BOARDS_CAP];
+    // The guesses, the same on every board
+    char grid[VOCAB_BOARDS_ATTEMPTS_CAP][VOCAB_WORD_LENGTH];
+    Vocab_Color color_grid[VOCAB_BOARDS_CAP][VOCAB_BOARDS_ATTEMPTS_CAP][VOCAB_WORD_LENGTH];
+    // Attempts board b took, 0 while it is not solved
+    size_t solved_in[VOCAB_BOARDS_CAP];
+    size_t solved_count;
+    size_t current_attempt;
+    size_t cursor;
+    bool rejected;
+} Vocab_Boards;
+
+// Colors `guess` against `count` answers in one pass, answers are laid out like
+// Vocab_Boards.answers. colors[b] is what vocab5_score() gives for answer b
+void vocab_score_many(const char (*answers)[VOCAB_BOARDS_CAP], size_t count, const char *guess, Vocab_Color (*colors)[VOCAB_WORD_LENGTH]);
+
+// `answers` must outlive the game
+void vocab_boards_init(Vocab_Boards *boards, const Cstr *answers, size_t count);
+bool vocab_boards_is_over(const Vocab_Boards *boards);
+void vocab_boards_type_letter(Vocab_Boards *boards, char letter);
+void vocab_boards_erase_letter(Vocab_Boards *boards);
+// Scores the current row on every board that is not solved yet, returns false
+// if the row is incomplete or not a word in `dict`, like vocab5_submit()
+bool vocab_boards_submit(Vocab_Boards *boards, const Vocab_Dict *dict);
+
+#endif // VOCAB_H_
+
+#ifdef VOCAB_IMPLEMENTATION
+#undef VOCAB_IMPLEMENTATION
+
+size_t hash_cstr(Cstr cstr) {
+    size_t hash = 0;
+    while (*cstr++ != '\0') {
+        hash = hash * 13 + (size_t)*cstr;
+    }
+    return hash;
+}
+
+void hash_set_cstr_insert(Hash_Set_Cstr *set, Cstr cstr) {
+    size_t index = hash_cstr(cstr) % HASH_SET_CSTR_CAP;
+    Da_Cstr *bucket = &set->buckets[index];
+    da_append(bucket, cstr);
+}
+
+bool hash_set_cstr_contains(Hash_Set_Cstr *set, Cstr cstr) {
+    size_t index = hash_cstr(cstr) % HASH_SET_CSTR_CAP;
+    Da_Cstr *bucket = &set->buckets[index];
+    for (size_t i = 0; i < bucket->count; ++i) {
+        if (strcmp(cstr, bucket->items[i]) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define VOCAB_DICT_SSE2
+#elif defined(__ARM_NEON)
+    #include <arm_neon.h>
+    #define VOCAB_DICT_NEON
+#endif
+
+#if defined(__GNUC__)
+    #define VOCAB_PREFETCH(ptr) __builtin_prefetch(ptr)
+#else
+    #define VOCAB_PREFETCH(ptr) ((void) (ptr))
+#endif
+
+// Buckets are 32 bytes, aligned so one never straddles two cache lines
+#define VOCAB_DICT_ALIGN 64
+#define VOCAB_DICT_MIN_BUCKET_BITS 4
+// Guesses turned into keys at a time by vocab_dict_contains_batch(), a
+// multiple of 64 so every chunk fills whole words of the bitmap
+#define VOCAB_DICT_KEYS_CHUNK 256
+
+uint32_t vocab_word_key(const char *word) {
+    // No branches, guesses in a batch are a mix of words and garbage
+    uint32_t key = 0;
+    uint32_t bad = 0;
+    for (size_t i = 0; i < VOCAB_WORD_LENGTH; ++i) {
+        // Anything below 'a' wraps around, so only 'a'..'z' stay under 26.
+        // No case folding, the word lists and typed guesses are lowercase
+        uint32_t letter = (uint32_t) ((unsigned char) word[i] - 'a');
+        bad |= letter > 'z' - 'a';
+        key = (key << 5) | (letter + 1);
+    }
+    return key & (bad - 1);
+}
+
+static inline const uint32_t *vocab_dict_bucket(const Vocab_Dict *dict, uint32_t key) {
+    size_t index = (size_t) ((key * 0x9E3779B1u) >> (32 - dict->bucket_bits));
+    return dict->slots + index*VOCAB_DICT_BUCKET_SLOTS;
+}
+
+static inline bool vocab_dict_bucket_has(const uint32_t *bucket, uint32_t key) {
+#if defined(VOCAB_DICT_SSE2)
+    __m128i k = _mm_set1_epi32((int) key);
+    __m128i lo = _mm_cmpeq_epi32(_mm_load_si128((const __m128i *) bucket), k);
+    __m128i hi = _mm_cmpeq_epi32(_mm_load_si128((const __m128i *) (bucket + 4)), k);
+    return _mm_movemask_epi8(_mm_or_si128(lo, hi)) != 0;
+#elif defined(VOCAB_DICT_NEON)
+    uint32x4_t k = vdupq_n_u32(key);
+    uint32x4_t eq = vorrq_u32(vceqq_u32(vld1q_u32(bucket), k), vceqq_u32(vld1q_u32(bucket + 4), k));
+    uint32x2_t half = vorr_u32(vget_low_u32(eq), vget_high_u32(eq));
+    return vget_lane_u32(vpmax_u32(half, half), 0) != 0;
+#else
+    for (size_t i = 0; i < VOCAB_DICT_BUCKET_SLOTS; ++i) {
+        if (bucket[i] == key) return true;
+    }
+    return false;
+#endif
+}
+
+static void vocab_dict_resize(Vocab_Dict *dict, int bucket_bits) {
+    Vocab_Dict old = *dict;
+    for (;;) {
+        size_t buckets_count = (size_t) 1 << bucket_bits;
+        size_t size = buckets_count*VOCAB_DICT_BUCKET_SLOTS*sizeof(uint32_t);
+        dict->memory = comp_realloc(NULL, size + VOCAB_DICT_ALIGN);
+        assert(dict->memory != NULL && "Buy more RAM lol");
+        dict->slots = (uint32_t *) (((uintptr_t) dict->memory + VOCAB_DICT_ALIGN - 1) & ~(uintptr_t) (VOCAB_DICT_ALIGN - 1));
+        memset(dict->slots, 0, size);
+        dict->buckets_count = buckets_count;
+        dict->bucket_bits = bucket_bits;
+        dict->count = 0;
+
+        // A key that doesn't fit in its bucket makes the table bigger again
+        bool fits = true;
+        for (size_t i = 0; fits && i < old.buckets_count*VOCAB_DICT_BUCKET_SLOTS; ++i) {
+            uint32_t key = old.slots[i];
+            if (key == 0) continue;
+            uint32_t *bucket = (uint32_t *) vocab_dict_bucket(dict, key);
+            size_t j = 0;
+            while (j < VOCAB_DICT_BUCKET_SLOTS && bucket[j] != 0) j += 1;
+            if (j == VOCAB_DICT_BUCKET_SLOTS) {
+                fits = false;
+            } else {
+                bucket[j] = key;
+                dict->count += 1;
+            }
+        }
+        if (fits) break;
+        comp_free(dict->memory);
+        bucket_bits += 1;
+    }
+    if (old.memory != NULL) comp_free(old.memory);
+}
+
+void vocab_dict_insert(Vocab_Dict *dict, const char *word) {
+    uint32_t key = vocab_word_key(word);
+    assert(key != 0 && "Error: not a word");
+    if (dict->slots == NULL) vocab_dict_resize(dict, VOCAB_DICT_MIN_BUCKET_BITS);
+    // Keeps buckets about a third full, a full bucket is rare from there
+    if ((dict->count + 1)*3 > dict->buckets_count*VOCAB_DICT_BUCKET_SLOTS) {
+        vocab_dict_resize(dict, dict->bucket_bits + 1);
+    }
+
+    for (;;) {
+        uint32_t *bucket = (uint32_t *) vocab_dict_bucket(dict, key);
+        if (vocab_dict_bucket_has(bucket, key)) return;
+        for (size_t i = 0; i < VOCAB_DICT_BUCKET_SLOTS; ++i) {
+            if (bucket[i] == 0) {
+                bucket[i] = key;
+                dict->count += 1;
+                return;
+            }
+        }
+        vocab_dict_resize(dict, dict->bucket_bits + 1);
+    }
+}
+
+bool vocab_dict_contains(const Vocab_Dict *dict, const char *word) {
+    uint32_t key = vocab_word_key(word);
+    if (key == 0 || dict->slots == NULL) return false;
+    return vocab_dict_bucket_has(vocab_dict_bucket(dict, key), key);
+}
+
+void vocab_dict_contains_keys(const Vocab_Dict *dict, const uint32_t *keys, size_t count, uint64_t *valid) {
+    memset(valid, 0, (count + 63)/64*sizeof(uint64_t));
+    if (dict->slots == NULL) return;
+
+    for (size_t base = 0; base < count; base += VOCAB_DICT_BATCH) {
+        size_t n = count - base < VOCAB_DICT_BATCH ? count - base : VOCAB_DICT_BATCH;
+        const uint32_t *buckets[VOCAB_DICT_BATCH];
+        for (size_t i = 0; i < n; ++i) {
+            buckets[i] = vocab_dict_bucket(dict, keys[base + i]);
+            VOCAB_PREFETCH(buckets[i]);
+        }
+        for (size_t i = 0; i < n; ++i) {
+            uint32_t key = keys[base + i];
+            // Empty slots are 0 too, a bad guess must not find them
+            uint64_t found = (key != 0) & vocab_dict_bucket_has(buckets[i], key);
+            valid[(base + i)/64] |= found << ((base + i)%64);
+        }
+    }
+}
+
+void vocab_dict_contains_batch(const Vocab_Dict *dict, const char (*guesses)[VOCAB_WORD_LENGTH], size_t count, uint64_t *valid) {
+    uint32_t keys[VOCAB_DICT_KEYS_CHUNK];
+    for (size_t base = 0; base < count; base += VOCAB_DICT_KEYS_CHUNK) {
+        size_t n = count - base < VOCAB_DICT_KEYS_CHUNK ? count - base : VOCAB_DICT_KEYS_CHUNK;
+        for (size_t i = 0; i < n; ++i) {
+            keys[i] = vocab_word_key(guesses[base + i]);
+        }
+        vocab_dict_contains_keys(dict, keys, n, valid + base/64);
+    }
+}
+
+void vocab_dict_free(Vocab_Dict *dict) {
+    if (dict->memory != NULL) comp_free(dict->memory);
+    memset(dict, 0, sizeof(*dict));
+}
+
+uint64_t vocab_word_key64(const char *word, size_t length) {
+    uint64_t key = 0;
+    uint64_t bad = 0;
+    for (size_t i = 0; i < length; ++i) {
+        if (word[i] == '\0') return 0;
+        uint64_t letter = (uint64_t) ((unsigned char) word[i] - 'a');
+        bad |= letter > 'z' - 'a';
+        key = (key << 5) | (letter + 1);
+    }
+    return word[length] != '\0' ? 0 : key & (bad - 1);
+}
+
+static inline size_t vocab_word_set_slot(const Vocab_Word_Set *set, uint64_t key) {
+    return (size_t) ((key * 0x9E3779B97F4A7C15ULL) >> (64 - set->slot_bits));
+}
+
+void vocab_word_set_init(Vocab_Word_Set *set, size_t length, const Cstr *words, size_t count) {
+    memset(set, 0, sizeof(*set));
+    set->length = length;
+    set->slot_bits = 4;
+    while (((size_t) 1 << set->slot_bits) < count*2) set->slot_bits += 1;
+    size_t mask = ((size_t) 1 << set->slot_bits) - 1;
+    set->slots = comp_realloc(NULL, (mask + 1)*sizeof(uint64_t));
+    assert(set->slots != NULL && "Buy more RAM lol");
+    memset(set->slots, 0, (mask + 1)*sizeof(uint64_t));
+
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t key = vocab_word_key64(words[i], length);
+        if (key == 0) continue;
+        size_t slot = vocab_word_set_slot(set, key);
+        while (set->slots[slot] != 0 && set->slots[slot] != key) slot = (slot + 1) & mask;
+        set->count += set->slots[slot] == 0;
+        set->slots[slot] = key;
+    }
+}
+
+bool vocab_word_set_contains(const Vocab_Word_Set *set, uint64_t key) {
+    if (key == 0 || set->slots == NULL) return false;
+    size_t mask = ((size_t) 1 << set->slot_bits) - 1;
+    size_t slot = vocab_word_set_slot(set, key);
+    while (set->slots[slot] != 0) {
+        if (set->slots[slot] == key) return true;
+        slot = (slot + 1) & mask;
+    }
+    return false;
+}
+
+void vocab_word_set_free(Vocab_Word_Set *set) {
+    if (set->slots != NULL) comp_free(set->slots);
+    memset(set, 0, sizeof(*set));
+}
+
+#define VOCAB_COLUMNS_ALIGN 64
+
+void vocab_columns_init(Vocab_Columns *columns, const Cstr *words, size_t count) {
+    memset(columns, 0, sizeof(*columns));
+    columns->count = count;
+    columns->stride = (count + VOCAB_COLUMNS_BLOCK - 1) / VOCAB_COLUMNS_BLOCK * VOCAB_COLUMNS_BLOCK;
+    // The masks go right after the letters, still aligned since the stride is
+    size_t size = columns->stride*VOCAB_WORD_LENGTH + columns->stride*sizeof(uint32_t);
+    columns->memory = comp_realloc(NULL, size + VOCAB_COLUMNS_ALIGN);
+    assert(columns->memory != NULL && "Buy more RAM lol");
+    columns->letters = (unsigned char *) (((uintptr_t) columns->memory + VOCAB_COLUMNS_ALIGN - 1) & ~(uintptr_t) (VOCAB_COLUMNS_ALIGN - 1));
+    columns->masks = (uint32_t *) (columns->letters + columns->stride*VOCAB_WORD_LENGTH);
+    memset(columns->letters, 0, size);
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t j = 0; j < VOCAB_WORD_LENGTH; ++j) {
+            columns->letters[j*columns->stride + i] = (unsigned char) words[i][j];
+            columns->masks[i] |= 1u << (words[i][j] - 'a');
+        }
+    }
+}
+
+void vocab_columns_free(Vocab_Columns *columns) {
+    if (columns->memory != NULL) comp_free(columns->memory);
+    memset(columns, 0, sizeof(*columns));
+}
+
+static int vocab_prefix_compare(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *) a;
+    uint64_t y = *(const uint64_t *) b;
+    return (x > y) - (x < y);
+}
+
+void vocab_prefix_init(Vocab_Prefix *prefix, const Cstr *words, size_t count) {
+    memset(prefix, 0, sizeof(*prefix));
+    prefix->count = count;
+
+    // Keys sort like the words do, the first letter is in the top bits
+    uint64_t *sorted = comp_realloc(NULL, count*sizeof(uint64_t));
+    prefix->order = comp_realloc(NULL, count*sizeof(uint32_t));
+    assert(sorted != NULL && prefix->order != NULL && "Buy more RAM lol");
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t key = vocab_word_key(words[i]);
+        assert(key != 0 && "Error: not a word");
+        sorted[i] = ((uint64_t) key << 32) | i;
+    }
+    qsort(sorted, count, sizeof(sorted[0]), vocab_prefix_compare);
+    for (size_t i = 0; i < count; ++i) {
+        prefix->order[i] = (uint32_t) sorted[i];
+    }
+    comp_free(sorted);
+
+    // Breadth first, so the children of a node get added one after another.
+    // A prefix of every word at every length is as many nodes as there can be
+    size_t cap = 1 + count*VOCAB_WORD_LENGTH;
+    prefix->nodes = comp_realloc(NULL, cap*sizeof(Vocab_Prefix_Node));
+    unsigned char *depths = comp_realloc(NULL, cap);
+    assert(prefix->nodes != NULL && depths != NULL && "Buy more RAM lol");
+    prefix->nodes[0] = (Vocab_Prefix_Node) { 0, 0, 0, (uint32_t) count };
+    depths[0] = 0;
+    prefix->nodes_count = 1;
+    for (size_t n = 0; n < prefix->nodes_count; ++n) {
+        Vocab_Prefix_Node *node = &prefix->nodes[n];
+        size_t depth = depths[n];
+        node->first_child = (uint32_t) prefix->nodes_count;
+        if (depth == VOCAB_WORD_LENGTH) continue;
+
+        size_t i = node->begin;
+        while (i < node->end) {
+            char letter = words[prefix->order[i]][depth];
+            size_t j = i;
+            while (j < node->end && words[prefix->order[j]][depth] == letter) j += 1;
+            node->children |= 1u << (letter - 'a');
+            prefix->nodes[prefix->nodes_count] = (Vocab_Prefix_Node) { 0, 0, (uint32_t) i, (uint32_t) j };
+            depths[prefix->nodes_count] = (unsigned char) (depth + 1);
+            prefix->nodes_count += 1;
+            i = j;
+        }
+    }
+    comp_free(depths);
+    prefix->nodes = comp_realloc(prefix->nodes, prefix->nodes_count*sizeof(Vocab_Prefix_Node));
+}
+
+void vocab_prefix_free(Vocab_Prefix *prefix) {
+    if (prefix->nodes != NULL) comp_free(prefix->nodes);
+    if (prefix->order != NULL) comp_free(prefix->order);
+    memset(prefix, 0, sizeof(*prefix));
+}
+
+static inline uint32_t vocab_popcount32(uint32_t x) {
+#if defined(__GNUC__)
+    return (uint32_t) __builtin_popcount(x);
+#else
+    x = x - ((x >> 1) & 0x55555555u);
+    x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+    return (((x + (x >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24;
+#endif
+}
+
+Vocab_Prefix_Range vocab_prefix_find(const Vocab_Prefix *prefix, const char *letters, size_t length) {
+    Vocab_Prefix_Range empty = {0, 0};
+    if (prefix->nodes == NULL) return empty;
+
+    const Vocab_Prefix_Node *node = &prefix->nodes[0];
+    for (size_t i = 0; i < length; ++i) {
+        uint32_t letter = (uint32_t) ((unsigned char) letters[i] - 'a');
+        if (letter >= 26 || !(node->children & (1u << letter))) return empty;
+        node = &prefix->nodes[node->first_child + vocab_popcount32(node->children & ((1u << letter) - 1))];
+    }
+    return (Vocab_Prefix_Range) { node->begin, node->end };
+}
+
+size_t vocab_columns_nearest(const Vocab_Columns *columns, const char *word, size_t max_distance, size_t *nearest, size_t k) {
+    assert(k <= VOCAB_NEAREST_CAP);
+    if (k == 0) return 0;
+
+    // Distances of `nearest`, and what a word needs to be under to get in
+    unsigned char distances[VOCAB_NEAREST_CAP];
+    size_t found = 0;
+    unsigned char cutoff = (unsigned char) (max_distance < VOCAB_WORD_LENGTH ? max_distance + 1 : VOCAB_WORD_LENGTH + 1);
+
+    for (size_t block = 0; block < columns->stride && cutoff > 0; block += VOCAB_COLUMNS_BLOCK) {
+        // A whole block at a time with no branches, the compiler makes it a
+        // few vector compares per column
+        unsigned char distance[VOCAB_COLUMNS_BLOCK] = {0};
+        for (size_t j = 0; j < VOCAB_WORD_LENGTH; ++j) {
+            const unsigned char *column = columns->letters + j*columns->stride + block;
+            unsigned char letter = (unsigned char) word[j];
+            for (size_t b = 0; b < VOCAB_COLUMNS_BLOCK; ++b) {
+                distance[b] += column[b] != letter;
+            }
+        }
+        unsigned char close = 0;
+        for (size_t b = 0; b < VOCAB_COLUMNS_BLOCK; ++b) {
+            close |= distance[b] < cutoff;
+        }
+        if (!close) continue;
+
+        for (size_t b = 0; b < VOCAB_COLUMNS_BLOCK && block + b < columns->count; ++b) {
+            if (distance[b] >= cutoff) continue;
+            // Goes after the ones as close as it, they came first
+            size_t i = found < k ? found++ : k - 1;
+            while (i > 0 && distances[i - 1] > distance[b]) {
+                distances[i] = distances[i - 1];
+                nearest[i] = nearest[i - 1];
+                i -= 1;
+            }
+            distances[i] = distance[b];
+            nearest[i] = block + b;
+            if (found == k) cutoff = distances[k - 1];
+        }
+    }
+    return found;
+}
+
+static inline uint32_t vocab_ctz64(uint64_t x) {
+#if defined(__GNUC__)
+    return (uint32_t) __builtin_ctzll(x);
+#else
+    uint32_t n = 0;
+    while (!(x & 1)) {
+        x >>= 1;
+        n += 1;
+    }
+    return n;
+#endif
+}
+
+// A compare a block goes through, the letters in a column have to be `letter`
+// or, with `negate` set, have to not be it
+typedef struct {
+    size_t column;
+    unsigned char letter;
+    unsigned char negate;
+} Vocab_Match_Pass;
+
+// Bit b is set if word block + b passes the letter sets and then every pass
+static uint64_t vocab_columns_match_block(const Vocab_Columns *columns, size_t block, const Vocab_Match_Pass *passes, size_t passes_count, uint32_t care, uint32_t want) {
+    uint64_t bits = 0;
+#if defined(VOCAB_DICT_SSE2)
+    const __m128i care_lanes = _mm_set1_epi32((int) care);
+    const __m128i want_lanes = _mm_set1_epi32((int) want);
+    for (size_t i = 0; i < VOCAB_COLUMNS_BLOCK; i += 16) {
+        // Sixteen masks compared four at a time, then narrowed to a byte each
+        // to line up with the letters
+        const __m128i *masks = (const __m128i *) (columns->masks + block + i);
+        __m128i m0 = _mm_cmpeq_epi32(_mm_and_si128(_mm_load_si128(masks + 0), care_lanes), want_lanes);
+        __m128i m1 = _mm_cmpeq_epi32(_mm_and_si128(_mm_load_si128(masks + 1), care_lanes), want_lanes);
+        __m128i m2 = _mm_cmpeq_epi32(_mm_and_si128(_mm_load_si128(masks + 2), care_lanes), want_lanes);
+        __m128i m3 = _mm_cmpeq_epi32(_mm_and_si128(_mm_load_si128(masks + 3), care_lanes), want_lanes);
+        __m128i ok = _mm_packs_epi16(_mm_packs_epi32(m0, m1), _mm_packs_epi32(m2, m3));
+        // The letter sets alone rule out most of the words
+        if (_mm_movemask_epi8(ok) == 0) continue;
+        for (size_t p = 0; p < passes_count; ++p) {
+            __m128i column = _mm_load_si128((const __m128i *) (columns->letters + passes[p].column*columns->stride + block + i));
+            __m128i equal = _mm_cmpeq_epi8(column, _mm_set1_epi8((char) passes[p].letter));
+            ok = _mm_and_si128(ok, _mm_xor_si128(equal, _mm_set1_epi8((char) -passes[p].negate)));
+        }
+        bits |= (uint64_t) (uint16_t) _mm_movemask_epi8(ok) << i;
+    }
+#else
+    // Same as the nearest search, fixed size blocks with no branches that
+    // the compiler can turn into vector compares
+    unsigned char ok[VOCAB_COLUMNS_BLOCK];
+    const uint32_t *masks = columns->masks + block;
+    for (size_t b = 0; b < VOCAB_COLUMNS_BLOCK; ++b) {
+        ok[b] = (masks[b] & care) == want;
+    }
+    for (size_t p = 0; p < passes_count; ++p) {
+        const unsigned char *column = columns->letters + passes[p].column*columns->stride + block;
+        unsigned char letter = passes[p].letter;
+        unsigned char negate = passes[p].negate;
+        for (size_t b = 0; b < VOCAB_COLUMNS_BLOCK; ++b) {
+            ok[b] &= (column[b] == letter) ^ negate;
+        }
+    }
+    for (size_t b = 0; b < VOCAB_COLUMNS_BLOCK; ++b) {
+        bits |= (uint64_t) ok[b] << b;
+    }
+#endif
+    return bits;
+}
+
+size_t vocab_columns_match(const Vocab_Columns *columns, const Vocab_Pattern *pattern, size_t *matches, size_t cap) {
+    // A letter both required and ruled out, here or at its own position,
+    // leaves nothing to find
+    if (pattern->has & pattern->lacks) return 0;
+    uint32_t care = pattern->has | pattern->lacks;
+    size_t passes_count = 0;
+    // At most every letter at every position
+    Vocab_Match_Pass passes[26*VOCAB_WORD_LENGTH];
+    for (size_t j = 0; j < VOCAB_WORD_LENGTH; ++j) {
+        if (pattern->letters[j] != 0) {
+            uint32_t bit = 1u << (pattern->letters[j] - 'a');
+            if ((pattern->not_at[j] | pattern->lacks) & bit) return 0;
+            care |= bit;
+            passes[passes_count++] = (Vocab_Match_Pass) { j, (unsigned char) pattern->letters[j], 0 };
+            continue;
+        }
+        // Letters that are nowhere are already taken care of by the masks
+        for (uint32_t bits = pattern->not_at[j] & ~pattern->lacks; bits != 0; bits &= bits - 1) {
+            passes[passes_count++] = (Vocab_Match_Pass) { j, (unsigned char) ('a' + vocab_ctz64(bits)), 1 };
+        }
+    }
+    uint32_t want = care & ~pattern->lacks;
+
+    size_t total = 0;
+    for (size_t block = 0; block < columns->stride; block += VOCAB_COLUMNS_BLOCK) {
+        uint64_t bits = vocab_columns_match_block(columns, block, passes, passes_count, care, want);
+        // The zero rows past the end fail any pattern with a letter in it,
+        // but not the one that has none
+        if (columns->count - block < VOCAB_COLUMNS_BLOCK) {
+            bits &= ((uint64_t) 1 << (columns->count - block)) - 1;
+        }
+        for (; bits != 0; bits &= bits - 1) {
+            if (total < cap) matches[total] = block + vocab_ctz64(bits);
+            total += 1;
+        }
+    }
+    return total;
+}
+
+// Top bit of every letter's field
+#define VOCAB_LETTERS_GUARD_LOW 0x8888888888888888ULL
+#define VOCAB_LETTERS_GUARD_HIGH 0x0000008888888888ULL
+
+Vocab_Letters vocab_letters(const char *text, size_t length) {
+    Vocab_Letters letters = {0, 0};
+    for (size_t i = 0; i < length; ++i) {
+        unsigned letter = (unsigned) (((unsigned char) text[i] | 0x20) - 'a');
+        if (letter >= 26) continue;
+        uint64_t *half = letter < 16 ? &letters.low : &letters.high;
+        unsigned shift = (letter % 16) * 4;
+        if (((*half >> shift) & 0x7) < 7) *half += (uint64_t) 1 << shift;
+    }
+    return letters;
+}
+
+// vocab_word_key() of the letters of `word` in alphabetical order, 0 if it is
+// not a word
+static uint32_t vocab_anagram_key(const char *word) {
+    char sorted[VOCAB_WORD_LENGTH];
+    memcpy(sorted, word, VOCAB_WORD_LENGTH);
+    for (size_t i = 1; i < VOCAB_WORD_LENGTH; ++i) {
+        char c = sorted[i];
+        size_t j = i;
+        for (; j > 0 && sorted[j - 1] > c; --j) sorted[j] = sorted[j - 1];
+        sorted[j] = c;
+    }
+    return vocab_word_key(sorted);
+}
+
+static inline size_t vocab_anagram_slot(const Vocab_Anagrams *anagrams, uint32_t key) {
+    return (size_t) ((key * 0x9E3779B1u) >> (32 - anagrams->slot_bits));
+}
+
+void vocab_anagrams_init(Vocab_Anagrams *anagrams, const Cstr *words, size_t count) {
+    memset(anagrams, 0, sizeof(*anagrams));
+    anagrams->count = count;
+    // Counts of 8 take the guard bits away from whatever is available
+    size_t stride = (count + 63) / 64 * 64;
+    anagrams->masks = comp_realloc(NULL, (stride + 1)*sizeof(uint32_t));
+    anagrams->low = comp_realloc(NULL, (stride + 1)*sizeof(uint64_t));
+    anagrams->high = comp_realloc(NULL, (stride + 1)*sizeof(uint64_t));
+    anagrams->order = comp_realloc(NULL, (count + 1)*sizeof(uint32_t));
+    uint64_t *sorted = comp_realloc(NULL, (count + 1)*sizeof(uint64_t));
+    assert(anagrams->masks != NULL && anagrams->low != NULL && anagrams->high != NULL && anagrams->order != NULL && sorted != NULL && "Buy more RAM lol");
+    for (size_t i = count; i < stride; ++i) {
+        anagrams->masks[i] = 0;
+        anagrams->low[i] = VOCAB_LETTERS_GUARD_LOW;
+        anagrams->high[i] = VOCAB_LETTERS_GUARD_HIGH;
+    }
+
+    size_t groups = 0;
+    for (size_t i = 0; i < count; ++i) {
+        Vocab_Letters letters = vocab_letters(words[i], VOCAB_WORD_LENGTH);
+        anagrams->low[i] = letters.low;
+        anagrams->high[i] = letters.high;
+        anagrams->masks[i] = 0;
+        for (size_t j = 0; j < VOCAB_WORD_LENGTH; ++j) {
+            anagrams->masks[i] |= 1u << (words[i][j] - 'a');
+        }
+        uint32_t key = vocab_anagram_key(words[i]);
+        assert(key != 0 && "Error: not a word");
+        sorted[i] = ((uint64_t) key << 32) | i;
+    }
+    qsort(sorted, count, sizeof(sorted[0]), vocab_prefix_compare);
+    for (size_t i = 0; i < count; ++i) {
+        anagrams->order[i] = (uint32_t) sorted[i];
+        groups += i == 0 || (sorted[i] >> 32) != (sorted[i - 1] >> 32);
+    }
+
+    anagrams->slot_bits = 4;
+    while (((size_t) 1 << anagrams->slot_bits) < groups*2) anagrams->slot_bits += 1;
+    size_t mask = ((size_t) 1 << anagrams->slot_bits) - 1;
+    anagrams->slots = comp_realloc(NULL, (mask + 1)*sizeof(Vocab_Anagram_Slot));
+    assert(anagrams->slots != NULL && "Buy more RAM lol");
+    memset(anagrams->slots, 0, (mask + 1)*sizeof(Vocab_Anagram_Slot));
+    size_t i = 0;
+    while (i < count) {
+        uint32_t key = (uint32_t) (sorted[i] >> 32);
+        size_t j = i;
+        while (j < count && (uint32_t) (sorted[j] >> 32) == key) j += 1;
+        size_t slot = vocab_anagram_slot(anagrams, key);
+        while (anagrams->slots[slot].key != 0) slot = (slot + 1) & mask;
+        anagrams->slots[slot] = (Vocab_Anagram_Slot) { key, (uint32_t) i, (uint32_t) j };
+        i = j;
+    }
+    comp_free(sorted);
+}
+
+void vocab_anagrams_free(Vocab_Anagrams *anagrams) {
+    if (anagrams->masks != NULL) comp_free(anagrams->masks);
+    if (anagrams->low != NULL) comp_free(anagrams->low);
+    if (anagrams->high != NULL) comp_free(anagrams->high);
+    if (anagrams->order != NULL) comp_free(anagrams->order);
+    if (anagrams->slots != NULL) comp_free(anagrams->slots);
+    memset(anagrams, 0, sizeof(*anagrams));
+}
+
+Vocab_Prefix_Range vocab_anagrams_find(const Vocab_Anagrams *anagrams, const char *word) {
+    Vocab_Prefix_Range empty = {0, 0};
+    if (anagrams->slots == NULL || strlen(word) != VOCAB_WORD_LENGTH) return empty;
+    uint32_t key = vocab_anagram_key(word);
+    if (key == 0) return empty;
+    size_t mask = ((size_t) 1 << anagrams->slot_bits) - 1;
+    size_t slot = vocab_anagram_slot(anagrams, key);
+    while (anagrams->slots[slot].key != 0) {
+        if (anagrams->slots[slot].key == key) {
+            return (Vocab_Prefix_Range) { anagrams->slots[slot].begin, anagrams->slots[slot].end };
+        }
+        slot = (slot + 1) & mask;
+    }
+    return empty;
+}
+
+size_t vocab_anagrams_within(const Vocab_Anagrams *anagrams, Vocab_Letters available, size_t *matches, size_t cap) {
+    // Letters there are none of
+    uint32_t missing = 0;
+    for (uint32_t c = 0; c < 26; ++c) {
+        uint64_t half = c < 16 ? available.low : available.high;
+        missing |= (uint32_t) (((half >> (c % 16) * 4) & 0xF) == 0) << c;
+    }
+    // A word fits if taking its counts away from the available ones leaves
+    // every guard bit set, a letter it has too many of borrows the guard
+    const uint64_t have_low = available.low | VOCAB_LETTERS_GUARD_LOW;
+    const uint64_t have_high = available.high | VOCAB_LETTERS_GUARD_HIGH;
+
+    size_t total = 0;
+    for (size_t block = 0; block < anagrams->count; block += 64) {
+        const uint32_t *masks = anagrams->masks + block;
+        const uint64_t *low = anagrams->low + block;
+        const uint64_t *high = anagrams->high + block;
+        uint64_t bits = 0;
+#if defined(VOCAB_DICT_SSE2)
+        const __m128i missings = _mm_set1_epi32((int) missing);
+        const __m128i have_lows = _mm_set1_epi64x((long long) have_low);
+        const __m128i have_highs = _mm_set1_epi64x((long long) have_high);
+        const __m128i guard_lows = _mm_set1_epi64x((long long) VOCAB_LETTERS_GUARD_LOW);
+        const __m128i guard_highs = _mm_set1_epi64x((long long) VOCAB_LETTERS_GUARD_HIGH);
+        const __m128i zero = _mm_setzero_si128();
+        for (size_t i = 0; i < 64; i += 16) {
+            // Sixteen words at a time by the letters they have
+            __m128i m0 = _mm_cmpeq_epi32(_mm_and_si128(_mm_loadu_si128((const __m128i *) (masks + i + 0)), missings), zero);
+            __m128i m1 = _mm_cmpeq_epi32(_mm_and_si128(_mm_loadu_si128((const __m128i *) (masks + i + 4)), missings), zero);
+            __m128i m2 = _mm_cmpeq_epi32(_mm_and_si128(_mm_loadu_si128((const __m128i *) (masks + i + 8)), missings), zero);
+            __m128i m3 = _mm_cmpeq_epi32(_mm_and_si128(_mm_loadu_si128((const __m128i *) (masks + i + 12)), missings), zero);
+            uint32_t spelled = (uint32_t) _mm_movemask_epi8(_mm_packs_epi16(_mm_packs_epi32(m0, m1), _mm_packs_epi32(m2, m3)));
+            if (spelled == 0) continue;
+            // Then two at a time by how many of each
+            uint32_t counted = 0;
+            for (size_t b = 0; b < 16; b += 2) {
+                // Guard bits lost in either half, zero for a word that fits
+                __m128i lost = _mm_or_si128(
+                    _mm_andnot_si128(_mm_sub_epi64(have_lows, _mm_loadu_si128((const __m128i *) (low + i + b))), guard_lows),
+                    _mm_andnot_si128(_mm_sub_epi64(have_highs, _mm_loadu_si128((const __m128i *) (high + i + b))), guard_highs));
+                // No 64 bit compare in SSE2, both 32 bit halves have to be zero
+                __m128i kept = _mm_cmpeq_epi32(lost, zero);
+                kept = _mm_and_si128(kept, _mm_shuffle_epi32(kept, _MM_SHUFFLE(2, 3, 0, 1)));
+                counted |= (uint32_t) _mm_movemask_pd(_mm_castsi128_pd(kept)) << b;
+            }
+            bits |= (uint64_t) (spelled & counted) << i;
+        }
+#else
+        for (size_t b = 0; b < 64; ++b) {
+            uint64_t lost = (~(have_low - low[b]) & VOCAB_LETTERS_GUARD_LOW) | (~(have_high - high[b]) & VOCAB_LETTERS_GUARD_HIGH);
+            bits |= (uint64_t) ((masks[b] & missing) == 0 && lost == 0) << b;
+        }
+#endif
+        for (; bits != 0; bits &= bits - 1) {
+            if (total < cap) matches[total] = block + vocab_ctz64(bits);
+            total += 1;
+        }
+    }
+    return total;
+}
+
+#define VOCAB_LENGTH_TEMPLATE_IMPLEMENTATION
+#define VOCAB_LENGTH VOCAB_WORD_LENGTH
+#include "./vocab_length_template.h"
+#undef VOCAB_LENGTH
+#undef VOCAB_LENGTH_TEMPLATE_IMPLEMENTATION
+
+bool vocab_candidate_matches(const char *word, const char *guess, const Vocab_Color colors[VOCAB_WORD_LENGTH]) {
+    Vocab_Color would_be[VOCAB_WORD_LENGTH];
+    vocab5_score(word, guess, would_be);
+    return memcmp(would_be, colors, sizeof(would_be)) == 0;
+}
+
+bool vocab_pattern_parse(Vocab_Pattern *pattern, const char *text) {
+    memset(pattern, 0, sizeof(*pattern));
+    for (size_t j = 0; j < VOCAB_WORD_LENGTH; ++j) {
+        char c = text[j];
+        if (c >= 'A' && c <= 'Z') c = (char) (c - 'A' + 'a');
+        if (c >= 'a' && c <= 'z') {
+            pattern->letters[j] = c;
+        } else if (c != '?') {
+            return false;
+        }
+    }
+    return text[VOCAB_WORD_LENGTH] == '\0';
+}
+
+void vocab_pattern_learn(Vocab_Pattern *pattern, const char *guess, const Vocab_Color colors[VOCAB_WORD_LENGTH]) {
+    // Letters that are in the answer going by this row, a gray one of them is
+    // just a repeat the answer doesn't have as many of
+    uint32_t found = 0;
+    for (size_t j = 0; j < VOCAB_WORD_LENGTH; ++j) {
+        if (colors[j] == VOCAB_GREEN || colors[j] == VOCAB_YELLOW) found |= 1u << (guess[j] - 'a');
+    }
+    for (size_t j = 0; j < VOCAB_WORD_LENGTH; ++j) {
+        uint32_t bit = 1u << (guess[j] - 'a');
+        switch (colors[j]) {
+            case VOCAB_GREEN: {
+                pattern->letters[j] = guess[j];
+                pattern->has |= bit;
+            } break;
+            case VOCAB_YELLOW: {
+                pattern->not_at[j] |= bit;
+                pattern->has |= bit;
+            } break;
+            case VOCAB_GRAY: {
+                pattern->not_at[j] |= bit;
+                if (!(found & bit)) pattern->lacks |= bit;
+            } break;
+            case VOCAB_BLACK: break;
+        }
+    }
+}
+
+#define VOCAB_PACKED_LETTER_BITS 5
+#define VOCAB_PACKED_ROW_BITS (VOCAB_PACKED_LETTER_BITS*VOCAB_WORD_LENGTH)
+#define VOCAB_PACKED_HEADER_SHIFT 50
+#define VOCAB_PACKED_ATTEMPT_SHIFT 50
+#define VOCAB_PACKED_CURSOR_SHIFT 53
+
+static inline uint64_t vocab_packed_letter_shift(size_t row, size_t col) {
+    return (row % 2) * VOCAB_PACKED_ROW_BITS + col * VOCAB_PACKED_LETTER_BITS;
+}
+
+static inline void vocab_packed_set_letter(Vocab_Packed *packed, size_t row, size_t col, char letter) {
+    uint64_t shift = vocab_packed_letter_shift(row, col);
+    uint64_t value = letter == '\0' ? 0 : (uint64_t) (letter - 'a' + 1);
+    packed->rows[row / 2] = (packed->rows[row / 2] & ~(0x1FULL << shift)) | (value << shift);
+}
+
+static inline void vocab_packed_set_counters(Vocab_Packed *packed, size_t attempt, size_t cursor) {
+    uint64_t mask = 0x3FULL << VOCAB_PACKED_ATTEMPT_SHIFT;
+    uint64_t value = ((uint64_t) attempt << VOCAB_PACKED_ATTEMPT_SHIFT) | ((uint64_t) cursor << VOCAB_PACKED_CURSOR_SHIFT);
+    packed->rows[1] = (packed->rows[1] & ~mask) | value;
+}
+
+Vocab_Packed vocab_packed_new(size_t answer) {
+    assert(answer < VOCAB_PACKED_ANSWERS_CAP);
+    Vocab_Packed packed = {0};
+    packed.rows[0] = (uint64_t) answer << VOCAB_PACKED_HEADER_SHIFT;
+    return packed;
+}
+
+Vocab_Packed vocab_pack(const Vocab5 *vocab, size_t answer) {
+    Vocab_Packed packed = vocab_packed_new(answer);
+    // Squares go in last to first so every one is a shift and an or
+    for (size_t i = VOCAB_ATTEMPTS_COUNT; i-- > 0;) {
+        uint64_t row = 0;
+        for (size_t j = VOCAB_WORD_LENGTH; j-- > 0;) {
+            char letter = vocab->grid[i][j];
+            row = (row << VOCAB_PACKED_LETTER_BITS) | (letter == '\0' ? 0 : (uint64_t) (letter - 'a' + 1));
+            packed.colors = (packed.colors << 2) | (uint64_t) vocab->color_grid[i][j];
+        }
+        packed.rows[i / 2] |= row << ((i % 2) * VOCAB_PACKED_ROW_BITS);
+    }
+    vocab_packed_set_counters(&packed, vocab->current_attempt, vocab->cursor);
+    return packed;
+}
+
+Vocab5 vocab_unpack(const Vocab_Packed *packed, const Cstr *answers) {
+    Vocab5 vocab = {0};
+    vocab.word = answers[vocab_packed_answer(packed)];
+    uint64_t colors = packed->colors;
+    for (size_t i = 0; i < VOCAB_ATTEMPTS_COUNT; ++i) {
+        uint64_t row = packed->rows[i / 2] >> ((i % 2) * VOCAB_PACKED_ROW_BITS);
+        for (size_t j = 0; j < VOCAB_WORD_LENGTH; ++j) {
+            uint64_t letter = row & 0x1F;
+            vocab.grid[i][j] = letter == 0 ? '\0' : (char) ('a' + letter - 1);
+            vocab.color_grid[i][j] = (Vocab_Color) (colors & 0x3);
+            row >>= VOCAB_PACKED_LETTER_BITS;
+            colors >>= 2;
+        }
+    }
+    vocab.current_attempt = vocab_packed_attempt(packed);
+    vocab.cursor = vocab_packed_cursor(packed);
+    return vocab;
+}
+
+size_t vocab_packed_answer(const Vocab_Packed *packed) {
+    return (size_t) (packed->rows[0] >> VOCAB_PACKED_HEADER_SHIFT);
+}
+
+size_t vocab_packed_attempt(const Vocab_Packed *packed) {
+    return (size_t) ((packed->rows[1] >> VOCAB_PACKED_ATTEMPT_SHIFT) & 0x7);
+}
+
+size_t vocab_packed_cursor(const Vocab_Packed *packed) {
+    return (size_t) ((packed->rows[1] >> VOCAB_PACKED_CURSOR_SHIFT) & 0x7);
+}
+
+char vocab_packed_letter(const Vocab_Packed *packed, size_t row, size_t col) {
+    uint64_t value = (packed->rows[row / 2] >> vocab_packed_letter_shift(row, col)) & 0x1F;
+    return value == 0 ? '\0' : (char) ('a' + value - 1);
+}
+
+Vocab_Color vocab_packed_color(const Vocab_Packed *packed, size_t row, size_t col) {
+    return (Vocab_Color) ((packed->colors >> (2*(row*VOCAB_WORD_LENGTH + col))) & 0x3);
+}
+
+bool vocab_packed_is_over(const Vocab_Packed *packed) {
+    size_t attempt = vocab_packed_attempt(packed);
+    if (attempt >= VOCAB_ATTEMPTS_COUNT) return true;
+    if (attempt == 0) return false;
+
+    // VOCAB_GREEN is both bits set, a won row is all ones
+    uint64_t row_mask = (1ULL << (2*VOCAB_WORD_LENGTH)) - 1;
+    return ((packed->colors >> (2*VOCAB_WORD_LENGTH*(attempt - 1))) & row_mask) == row_mask;
+}
+
+void vocab_packed_type_letter(Vocab_Packed *packed, char letter) {
+    size_t cursor = vocab_packed_cursor(packed);
+    if (vocab_packed_is_over(packed) || cursor >= VOCAB_WORD_LENGTH) return;
+    size_t attempt = vocab_packed_attempt(packed);
+    vocab_packed_set_letter(packed, attempt, cursor, letter);
+    vocab_packed_set_counters(packed, attempt, cursor + 1);
+}
+
+void vocab_packed_erase_letter(Vocab_Packed *packed) {
+    size_t cursor = vocab_packed_cursor(packed);
+    if (vocab_packed_is_over(packed) || cursor == 0) return;
+    size_t attempt = vocab_packed_attempt(packed);
+    vocab_packed_set_letter(packed, attempt, cursor - 1, '\0');
+    vocab_packed_set_counters(packed, attempt, cursor - 1);
+}
+
+bool vocab_packed_submit(Vocab_Packed *packed, const Cstr *answers, const Vocab_Dict *dict) {
+    if (vocab_packed_is_over(packed) || vocab_packed_cursor(packed) < VOCAB_WORD_LENGTH) return false;
+
+    size_t attempt = vocab_packed_attempt(packed);
+    char word[VOCAB_WORD_LENGTH + 1] = {0};
+    uint64_t row = packed->rows[attempt / 2] >> ((attempt % 2) * VOCAB_PACKED_ROW_BITS);
+    for (size_t j = 0; j < VOCAB_WORD_LENGTH; ++j) {
+        // The row is full, no empty squares
+        word[j] = (char) ('a' + (row & 0x1F) - 1);
+        row >>= VOCAB_PACKED_LETTER_BITS;
+    }
+    if (!vocab_dict_contains(dict, word)) return false;
+
+    Vocab_Color colors[VOCAB_WORD_LENGTH];
+    vocab5_score(answers[vocab_packed_answer(packed)], word, colors);
+    uint64_t row_colors = 0;
+    for (size_t j = VOCAB_WORD_LENGTH; j-- > 0;) {
+        row_colors = (row_colors << 2) | (uint64_t) colors[j];
+    }
+    packed->colors |= row_colors << (2*VOCAB_WORD_LENGTH*attempt);
+    vocab_packed_set_counters(packed, attempt + 1, 0);
+    return true;
+}
+
+void vocab_score_many(const char (*answers)[VOCAB_BOARDS_CAP], size_t count, const char *guess, Vocab_Color (*colors)[VOCAB_WORD_LENGTH]) {
+    assert(count <= VOCAB_BOARDS_CAP);
+
+    // Letter j is yellow when the answer has more of it outside of the greens
+    // than the guess has before j outside of the greens, which is what the
+    // counting in vocab5_score() comes down to. The loops go over every board
+    // slot with no branches, so the compiler does them a vector at a time,
+    // slots past `count` are scored too and thrown away
+    unsigned char green[VOCAB_WORD_LENGTH][VOCAB_BOARDS_CAP];
+    unsigned char result[VOCAB_WORD_LENGTH][VOCAB_BOARDS_CAP];
+    for (size_t j = 0; j < VOCAB_WORD_LENGTH; ++j) {
+        for (size_t b = 0; b < VOCAB_BOARDS_CAP; ++b) {
+            green[j][b] = answers[j][b] == guess[j];
+        }
+    }
+
+    for (size_t j = 0; j < VOCAB_WORD_LENGTH; ++j) {
+        unsigned char available[VOCAB_BOARDS_CAP] = {0};
+        for (size_t k = 0; k < VOCAB_WORD_LENGTH; ++k) {
+            for (size_t b = 0; b < VOCAB_BOARDS_CAP; ++b) {
+                available[b] += (answers[k][b] == guess[j]) & (green[k][b] ^ 1);
+            }
+        }
+        for (size_t i = 0; i < j; ++i) {
+            if (guess[i] != guess[j]) continue;
+            for (size_t b = 0; b < VOCAB_BOARDS_CAP; ++b) {
+                available[b] -= available[b] > 0 ? green[i][b] ^ 1 : 0;
+            }
+        }
+        for (size_t b = 0; b < VOCAB_BOARDS_CAP; ++b) {
+            unsigned char yellow = available[b] > 0;
+            result[j][b] = green[j][b] ? VOCAB_GREEN : VOCAB_GRAY + yellow;
+        }
+    }
+
+    for (size_t b = 0; b < count; ++b) {
+        for (size_t j = 0; j < VOCAB_WORD_LENGTH; ++j) {
+            colors[b][j] = (Vocab_Color) result[j][b];
+        }
+    }
+}
+
+void vocab_boards_init(Vocab_Boards *boards, const Cstr *answers, size_t count) {
+    assert(count > 0 && count <= VOCAB_BOARDS_CAP);
+    memset(boards, 0, sizeof(*boards));
+    boards->count = count;
+    boards->attempts_count = count + VOCAB_ATTEMPTS_COUNT - 1;
+    for (size_t b = 0; b < count; ++b) {
+        boards->words[b] = answers[b];
+        for (size_t j = 0; j < VOCAB_WORD_LENGTH; ++j) {
+            boards->answers[j][b] = answers[b][j];
+        }
+    }
+}
+
+bool vocab_boards_is_over(const Vocab_Boards *boards) {
+    return boards->solved_count == boards->count || boards->current_attempt >= boards->attempts_count;
+}
+
+void vocab_boards_type_letter(Vocab_Boards *boards, char letter) {
+    if (vocab_boards_is_over(boards) || boards->cursor >= VOCAB_WORD_LENGTH) return;
+    boards->grid[boards->current_attempt][boards->cursor] = letter;
+    boards->cursor += 1;
+    boards->rejected = false;
+}
+
+void vocab_boards_erase_letter(Vocab_Boards *boards) {
+    if (vocab_boards_is_over(boards) || boards->cursor == 0) return;
+    boards->grid[boards->current_attempt][boards->cursor - 1] = '\0';
+    boards->cursor -= 1;
+    boards->rejected = false;
+}
+
+bool vocab_boards_submit(Vocab_Boards *boards, const Vocab_Dict *dict) {
+    if (vocab_boards_is_over(boards) || boards->cursor < VOCAB_WORD_LENGTH) return false;
+
+    size_t attempt = boards->current_attempt;
+    char word[VOCAB_WORD_LENGTH + 1] = {0};
+    memcpy(word, boards->grid[attempt], VOCAB_WORD_LENGTH);
+    boards->rejected = !vocab_dict_contains(dict, word);
+    if (boards->rejected) return false;
+
+    // Solved boards get scored too, skipping them would cost more than it saves
+    Vocab_Color colors[VOCAB_BOARDS_CAP][VOCAB_WORD_LENGTH];
+    vocab_score_many((const char (*)[VOCAB_BOARDS_CAP]) boards->answers, boards->count, word, colors);
+    for (size_t b = 0; b < boards->count; ++b) {
+        if (boards->solved_in[b] != 0) continue;
+        memcpy(boards->color_grid[b][attempt], colors[b], sizeof(colors[b]));
+        if (memcmp(boards->words[b], word, VOCAB_WORD_LENGTH) == 0) {
+            boards->solved_in[b] = attempt + 1;
+            boards->solved_count += 1;
+        }
+    }
+    boards->current_attempt += 1;
+    boards->cursor = 0;
+    return true;
+}
+
+#endif // VOCAB_IMPLEMENTATION
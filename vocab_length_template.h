@@ -0,0 +1,209 @@
+// The rules for one word length, included once for every length in
+// VOCAB_LENGTHS with VOCAB_LENGTH set to it, by vocab.h for 5 letters and by
+// vocab_lengths.h for the others. Everything here has the length as a
+// constant, so the loops over letters are unrolled all the way (VOCAB_UNROLL)
+// and the rows are fixed size arrays.
+//
+// No include guard on purpose, every include makes a new set of names:
+//     Vocab4, vocab4_key(), vocab4_score(), ...
+//
+// With VOCAB_LENGTH_TEMPLATE_DRAW defined it makes vocab4_draw() instead,
+// which needs raylib and somui.h included before it.
+
+#ifndef VOCAB_LENGTH
+    #error "Define VOCAB_LENGTH before including vocab_length_template.h"
+#endif
+
+#define VOCAB_LT_CAT_(a, b) a##b
+#define VOCAB_LT_CAT(a, b) VOCAB_LT_CAT_(a, b)
+// vocab4_##name and Vocab4
+#define VOCAB_LT(name) VOCAB_LT_CAT(VOCAB_LT_CAT(vocab, VOCAB_LENGTH), _##name)
+#define VOCAB_LT_TYPE VOCAB_LT_CAT(Vocab, VOCAB_LENGTH)
+// One more try than there are letters, like the 5 letter game
+#define VOCAB_LT_ATTEMPTS (VOCAB_LENGTH + 1)
+
+#if defined(VOCAB_LENGTH_TEMPLATE_DRAW)
+
+#ifndef VOCAB_DRAW_HOOK_
+#define VOCAB_DRAW_HOOK_
+// Called with its `user` pointer in the middle of drawing a board
+typedef void (*Vocab_Draw_Hook)(void *user);
+#endif // VOCAB_DRAW_HOOK_
+
+// The board, squares as big as fit the window, returns where it went. With
+// `dead_end` the letters typed into the live row are marked as no word's
+// start. `before_live_row`, if not NULL, runs right before the live row is
+// drawn and may still type into it
+UI_Rect VOCAB_LT(draw)(UI_Stack *ui, const VOCAB_LT_TYPE *vocab, Font font, int32_t window_width, int32_t window_height,
+                       bool dead_end, Vocab_Draw_Hook before_live_row, void *user) {
+    int32_t gap = 10;
+    int32_t margin = 40;
+    int32_t fit_w = (window_width - 2*margin - gap * (VOCAB_LENGTH - 1)) / VOCAB_LENGTH;
+    int32_t fit_h = (window_height - 2*margin - gap * (VOCAB_LT_ATTEMPTS - 1)) / VOCAB_LT_ATTEMPTS;
+    int32_t square_size = fit_w < fit_h ? fit_w : fit_h;
+    if (square_size > 100) square_size = 100;
+    if (square_size < 1) square_size = 1;
+
+    int32_t width = square_size * VOCAB_LENGTH + gap * (VOCAB_LENGTH - 1);
+    int32_t height = square_size * VOCAB_LT_ATTEMPTS + gap * (VOCAB_LT_ATTEMPTS - 1);
+    UI_Rect rect = { (window_width - width) / 2, (window_height - height) / 2, width, height };
+    float font_size = square_size * 0.48f;
+    int spacing = 6;
+
+    ui_layout_begin(ui, rect, UI_VERT, ui_marginv(0), gap, VOCAB_LT_ATTEMPTS);
+    for (size_t i = 0; i < VOCAB_LT_ATTEMPTS; ++i) {
+        if (before_live_row != NULL && i == vocab->current_attempt) before_live_row(user);
+
+        UI_Rect row = ui_layout_rect(ui);
+        ui_layout_begin(ui, row, UI_HORI, ui_marginv(0), gap, VOCAB_LENGTH);
+        for (size_t j = 0; j < VOCAB_LENGTH; ++j) {
+            UI_Rect square = ui_layout_rect(ui);
+
+            Color background_color = BLACK;
+            switch (vocab->color_grid[i][j]) {
+            case VOCAB_BLACK: background_color = BLACK; break;
+            case VOCAB_GRAY: background_color = GRAY; break;
+            case VOCAB_YELLOW: background_color = YELLOW; break;
+            case VOCAB_GREEN: background_color = GREEN; break;
+            }
+            // Letters that no word starts with
+            if (dead_end && i == vocab->current_attempt && j < vocab->cursor) background_color = MAROON;
+
+            DrawRectangle(square.x, square.y, square.w, square.h, background_color);
+            DrawRectangleLines(square.x, square.y, square.w, square.h, WHITE);
+
+            char letter = vocab->grid[i][j];
+            if (letter != '\0') {
+                const char *text = TextFormat("%c", toupper(letter));
+                Vector2 text_pos = { square.x + square.w / 2, square.y + square.h / 2 };
+                Vector2 text_size = MeasureTextEx(font, text, font_size, spacing);
+                Vector2 origin = { text_size.x / 2, text_size.y / 2 };
+                DrawTextPro(font, text, text_pos, origin, 0.0f, font_size, spacing, WHITE);
+            }
+        }
+        ui_layout_end(ui);
+    }
+    ui_layout_end(ui);
+    return rect;
+}
+
+#elif !defined(VOCAB_LENGTH_TEMPLATE_IMPLEMENTATION)
+
+typedef struct {
+    const char *word;
+    char grid[VOCAB_LT_ATTEMPTS][VOCAB_LENGTH];
+    Vocab_Color color_grid[VOCAB_LT_ATTEMPTS][VOCAB_LENGTH];
+    size_t current_attempt;
+    size_t cursor;
+    // The last submit was a full row that is not a word, until the row changes
+    bool rejected;
+} VOCAB_LT_TYPE;
+
+// Same as vocab_word_key64() for this length
+uint64_t VOCAB_LT(key)(const char *word);
+// Colors `guess` against `answer` like Wordle does, a repeated letter is only
+// yellow as many times as it appears in the answer outside of the greens.
+// Both words must be VOCAB_LENGTH lowercase letters.
+void VOCAB_LT(score)(const char *answer, const char *guess, Vocab_Color colors[VOCAB_LENGTH]);
+void VOCAB_LT(init)(VOCAB_LT_TYPE *vocab, const char *answer);
+bool VOCAB_LT(is_over)(const VOCAB_LT_TYPE *vocab);
+void VOCAB_LT(type_letter)(VOCAB_LT_TYPE *vocab, char letter);
+void VOCAB_LT(erase_letter)(VOCAB_LT_TYPE *vocab);
+// Scores the current row if it is a word in `set`, returns false if the row
+// is incomplete or not a word, and sets `rejected` for the latter
+bool VOCAB_LT(submit)(VOCAB_LT_TYPE *vocab, const Vocab_Word_Set *set);
+
+#else
+
+uint64_t VOCAB_LT(key)(const char *word) {
+    uint64_t key = 0;
+    uint64_t bad = 0;
+    VOCAB_UNROLL
+    for (size_t i = 0; i < VOCAB_LENGTH; ++i) {
+        uint64_t letter = (uint64_t) ((unsigned char) word[i] - 'a');
+        bad |= letter > 'z' - 'a';
+        key = (key << 5) | (letter + 1);
+    }
+    return key & (bad - 1);
+}
+
+void VOCAB_LT(score)(const char *answer, const char *guess, Vocab_Color colors[VOCAB_LENGTH]) {
+    // No letter table to clear and fill, with this few letters it is cheaper
+    // to compare every pair: a letter is yellow while the answer has more of
+    // it outside the greens than there are yellows of it before
+    int green[VOCAB_LENGTH];
+    int yellow[VOCAB_LENGTH];
+    VOCAB_UNROLL
+    for (size_t i = 0; i < VOCAB_LENGTH; ++i) {
+        green[i] = guess[i] == answer[i];
+    }
+    VOCAB_UNROLL
+    for (size_t i = 0; i < VOCAB_LENGTH; ++i) {
+        int left = 0;
+        VOCAB_UNROLL
+        for (size_t j = 0; j < VOCAB_LENGTH; ++j) {
+            left += !green[j] & (answer[j] == guess[i]);
+        }
+        VOCAB_UNROLL
+        for (size_t k = 0; k < i; ++k) {
+            left -= yellow[k] & (guess[k] == guess[i]);
+        }
+        yellow[i] = !green[i] & (left > 0);
+        // VOCAB_GRAY, VOCAB_YELLOW or VOCAB_GREEN without a branch
+        colors[i] = (Vocab_Color) (VOCAB_GRAY + yellow[i] + 2*green[i]);
+    }
+}
+
+void VOCAB_LT(init)(VOCAB_LT_TYPE *vocab, const char *answer) {
+    memset(vocab, 0, sizeof(*vocab));
+    vocab->word = answer;
+}
+
+bool VOCAB_LT(is_over)(const VOCAB_LT_TYPE *vocab) {
+    if (vocab->current_attempt >= VOCAB_LT_ATTEMPTS) return true;
+    if (vocab->current_attempt == 0) return false;
+
+    size_t last = vocab->current_attempt - 1;
+    bool won = true;
+    VOCAB_UNROLL
+    for (size_t i = 0; i < VOCAB_LENGTH; ++i) {
+        won &= vocab->color_grid[last][i] == VOCAB_GREEN;
+    }
+    return won;
+}
+
+void VOCAB_LT(type_letter)(VOCAB_LT_TYPE *vocab, char letter) {
+    if (VOCAB_LT(is_over)(vocab) || vocab->cursor >= VOCAB_LENGTH) return;
+    vocab->grid[vocab->current_attempt][vocab->cursor] = letter;
+    vocab->cursor += 1;
+    vocab->rejected = false;
+}
+
+void VOCAB_LT(erase_letter)(VOCAB_LT_TYPE *vocab) {
+    if (VOCAB_LT(is_over)(vocab) || vocab->cursor == 0) return;
+    vocab->grid[vocab->current_attempt][vocab->cursor - 1] = '\0';
+    vocab->cursor -= 1;
+    vocab->rejected = false;
+}
+
+bool VOCAB_LT(submit)(VOCAB_LT_TYPE *vocab, const Vocab_Word_Set *set) {
+    if (VOCAB_LT(is_over)(vocab) || vocab->cursor < VOCAB_LENGTH) return false;
+
+    const char *row = vocab->grid[vocab->current_attempt];
+    assert(set->length == VOCAB_LENGTH);
+    vocab->rejected = !vocab_word_set_contains(set, VOCAB_LT(key)(row));
+    if (vocab->rejected) return false;
+
+    VOCAB_LT(score)(vocab->word, row, vocab->color_grid[vocab->current_attempt]);
+    vocab->current_attempt += 1;
+    vocab->cursor = 0;
+    return true;
+}
+
+#endif // VOCAB_LENGTH_TEMPLATE_DRAW
+
+#undef VOCAB_LT_ATTEMPTS
+#undef VOCAB_LT_TYPE
+#undef VOCAB_LT
+#undef VOCAB_LT_CAT
+#undef VOCAB_LT_CAT_
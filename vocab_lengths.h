@@ -0,0 +1,197 @@
+#ifndef VOCAB_LENGTHS_H_
+#define VOCAB_LENGTHS_H_
+
+// The rules for words of other lengths than VOCAB_WORD_LENGTH, all in one
+// build. vocab_length_template.h is compiled once per length so every length
+// gets code with its sizes known up front, and Vocab_Game picks the one for
+// the length of the game it holds when it is played. The 5 letter game is
+// the same template, vocab.h compiles that one.
+
+#include "./vocab.h"
+
+// Every length there is code for. A length costs a copy of the rules and
+// Vocab_Game gets as big as the biggest one
+#define VOCAB_LENGTHS(X) X(4) X(5) X(6) X(7)
+#define VOCAB_LENGTH_MIN 4
+#define VOCAB_LENGTH_MAX 7
+
+// Keys are 5 bits per letter
+#if VOCAB_LENGTH_MAX*5 > 64
+    #error "Vocab_Word_Set keys only fit words of up to 12 letters"
+#endif
+
+// An #include can't come out of a macro, these have to match VOCAB_LENGTHS.
+// vocab.h has the 5 letter one already
+#define VOCAB_LENGTH 4
+#include "./vocab_length_template.h"
+#undef VOCAB_LENGTH
+#define VOCAB_LENGTH 6
+#include "./vocab_length_template.h"
+#undef VOCAB_LENGTH
+#define VOCAB_LENGTH 7
+#include "./vocab_length_template.h"
+#undef VOCAB_LENGTH
+
+// A game of any length in VOCAB_LENGTHS. The functions switch on the length
+// once and go to the code for it
+typedef struct {
+    size_t length;
+    union {
+#define X(n) Vocab##n v##n;
+        VOCAB_LENGTHS(X)
+#undef X
+    } as;
+} Vocab_Game;
+
+bool vocab_length_supported(size_t length);
+// `answer` must be `length` lowercase letters from a supported length
+void vocab_game_init(Vocab_Game *game, size_t length, const char *answer);
+size_t vocab_game_attempts_count(const Vocab_Game *game);
+size_t vocab_game_current_attempt(const Vocab_Game *game);
+size_t vocab_game_cursor(const Vocab_Game *game);
+const char *vocab_game_answer(const Vocab_Game *game);
+char vocab_game_letter(const Vocab_Game *game, size_t row, size_t col);
+Vocab_Color vocab_game_color(const Vocab_Game *game, size_t row, size_t col);
+bool vocab_game_is_over(const Vocab_Game *game);
+void vocab_game_type_letter(Vocab_Game *game, char letter);
+void vocab_game_erase_letter(Vocab_Game *game);
+bool vocab_game_submit(Vocab_Game *game, const Vocab_Word_Set *set);
+// Goes to the unrolled scoring for `length`
+void vocab_score_length(size_t length, const char *answer, const char *guess, Vocab_Color *colors);
+
+#endif // VOCAB_LENGTHS_H_
+
+#ifdef VOCAB_LENGTHS_IMPLEMENTATION
+
+#define VOCAB_LENGTH_TEMPLATE_IMPLEMENTATION
+#define VOCAB_LENGTH 4
+#include "./vocab_length_template.h"
+#undef VOCAB_LENGTH
+#define VOCAB_LENGTH 6
+#include "./vocab_length_template.h"
+#undef VOCAB_LENGTH
+#define VOCAB_LENGTH 7
+#include "./vocab_length_template.h"
+#undef VOCAB_LENGTH
+#undef VOCAB_LENGTH_TEMPLATE_IMPLEMENTATION
+
+bool vocab_length_supported(size_t length) {
+    switch (length) {
+#define X(n) case n: return true;
+        VOCAB_LENGTHS(X)
+#undef X
+    default: return false;
+    }
+}
+
+void vocab_game_init(Vocab_Game *game, size_t length, const char *answer) {
+    memset(game, 0, sizeof(*game));
+    game->length = length;
+    switch (length) {
+#define X(n) case n: vocab##n##_init(&game->as.v##n, answer); break;
+        VOCAB_LENGTHS(X)
+#undef X
+    default: assert(0 && "Error: unsupported word length");
+    }
+}
+
+size_t vocab_game_attempts_count(const Vocab_Game *game) {
+    switch (game->length) {
+#define X(n) case n: return ARRAY_LEN(game->as.v##n.grid);
+        VOCAB_LENGTHS(X)
+#undef X
+    default: return 0;
+    }
+}
+
+size_t vocab_game_current_attempt(const Vocab_Game *game) {
+    switch (game->length) {
+#define X(n) case n: return game->as.v##n.current_attempt;
+        VOCAB_LENGTHS(X)
+#undef X
+    default: return 0;
+    }
+}
+
+size_t vocab_game_cursor(const Vocab_Game *game) {
+    switch (game->length) {
+#define X(n) case n: return game->as.v##n.cursor;
+        VOCAB_LENGTHS(X)
+#undef X
+    default: return 0;
+    }
+}
+
+const char *vocab_game_answer(const Vocab_Game *game) {
+    switch (game->length) {
+#define X(n) case n: return game->as.v##n.word;
+        VOCAB_LENGTHS(X)
+#undef X
+    default: return NULL;
+    }
+}
+
+char vocab_game_letter(const Vocab_Game *game, size_t row, size_t col) {
+    switch (game->length) {
+#define X(n) case n: return game->as.v##n.grid[row][col];
+        VOCAB_LENGTHS(X)
+#undef X
+    default: return '\0';
+    }
+}
+
+Vocab_Color vocab_game_color(const Vocab_Game *game, size_t row, size_t col) {
+    switch (game->length) {
+#define X(n) case n: return game->as.v##n.color_grid[row][col];
+        VOCAB_LENGTHS(X)
+#undef X
+    default: return VOCAB_BLACK;
+    }
+}
+
+bool vocab_game_is_over(const Vocab_Game *game) {
+    switch (game->length) {
+#define X(n) case n: return vocab##n##_is_over(&game->as.v##n);
+        VOCAB_LENGTHS(X)
+#undef X
+    default: return true;
+    }
+}
+
+void vocab_game_type_letter(Vocab_Game *game, char letter) {
+    switch (game->length) {
+#define X(n) case n: vocab##n##_type_letter(&game->as.v##n, letter); break;
+        VOCAB_LENGTHS(X)
+#undef X
+    default: break;
+    }
+}
+
+void vocab_game_erase_letter(Vocab_Game *game) {
+    switch (game->length) {
+#define X(n) case n: vocab##n##_erase_letter(&game->as.v##n); break;
+        VOCAB_LENGTHS(X)
+#undef X
+    default: break;
+    }
+}
+
+bool vocab_game_submit(Vocab_Game *game, const Vocab_Word_Set *set) {
+    switch (game->length) {
+#define X(n) case n: return vocab##n##_submit(&game->as.v##n, set);
+        VOCAB_LENGTHS(X)
+#undef X
+    default: return false;
+    }
+}
+
+void vocab_score_length(size_t length, const char *answer, const char *guess, Vocab_Color *colors) {
+    switch (length) {
+#define X(n) case n: vocab##n##_score(answer, guess, colors); break;
+        VOCAB_LENGTHS(X)
+#undef X
+    default: assert(0 && "Error: unsupported word length");
+    }
+}
+
+#endif // VOCAB_LENGTHS_IMPLEMENTATION